@@ -2484,7 +2484,7 @@ Amr::defBaseLevel (Real              strt_time,
     }
 
     this->SetBoxArray(0, lev0);
-    this->SetDistributionMap(0, DistributionMapping(lev0));
+    this->SetDistributionMap(0, MakeDistributionMap(lev0));
 
     //
     // Now build level 0 grids.
@@ -2576,7 +2576,7 @@ Amr::regrid (int  lbase,
             new_dmap[lev] = makeLoadBalanceDistributionMap(lev, time, new_grid_places[lev]);
         }
         else if (new_dmap[lev].empty()) {
-	    new_dmap[lev].define(new_grid_places[lev]);
+	    new_dmap[lev] = MakeDistributionMap(new_grid_places[lev]);
 	}
 
         AmrLevel* a = (*levelbld)(*this,lev,Geom(lev),new_grid_places[lev],
@@ -2689,7 +2689,7 @@ Amr::makeLoadBalanceDistributionMap (int lev, Real time, const BoxArray& ba) con
         if (verbose) {
             amrex::Print() << "\nAMREX WARNING: work estimates type does not exist!\n\n";
         }
-        newdm.define(ba);
+        newdm = MakeDistributionMap(ba);
     }
     else if (amr_level[lev])
     {
@@ -2710,7 +2710,7 @@ Amr::makeLoadBalanceDistributionMap (int lev, Real time, const BoxArray& ba) con
     }
     else
     {
-        newdm.define(ba);
+        newdm = MakeDistributionMap(ba);
     }
 
     return newdm;
@@ -2765,7 +2765,7 @@ Amr::regrid_level_0_on_restart()
 	//
 	// Construct skeleton of new level.
 	//
-	DistributionMapping dm(lev0);
+	DistributionMapping dm = MakeDistributionMap(lev0);
 	AmrLevel* a = (*levelbld)(*this,0,Geom(0),lev0,dm,cumtime);
 	
 	a->init(*amr_level[0]);
@@ -2977,7 +2977,7 @@ Amr::bldFineLevels (Real strt_time)
         //
         finest_level = new_finest;
 
-	DistributionMapping new_dm {new_grids[new_finest]};
+	DistributionMapping new_dm = MakeDistributionMap(new_grids[new_finest]);
 
         AmrLevel* level = (*levelbld)(*this,
                                       new_finest,
@@ -2189,6 +2189,68 @@ AmrLevel::FillPatch (AmrLevel& amrlevel,
     MultiFab::Copy(leveldata, mf_fillpatched, 0, dcomp, ncomp, boxGrow);
 }
 
+void
+AmrLevel::FillPatchRegrid (AmrLevel& old,
+                           MultiFab& leveldata,
+                           Real      time,
+                           int       index,
+                           int       scomp,
+                           int       ncomp,
+                           int       dcomp)
+{
+    BL_PROFILE("AmrLevel::FillPatchRegrid()");
+
+    BL_ASSERT(dcomp+ncomp-1 <= leveldata.nComp());
+
+    const int level = old.level;
+    const StateDescriptor& desc = AmrLevel::desc_lst[index];
+
+    StateData& statedata_fine = old.state[index];
+    Vector<MultiFab*> smf_fine;
+    Vector<Real> stime_fine;
+    statedata_fine.getData(smf_fine,stime_fine,time);
+
+    bool nested = true;
+    if (level > 1) {
+        for (const auto& r : desc.sameInterps(scomp,ncomp)) {
+            nested = nested && amrex::ProperlyNested(old.crse_ratio,
+                                                     old.parent->blockingFactor(level),
+                                                     0, leveldata.ixType(), desc.interp(r.first));
+        }
+    }
+
+    if (level == 0 || smf_fine.size() != 1 || !nested)
+    {
+        FillPatch(old, leveldata, 0, time, index, scomp, ncomp, dcomp);
+        return;
+    }
+
+    AmrLevel& crse_level = old.parent->getLevel(level-1);
+    StateData& statedata_crse = crse_level.state[index];
+    Vector<MultiFab*> smf_crse;
+    Vector<Real> stime_crse;
+    statedata_crse.getData(smf_crse,stime_crse,time);
+
+    for (const auto& r : desc.sameInterps(scomp,ncomp))
+    {
+        const int SComp = r.first;
+        const int NComp = r.second;
+
+        StateDataPhysBCFunct physbcf_crse(statedata_crse,SComp,crse_level.geom);
+        StateDataPhysBCFunct physbcf_fine(statedata_fine,SComp,old.geom);
+
+        amrex::FillPatchRegrid(leveldata, *smf_fine[0], time,
+                               smf_crse, stime_crse,
+                               SComp, dcomp+SComp-scomp, NComp,
+                               crse_level.geom, old.geom,
+                               physbcf_crse, SComp,
+                               physbcf_fine, SComp,
+                               crse_level.fineRatio(),
+                               desc.interp(SComp),
+                               desc.getBCs(), SComp);
+    }
+}
+
 void
 AmrLevel::FillPatchAdd (AmrLevel& amrlevel,
                         MultiFab& leveldata,
@@ -356,6 +356,8 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
 
     pp.query("check_input", check_input);
 
+    pp.query("use_octree", use_octree);
+
     finest_level = -1;
 
     if (check_input) checkInput();
@@ -381,6 +383,9 @@ void
 AmrMesh::SetBoxArray (int lev, const BoxArray& ba_in) noexcept
 {
     if (grids[lev] != ba_in) grids[lev] = ba_in;
+    if (use_octree && !grids[lev].empty()) {
+        Octree::setNeighbors(geom[lev], grids[lev], max_grid_size[lev]);
+    }
 }
 
 void
@@ -436,9 +441,39 @@ AmrMesh::ChopGrids (int lev, BoxArray& ba, int target_size) const
     }
 }
 
+Octree
+AmrMesh::MakeOctree () const
+{
+    AMREX_ALWAYS_ASSERT(use_octree);
+    return Octree(geom, grids, finest_level+1, max_grid_size[0]);
+}
+
+DistributionMapping
+AmrMesh::MakeDistributionMap (const BoxArray& ba) const
+{
+    if (use_octree) {
+        return Octree::makeDistributionMap(ba.size());
+    } else {
+        return DistributionMapping(ba);
+    }
+}
+
 BoxArray
 AmrMesh::MakeBaseGrids () const
 {
+    if (use_octree)
+    {
+        const IntVect& block_size = max_grid_size[0];
+        const Box& block_domain = amrex::coarsen(geom[0].Domain(), block_size);
+        BoxArray ba = Octree::makeBoxArray(Octree::domainBlocks(block_domain), block_size);
+        if (ba == grids[0]) {
+            ba = grids[0];  // to avoid duplicates
+        }
+        PostProcessBaseGrids(ba);
+        Octree::setNeighbors(geom[0], ba, block_size);
+        return ba;
+    }
+
     IntVect fac(2);
     const Box& dom = geom[0].Domain();
     const Box dom2 = amrex::refine(amrex::coarsen(dom,2),2);
@@ -470,6 +505,11 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
 
     BL_ASSERT(lbase < max_level);
 
+    if (use_octree) {
+        MakeNewGridsOctree(lbase, time, new_finest, new_grids);
+        return;
+    }
+
     // Add at most one new level
     int max_crse = std::min(finest_level, max_level-1);
 
@@ -781,6 +821,62 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
     }
 }
 
+void
+AmrMesh::MakeNewGridsOctree (int lbase, Real time, int& new_finest, Vector<BoxArray>& new_grids)
+{
+    BL_PROFILE("AmrMesh::MakeNewGridsOctree()");
+
+    const int max_crse = std::min(finest_level, max_level-1);
+
+    if (new_grids.size() < max_crse+2) new_grids.resize(max_crse+2);
+
+    const IntVect& block_size = max_grid_size[0];
+    // ManualTagsPlacement sees the tags before they are coarsened.
+    const Vector<IntVect> bf_lev(max_level, IntVect::TheUnitVector());
+
+    //
+    // Flag the blocks containing tagged or buffer cells.  Coarsening the
+    // tags by the block size gives one tag per block.
+    //
+    Vector<Vector<IntVect> > flags(max_crse+1);
+    for (int levc = lbase; levc <= max_crse; ++levc)
+    {
+        TagBoxArray tags(grids[levc],dmap[levc],n_error_buf[levc]);
+        ErrorEst(levc, tags, time, 0);
+        tags.buffer(n_error_buf[levc]);
+        ManualTagsPlacement(levc, tags, bf_lev);
+        tags.coarsen(block_size);
+        tags.collate(flags[levc]);
+    }
+
+    //
+    // Refine the flagged blocks on the I/O processor and broadcast the new blocks.
+    //
+    Vector<Vector<IntVect> > new_blocks;
+    if (ParallelDescriptor::IOProcessor()) {
+        new_blocks = MakeOctree().refine(lbase, max_crse, flags);
+    }
+    new_blocks.resize(max_crse+2);
+
+    new_finest = lbase;
+    for (int lev = lbase+1; lev <= max_crse+1; ++lev)
+    {
+        Long n = new_blocks[lev].size();
+        ParallelDescriptor::Bcast(&n, 1, ParallelDescriptor::IOProcessorNumber());
+        if (n == 0) break;
+        new_blocks[lev].resize(n);
+        ParallelDescriptor::Bcast(reinterpret_cast<int*>(new_blocks[lev].data()),
+                                  n*AMREX_SPACEDIM, ParallelDescriptor::IOProcessorNumber());
+
+        new_grids[lev] = Octree::makeBoxArray(new_blocks[lev], block_size);
+        if (lev <= finest_level && new_grids[lev] == grids[lev]) {
+            new_grids[lev] = grids[lev]; // to avoid dupliates
+        }
+        Octree::setNeighbors(geom[lev], new_grids[lev], block_size);
+        new_finest = lev;
+    }
+}
+
 void
 AmrMesh::MakeNewGrids (Real time)
 {
@@ -789,7 +885,7 @@ AmrMesh::MakeNewGrids (Real time)
 	finest_level = 0;
 
 	const BoxArray& ba = MakeBaseGrids();
-	DistributionMapping dm(ba);
+	DistributionMapping dm = MakeDistributionMap(ba);
         const auto old_num_setdm = num_setdm;
 
 	MakeNewLevelFromScratch(0, time, ba, dm);
@@ -814,7 +910,7 @@ AmrMesh::MakeNewGrids (Real time)
 	    if (new_finest <= finest_level) break;
 	    finest_level = new_finest;
 
-	    DistributionMapping dm(new_grids[new_finest]);
+	    DistributionMapping dm = MakeDistributionMap(new_grids[new_finest]);
             const auto old_num_setdm = num_setdm;
 
             MakeNewLevelFromScratch(new_finest, time, new_grids[finest_level], dm);
@@ -845,7 +941,7 @@ AmrMesh::MakeNewGrids (Real time)
 	        for (int lev = 1; lev <= new_finest; ++lev) {
 		    if (new_grids[lev] != grids[lev]) {
 		        grids_the_same = false;
-		        DistributionMapping dm(new_grids[lev]);
+		        DistributionMapping dm = MakeDistributionMap(new_grids[lev]);
                         const auto old_num_setdm = num_setdm;
 
                         MakeNewLevelFromScratch(lev, time, new_grids[lev], dm);
@@ -999,6 +1095,37 @@ AmrMesh::checkInput ()
         }
     }
 
+    //
+    // The octree mode refines blocks of max_grid_size cells by a factor of 2.
+    //
+    if (use_octree)
+    {
+        for (int i = 0; i < max_level; i++) {
+            if (ref_ratio[i] != 2) {
+                amrex::Error("Amr::checkInput: octree mode requires ref_ratio of 2");
+            }
+        }
+        for (int i = 0; i <= max_level; i++) {
+            if (max_grid_size[i] != max_grid_size[0]) {
+                amrex::Error("Amr::checkInput: octree mode requires the same max_grid_size at all levels");
+            }
+        }
+        for (int idim = 0; idim < AMREX_SPACEDIM; idim++)
+        {
+            if (max_grid_size[0][idim]%2 != 0) {
+                amrex::Error("Amr::checkInput: octree mode requires an even max_grid_size");
+            }
+            if (domain.length(idim)%max_grid_size[0][idim] != 0) {
+                amrex::Print() << "domain size in direction " << idim << " is " << domain.length(idim) << std::endl;
+                amrex::Print() << "max_grid_size is " << max_grid_size[0][idim] << std::endl;
+                amrex::Error("domain size not divisible by max_grid_size in octree mode");
+            }
+        }
+        if (use_fixed_coarse_grids) {
+            amrex::Error("Amr::checkInput: octree mode does not support fixed coarse grids");
+        }
+    }
+
     if( ! (Geom(0).ProbDomain().volume() > 0.0) ) {
         amrex::Error("Amr::checkInput: bad physical problem size");
     }
@@ -1038,6 +1165,7 @@ std::ostream& operator<< (std::ostream& os, AmrMesh const& amr_mesh)
     os << "  check_input = " << amr_mesh.check_input  << "\n";
     os << "  use_new_chop = " << amr_mesh.use_new_chop << "\n";
     os << "  iterate_on_new_grids = " << amr_mesh.iterate_on_new_grids << "\n";
+    os << "  use_octree = " << amr_mesh.use_octree << "\n";
     return os;
 }
 
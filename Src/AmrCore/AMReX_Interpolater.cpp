@@ -6,23 +6,21 @@
 #include <AMReX_Interpolater.H>
 #include <AMReX_Interp_C.H>
 
-#ifndef BL_NO_FORT
-#include <AMReX_INTERP_F.H>
-#endif
-
 namespace amrex {
 
 //
-// PCInterp, NodeBilinear, FaceLinear, and CellConservativeLinear are supported for all dimensions
-// on cpu and gpu.
+// PCInterp, NodeBilinear, FaceLinear, CellConservativeLinear, CellBilinear,
+// CellConservativeProtected and CellConservativeQuartic are supported for all
+// dimensions on cpu and gpu.
 //
-// CellConsertiveProtected only works in 2D and 3D on cpu.
+// CellConservativeProtected::protect only works in 2D and 3D.
 //
-// CellBilinear works in 1D, 2D and 3D on cpu.
+// CellQuadratic only works in 2D.
 //
-// CellQuadratic only works in 2D on cpu.
+// CellConservativeQuartic only works with ref ratio of 2 or 4.
 //
-// CellConservativeQuartic only works with ref ratio of 2 on cpu
+// The kernels of CellBilinear, CellQuadratic, CellConservativeProtected and
+// CellConservativeQuartic are specialized for ref ratios of 2 and 4.
 //
 
 //
@@ -34,12 +32,10 @@ FaceLinear                face_linear_interp;
 CellConservativeLinear    lincc_interp;
 CellConservativeLinear    cell_cons_interp(0);
 
-#ifndef BL_NO_FORT
 CellBilinear              cell_bilinear_interp;
 CellQuadratic             quadratic_interp;
 CellConservativeProtected protected_interp;
 CellConservativeQuartic   quartic_interp;
-#endif
 
 Interpolater::~Interpolater () {}
 
@@ -213,7 +209,6 @@ FaceLinear::interp (const FArrayBox&  crse,
 
 FaceLinear::~FaceLinear () {}
 
-#ifndef BL_NO_FORT
 CellBilinear::~CellBilinear () {}
 
 Box
@@ -257,44 +252,32 @@ CellBilinear::interp (const FArrayBox&  crse,
                       const Geometry& /*crse_geom*/,
                       const Geometry& /*fine_geom*/,
                       Vector<BCRec> const& /*bcr*/,
-                      int               actual_comp,
-                      int               actual_state,
-                      RunOn             /*runon*/)
+                      int               /*actual_comp*/,
+                      int               /*actual_state*/,
+                      RunOn             runon)
 {
     BL_PROFILE("CellBilinear::interp()");
-    //
-    // Set up to call FORTRAN.
-    //
-    const int* clo = crse.box().loVect();
-    const int* chi = crse.box().hiVect();
-    const int* flo = fine.loVect();
-    const int* fhi = fine.hiVect();
-    const int* lo  = fine_region.loVect();
-    const int* hi  = fine_region.hiVect();
-    int num_slope  = AMREX_D_TERM(2,*2,*2)-1;
-    int len0       = crse.box().length(0);
-    int slp_len    = num_slope*len0;
 
-    Vector<Real> slope(slp_len);
-
-    int strp_len = len0*ratio[0];
-
-    Vector<Real> strip(strp_len);
-
-    int strip_lo = ratio[0] * clo[0];
-    int strip_hi = ratio[0] * chi[0];
-
-    const Real* cdat  = crse.dataPtr(crse_comp);
-    Real*       fdat  = fine.dataPtr(fine_comp);
-    const int* ratioV = ratio.getVect();
+    Array4<Real const> const& crsearr = crse.const_array();
+    Array4<Real> const& finearr = fine.array();
 
-    amrex_cbinterp (cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),AMREX_ARLIM(clo),AMREX_ARLIM(chi),
-                   fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),AMREX_ARLIM(lo),AMREX_ARLIM(hi),
-                   AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),&ncomp,
-                   slope.dataPtr(),&num_slope,strip.dataPtr(),&strip_lo,&strip_hi,
-                   &actual_comp,&actual_state);
+    if (ratio == 2) {
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, fine_region, tbx,
+        {
+            amrex::cellbilin_interp<2>(tbx, finearr, fine_comp, ncomp, crsearr, crse_comp, ratio);
+        });
+    } else if (ratio == 4) {
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, fine_region, tbx,
+        {
+            amrex::cellbilin_interp<4>(tbx, finearr, fine_comp, ncomp, crsearr, crse_comp, ratio);
+        });
+    } else {
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, fine_region, tbx,
+        {
+            amrex::cellbilin_interp<0>(tbx, finearr, fine_comp, ncomp, crsearr, crse_comp, ratio);
+        });
+    }
 }
-#endif
 
 Vector<int>
 Interpolater::GetBCArray (const Vector<BCRec>& bcr)
@@ -432,7 +415,6 @@ CellConservativeLinear::interp (const FArrayBox& crse,
     }
 }
 
-#ifndef BL_NO_FORT
 CellQuadratic::CellQuadratic (bool limit)
 {
     do_limited_slope = limit;
@@ -469,100 +451,72 @@ CellQuadratic::interp (const FArrayBox& crse,
                        const Geometry&  crse_geom,
                        const Geometry&  fine_geom,
                        Vector<BCRec> const&  bcr,
-                       int              actual_comp,
-                       int              actual_state,
-                       RunOn            /*runon*/)
+                       int              /*actual_comp*/,
+                       int              /*actual_state*/,
+                       RunOn            runon)
 {
-#if (AMREX_SPACEDIM == 1)
+#if (AMREX_SPACEDIM != 2)
     amrex::ignore_unused(crse,crse_comp,fine,fine_comp,ncomp,fine_region,
-                         ratio,crse_geom,fine_geom,bcr,actual_comp,actual_state);
-    amrex::Abort("1D CellQuadratic::interp not supported");
+                         ratio,crse_geom,fine_geom,bcr,runon);
+    amrex::Abort("CellQuadratic::interp only supported in 2D");
 #else
     BL_PROFILE("CellQuadratic::interp()");
     BL_ASSERT(bcr.size() >= ncomp);
+
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
+
     //
     // Make box which is intersection of fine_region and domain of fine.
     //
     Box target_fine_region = fine_region & fine.box();
 
     Box crse_bx(amrex::coarsen(target_fine_region,ratio));
-    Box fslope_bx(amrex::refine(crse_bx,ratio));
-    Box cslope_bx(crse_bx);
-    cslope_bx.grow(1);
-    BL_ASSERT(crse.box().contains(cslope_bx));
-    //
-    // Alloc temp space for coarse grid slopes: here we use 5
-    // instead of AMREX_SPACEDIM because of the x^2, y^2 and xy terms
-    //
-    long t_long = cslope_bx.numPts();
-    BL_ASSERT(t_long < INT_MAX);
-    int c_len = int(t_long);
+    BL_ASSERT(crse.box().contains(amrex::grow(crse_bx,1)));
 
-    Vector<Real> cslope(5*c_len);
+    Array4<Real const> const& crsearr = crse.const_array();
+    Array4<Real> const& finearr = fine.array();
 
-    int loslp = cslope_bx.index(crse_bx.smallEnd());
-    int hislp = cslope_bx.index(crse_bx.bigEnd());
+    AsyncArray<BCRec> async_bcr(bcr.data(), (run_on_gpu) ? ncomp : 0);
+    BCRec const* bcrp = (run_on_gpu) ? async_bcr.data() : bcr.data();
 
-    t_long = cslope_bx.numPts();
-    BL_ASSERT(t_long < INT_MAX);
-    int cslope_vol = int(t_long);
-    int clo        = 1 - loslp;
-    int chi        = clo + cslope_vol - 1;
-    c_len          = hislp - loslp + 1;
-    //
-    // Alloc temp space for one strip of fine grid slopes: here we use 5
-    // instead of AMREX_SPACEDIM because of the x^2, y^2 and xy terms.
-    //
-    int dir;
-    int f_len = fslope_bx.longside(dir);
+    // The x, y, xx, yy and xy slopes of all the components
+    FArrayBox cslopefab(crse_bx, 5*ncomp);
+    Elixir cslopeeli;
+    if (run_on_gpu) cslopeeli = cslopefab.elixir();
+    Array4<Real> const& cslopearr = cslopefab.array();
 
-    Vector<Real> strip((5+2)*f_len);
+    // Offsets of the fine cell centers from the coarse cell centers
+    const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(crse_bx, ratio, crse_geom, fine_geom);
 
-    Real* fstrip = strip.dataPtr();
-    Real* foff   = fstrip + f_len;
-    Real* fslope = foff + f_len;
-    //
-    // Get coarse and fine edge-centered volume coordinates.
-    //
-    Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
-    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
+    AsyncArray<Real> async_voff(vec_voff.data(), (run_on_gpu) ? vec_voff.size() : 0);
+    Real const* voff = (run_on_gpu) ? async_voff.data() : vec_voff.data();
+
+    AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, crse_bx, tbx,
     {
-        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+        amrex::cellquad_slopes(tbx, cslopearr, crsearr, crse_comp, ncomp, bcrp);
+    });
+
+    if (ratio == 2) {
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, target_fine_region, tbx,
+        {
+            amrex::cellquad_interp<2>(tbx, finearr, fine_comp, ncomp, cslopearr, crsearr, crse_comp,
+                                      voff, ratio);
+        });
+    } else if (ratio == 4) {
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, target_fine_region, tbx,
+        {
+            amrex::cellquad_interp<4>(tbx, finearr, fine_comp, ncomp, cslopearr, crsearr, crse_comp,
+                                      voff, ratio);
+        });
+    } else {
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, target_fine_region, tbx,
+        {
+            amrex::cellquad_interp<0>(tbx, finearr, fine_comp, ncomp, cslopearr, crsearr, crse_comp,
+                                      voff, ratio);
+        });
     }
-    //
-    // Alloc tmp space for slope calc and to allow for vectorization.
-    //
-    Real* fdat        = fine.dataPtr(fine_comp);
-    const Real* cdat  = crse.dataPtr(crse_comp);
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* cblo   = crse_bx.loVect();
-    const int* cbhi   = crse_bx.hiVect();
-    const int* fslo   = fslope_bx.loVect();
-    const int* fshi   = fslope_bx.hiVect();
-    int slope_flag    = (do_limited_slope ? 1 : 0);
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
-
-    amrex_cqinterp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-                   AMREX_ARLIM(fblo), AMREX_ARLIM(fbhi),
-                   &ncomp,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-                   cdat,&clo,&chi,
-                   AMREX_ARLIM(cblo), AMREX_ARLIM(cbhi),
-                   fslo,fshi,
-                   cslope.dataPtr(),&c_len,fslope,fstrip,&f_len,foff,
-                   bc.dataPtr(), &slope_flag,
-                   AMREX_D_DECL(fvc[0].dataPtr(),fvc[1].dataPtr(),fvc[2].dataPtr()),
-                   AMREX_D_DECL(cvc[0].dataPtr(),cvc[1].dataPtr(),cvc[2].dataPtr()),
-                   &actual_comp,&actual_state);
-
-#endif /*(AMREX_SPACEDIM > 1)*/
-}
 #endif
+}
 
 
 PCInterp::~PCInterp () {}
@@ -607,7 +561,6 @@ PCInterp::interp (const FArrayBox& crse,
     });
 }
 
-#ifndef BL_NO_FORT
 CellConservativeProtected::CellConservativeProtected () {}
 
 CellConservativeProtected::~CellConservativeProtected () {}
@@ -693,8 +646,8 @@ CellConservativeProtected::interp (const FArrayBox& crse,
 }
 
 void
-CellConservativeProtected::protect (const FArrayBox& crse,
-                                    int              crse_comp,
+CellConservativeProtected::protect (const FArrayBox& /*crse*/,
+                                    int              /*crse_comp*/,
                                     FArrayBox&       fine,
                                     int              fine_comp,
                                     FArrayBox&       fine_state,
@@ -705,16 +658,17 @@ CellConservativeProtected::protect (const FArrayBox& crse,
                                     const Geometry&  crse_geom,
                                     const Geometry&  fine_geom,
                                     Vector<BCRec>&   bcr,
-                                    RunOn            /*runon*/)
+                                    RunOn            runon)
 {
 #if (AMREX_SPACEDIM == 1)
-    amrex::ignore_unused(crse,crse_comp,fine,fine_comp,fine_state,
+    amrex::ignore_unused(fine,fine_comp,fine_state,
                          state_comp,ncomp,fine_region,ratio,
-                         crse_geom,fine_geom,bcr);
+                         crse_geom,fine_geom,bcr,runon);
     amrex::Abort("1D CellConservativeProtected::protect not supported");
 #else
     BL_PROFILE("CellConservativeProtected::protect()");
     BL_ASSERT(bcr.size() >= ncomp);
+    amrex::ignore_unused(bcr);
 
     //
     // Make box which is intersection of fine_region and domain of fine.
@@ -732,70 +686,76 @@ CellConservativeProtected::protect (const FArrayBox& crse,
     Box cs_bx(crse_bx);
     cs_bx.grow(-1);
 
+    Array4<Real> const& finearr = fine.array(fine_comp);
+    Array4<Real const> const& statearr = fine_state.const_array(state_comp);
+
+#if (AMREX_SPACEDIM == 2)
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
+
     //
-    // Get coarse and fine edge-centered volume coordinates.
+    // Get coarse and fine edge-centered volume coordinates, x followed by y.
     //
-    int dir;
-    Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
-    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
+    Vector<Real> vec_fvc, vec_cvc;
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++)
     {
-        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+        Vector<Real> fvc, cvc;
+        fine_geom.GetEdgeVolCoord(fvc,target_fine_region,dir);
+        crse_geom.GetEdgeVolCoord(cvc,crse_bx,dir);
+        vec_fvc.insert(vec_fvc.end(), fvc.begin(), fvc.end());
+        vec_cvc.insert(vec_cvc.end(), cvc.begin(), cvc.end());
     }
 
-#if (AMREX_SPACEDIM == 2)
-    const int* cvcblo = crse_bx.loVect();
-    const int* fvcblo = target_fine_region.loVect();
-
-    int cvcbhi[AMREX_SPACEDIM];
-    int fvcbhi[AMREX_SPACEDIM];
+    AsyncArray<Real> async_fvc(vec_fvc.data(), (run_on_gpu) ? vec_fvc.size() : 0);
+    AsyncArray<Real> async_cvc(vec_cvc.data(), (run_on_gpu) ? vec_cvc.size() : 0);
+    Real const* fvc = (run_on_gpu) ? async_fvc.data() : vec_fvc.data();
+    Real const* cvc = (run_on_gpu) ? async_cvc.data() : vec_cvc.data();
 
-    for (dir=0; dir<AMREX_SPACEDIM; dir++)
-    {
-        cvcbhi[dir] = cvcblo[dir] + cvc[dir].size() - 1;
-        fvcbhi[dir] = fvcblo[dir] + fvc[dir].size() - 1;
+    if (ratio == 2) {
+        AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG (runon, cs_bx, ic, jc, kc,
+        {
+            amrex::ignore_unused(kc);
+            amrex::ccprotect<2>(ic, jc, ncomp, target_fine_region, finearr, statearr,
+                                fvc, crse_bx, cvc, ratio);
+        });
+    } else if (ratio == 4) {
+        AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG (runon, cs_bx, ic, jc, kc,
+        {
+            amrex::ignore_unused(kc);
+            amrex::ccprotect<4>(ic, jc, ncomp, target_fine_region, finearr, statearr,
+                                fvc, crse_bx, cvc, ratio);
+        });
+    } else {
+        AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG (runon, cs_bx, ic, jc, kc,
+        {
+            amrex::ignore_unused(kc);
+            amrex::ccprotect<0>(ic, jc, ncomp, target_fine_region, finearr, statearr,
+                                fvc, crse_bx, cvc, ratio);
+        });
     }
-#endif
+#else
+    amrex::ignore_unused(crse_geom,fine_geom);
 
-    Real* fdat       = fine.dataPtr(fine_comp);
-    Real* state_dat  = fine_state.dataPtr(state_comp);
-    const Real* cdat = crse.dataPtr(crse_comp);
-
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* slo    = fine_state.loVect();
-    const int* shi    = fine_state.hiVect();
-    const int* clo    = crse.loVect();
-    const int* chi    = crse.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* csbhi  = cs_bx.hiVect();
-    const int* csblo  = cs_bx.loVect();
-
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
-
-    amrex_protect_interp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-                         fblo, fbhi,
-                         cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),
-                         csblo, csbhi,
-#if (AMREX_SPACEDIM == 2)
-                         fvc[0].dataPtr(),fvc[1].dataPtr(),
-                         AMREX_ARLIM(fvcblo), AMREX_ARLIM(fvcbhi),
-                         cvc[0].dataPtr(),cvc[1].dataPtr(),
-                         AMREX_ARLIM(cvcblo), AMREX_ARLIM(cvcbhi),
+    if (ratio == 2) {
+        AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG (runon, cs_bx, ic, jc, kc,
+        {
+            amrex::ccprotect<2>(ic, jc, kc, ncomp, target_fine_region, finearr, statearr, ratio);
+        });
+    } else if (ratio == 4) {
+        AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG (runon, cs_bx, ic, jc, kc,
+        {
+            amrex::ccprotect<4>(ic, jc, kc, ncomp, target_fine_region, finearr, statearr, ratio);
+        });
+    } else {
+        AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG (runon, cs_bx, ic, jc, kc,
+        {
+            amrex::ccprotect<0>(ic, jc, kc, ncomp, target_fine_region, finearr, statearr, ratio);
+        });
+    }
 #endif
-                         state_dat, AMREX_ARLIM(slo), AMREX_ARLIM(shi),
-                         &ncomp,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-                         bc.dataPtr());
 
 #endif /*(AMREX_SPACEDIM == 1)*/
-
 }
-#endif
 
-#ifndef BL_NO_FORT
 CellConservativeQuartic::~CellConservativeQuartic () {}
 
 Box
@@ -827,74 +787,127 @@ CellConservativeQuartic::interp (const FArrayBox&  crse,
 				 const Geometry&   /* crse_geom */,
 				 const Geometry&   /* fine_geom */,
 				 Vector<BCRec> const&   bcr,
-				 int               actual_comp,
-				 int               actual_state,
-                                 RunOn             /*runon*/)
+				 int               /*actual_comp*/,
+				 int               /*actual_state*/,
+                                 RunOn             runon)
 {
     BL_PROFILE("CellConservativeQuartic::interp()");
     BL_ASSERT(bcr.size() >= ncomp);
-    BL_ASSERT(ratio[0]==2);
-#if (AMREX_SPACEDIM >= 2)
-    BL_ASSERT(ratio[0] == ratio[1]);
-#endif
-#if (AMREX_SPACEDIM == 3)
-    BL_ASSERT(ratio[1] == ratio[2]);
-#endif
+    amrex::ignore_unused(bcr);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ratio == 2 || ratio == 4,
+                                     "CellConservativeQuartic: refinement ratio must be 2 or 4");
+
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
 
     //
     // Make box which is intersection of fine_region and domain of fine.
     //
     Box target_fine_region = fine_region & fine.box();
-    //
-    // crse_bx is coarsening of target_fine_region, grown by 2.
-    //
-    Box crse_bx = CoarseBox(target_fine_region,ratio);
-
-    Box crse_bx2(crse_bx);
-    crse_bx2.grow(-2);
-    Box fine_bx2 = amrex::refine(crse_bx2,ratio);
+    if (target_fine_region.isEmpty()) return;
+    BL_ASSERT(crse.box().contains(CoarseBox(target_fine_region,ratio)));
 
-    Real* fdat       = fine.dataPtr(fine_comp);
-    const Real* cdat = crse.dataPtr(crse_comp);
-
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* clo    = crse.loVect();
-    const int* chi    = crse.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* cblo   = crse_bx.loVect();
-    const int* cbhi   = crse_bx.hiVect();
-    const int* cb2lo  = crse_bx2.loVect();
-    const int* cb2hi  = crse_bx2.hiVect();
-    const int* fb2lo  = fine_bx2.loVect();
-    const int* fb2hi  = fine_bx2.hiVect();
+    Array4<Real const> const& crsearr = crse.const_array();
+    Array4<Real> const& finearr = fine.array();
 
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
+#if (AMREX_SPACEDIM == 1)
+    amrex::ignore_unused(run_on_gpu);
+    if (ratio == 2) {
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, target_fine_region, tbx,
+        {
+            amrex::quartinterp_x<2>(tbx, finearr, fine_comp, crsearr, crse_comp, ncomp);
+        });
+    } else {
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, target_fine_region, tbx,
+        {
+            amrex::quartinterp_x<4>(tbx, finearr, fine_comp, crsearr, crse_comp, ncomp);
+        });
+    }
+#else
+    //
+    // The interpolation is done one direction at a time, from the last
+    // direction to x.  On the cpu, the region is done in slabs of the last
+    // direction so that the temporaries stay in cache.
+    //
+    constexpr int last = AMREX_SPACEDIM-1;
+    const int slab = run_on_gpu ? target_fine_region.length(last) : 8;
+    FArrayBox tmpfab[AMREX_SPACEDIM-1];
+    Elixir tmpeli[AMREX_SPACEDIM-1];
 
-    int ltmp = fb2hi[0]-fb2lo[0]+1;
-    Vector<Real> ftmp(ltmp);
+    for (int flo = target_fine_region.smallEnd(last); flo <= target_fine_region.bigEnd(last);
+         flo += slab)
+    {
+        Box fbx = target_fine_region;
+        fbx.setRange(last, flo, std::min(slab, target_fine_region.bigEnd(last)-flo+1));
+
+        //
+        // tmpbx[d] is refined in the directions above d.
+        //
+        Box tmpbx[AMREX_SPACEDIM];
+        tmpbx[last] = CoarseBox(fbx,ratio);
+        for (int dir = last; dir > 0; --dir) {
+            tmpbx[dir-1] = tmpbx[dir];
+            tmpbx[dir-1].setRange(dir, fbx.smallEnd(dir), fbx.length(dir));
+        }
+        for (int dir = 0; dir < last; ++dir) {
+            tmpfab[dir].resize(tmpbx[dir], ncomp);
+            if (run_on_gpu) tmpeli[dir] = tmpfab[dir].elixir();
+        }
 
-#if (AMREX_SPACEDIM >= 2)
-    ltmp = (cbhi[0]-cblo[0]+1)*ratio[1];
-    Vector<Real> ctmp(ltmp);
+        Array4<Real> const& yarr = tmpfab[0].array();
+        Array4<Real const> const& ycarr = tmpfab[0].const_array();
+#if (AMREX_SPACEDIM == 2)
+        if (ratio == 2) {
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, tmpbx[0], tbx,
+            {
+                amrex::quartinterp_y<2>(tbx, yarr, 0, crsearr, crse_comp, ncomp);
+            });
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, fbx, tbx,
+            {
+                amrex::quartinterp_x<2>(tbx, finearr, fine_comp, ycarr, 0, ncomp);
+            });
+        } else {
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, tmpbx[0], tbx,
+            {
+                amrex::quartinterp_y<4>(tbx, yarr, 0, crsearr, crse_comp, ncomp);
+            });
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, fbx, tbx,
+            {
+                amrex::quartinterp_x<4>(tbx, finearr, fine_comp, ycarr, 0, ncomp);
+            });
+        }
+#else
+        Array4<Real> const& zarr = tmpfab[1].array();
+        Array4<Real const> const& zcarr = tmpfab[1].const_array();
+        if (ratio == 2) {
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, tmpbx[1], tbx,
+            {
+                amrex::quartinterp_z<2>(tbx, zarr, 0, crsearr, crse_comp, ncomp);
+            });
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, tmpbx[0], tbx,
+            {
+                amrex::quartinterp_y<2>(tbx, yarr, 0, zcarr, 0, ncomp);
+            });
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, fbx, tbx,
+            {
+                amrex::quartinterp_x<2>(tbx, finearr, fine_comp, ycarr, 0, ncomp);
+            });
+        } else {
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, tmpbx[1], tbx,
+            {
+                amrex::quartinterp_z<4>(tbx, zarr, 0, crsearr, crse_comp, ncomp);
+            });
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, tmpbx[0], tbx,
+            {
+                amrex::quartinterp_y<4>(tbx, yarr, 0, zcarr, 0, ncomp);
+            });
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, fbx, tbx,
+            {
+                amrex::quartinterp_x<4>(tbx, finearr, fine_comp, ycarr, 0, ncomp);
+            });
+        }
 #endif
-
-#if (AMREX_SPACEDIM == 3)
-    ltmp = (cbhi[0]-cblo[0]+1)*(cbhi[1]-cblo[1]+1)*ratio[2];
-    Vector<Real> ctmp2(ltmp);
+    }
 #endif
-
-    amrex_quartinterp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-		      fblo, fbhi, fb2lo, fb2hi,
-		      cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),
-		      cblo, cbhi, cb2lo, cb2hi,
-		      &ncomp,
-		      AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-		      AMREX_D_DECL(ftmp.dataPtr(), ctmp.dataPtr(), ctmp2.dataPtr()),
-		      bc.dataPtr(),&actual_comp,&actual_state);
 }
-#endif
 
 }
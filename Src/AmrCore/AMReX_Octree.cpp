@@ -0,0 +1,314 @@
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+#include <AMReX.H>
+#include <AMReX_BLProfiler.H>
+#include <AMReX_BoxIterator.H>
+#include <AMReX_Octree.H>
+#include <AMReX_ParallelDescriptor.H>
+
+namespace amrex {
+
+namespace {
+    // Offsets to the 3^AMREX_SPACEDIM blocks around and including a block
+    Vector<IntVect> neighborOffsets ()
+    {
+        Vector<IntVect> offs;
+        for (int k = AMREX_D_PICK(0,0,-1); k <= AMREX_D_PICK(0,0,1); ++k) {
+        for (int j = AMREX_D_PICK(0,-1,-1); j <= AMREX_D_PICK(0,1,1); ++j) {
+        for (int i = -1; i <= 1; ++i) {
+            offs.push_back(IntVect(AMREX_D_DECL(i,j,k)));
+        }}}
+        return offs;
+    }
+
+    IntVect childOffset (int m) noexcept
+    {
+        return IntVect(AMREX_D_DECL(m & 1, (m >> 1) & 1, (m >> 2) & 1));
+    }
+
+    constexpr int nchildren = AMREX_D_TERM(2,*2,*2);
+}
+
+Octree::Octree (const Vector<Geometry>& geom, const Vector<BoxArray>& grids, int nlevs,
+                const IntVect& block_size)
+{
+    define(geom, grids, nlevs, block_size);
+}
+
+void
+Octree::define (const Vector<Geometry>& geom, const Vector<BoxArray>& grids, int nlevs,
+                const IntVect& block_size)
+{
+    BL_PROFILE("Octree::define()");
+
+    m_block_size = block_size;
+    m_is_periodic = geom[0].isPeriodic();
+
+    const int ngeom = geom.size();
+    m_domain.resize(ngeom);
+    for (int lev = 0; lev < ngeom; ++lev) {
+        const Box& dom = geom[lev].Domain();
+        m_domain[lev] = amrex::coarsen(dom, block_size);
+        if (amrex::refine(m_domain[lev], block_size) != dom) {
+            amrex::Abort("Octree: domain is not divisible by the block size");
+        }
+    }
+
+    m_level.clear();
+    m_level.resize(nlevs);
+    for (int lev = 0; lev < nlevs; ++lev)
+    {
+        const BoxArray& ba = grids[lev];
+        const int n = ba.size();
+        Level& L = m_level[lev];
+        L.coord.resize(n);
+        L.index.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            const Box& bx = ba[i];
+            const IntVect c = amrex::coarsen(bx.smallEnd(), block_size);
+            if (bx != blockBox(c) || !m_domain[lev].contains(c)) {
+                amrex::Abort("Octree: grids at level " + std::to_string(lev)
+                             + " are not blocks of the block size");
+            }
+            L.coord[i] = c;
+            L.index.emplace(key(lev,c), i);
+        }
+
+        L.parent.resize(n);
+        L.face.resize(n*2*AMREX_SPACEDIM);
+        for (int i = 0; i < n; ++i) {
+            const IntVect& c = L.coord[i];
+            L.parent[i] = (lev > 0) ? find(lev-1, amrex::coarsen(c,2)) : -1;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                L.face[i*2*AMREX_SPACEDIM+2*idim  ] = find(lev, c - IntVect::TheDimensionVector(idim));
+                L.face[i*2*AMREX_SPACEDIM+2*idim+1] = find(lev, c + IntVect::TheDimensionVector(idim));
+            }
+        }
+    }
+}
+
+bool
+Octree::wrap (int lev, IntVect& c) const noexcept
+{
+    const Box& dom = m_domain[lev];
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (c[idim] < dom.smallEnd(idim) || c[idim] > dom.bigEnd(idim)) {
+            if (m_is_periodic[idim]) {
+                const int len = dom.length(idim);
+                int r = (c[idim] - dom.smallEnd(idim)) % len;
+                if (r < 0) r += len;
+                c[idim] = dom.smallEnd(idim) + r;
+            } else {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int
+Octree::find (int lev, const IntVect& c) const noexcept
+{
+    if (lev < 0 || lev >= numLevels()) return -1;
+    IntVect cw = c;
+    if (!wrap(lev, cw)) return -1;
+    const auto& index = m_level[lev].index;
+    auto found = index.find(key(lev,cw));
+    return (found == index.end()) ? -1 : found->second;
+}
+
+int
+Octree::child (int lev, int i, int m) const noexcept
+{
+    return find(lev+1, 2*blockCoord(lev,i) + childOffset(m));
+}
+
+int
+Octree::coarseNeighbor (int lev, int i, const IntVect& off) const noexcept
+{
+    IntVect c = blockCoord(lev,i) + off;
+    if (lev == 0 || !wrap(lev, c)) return -1;
+    return find(lev-1, amrex::coarsen(c,2));
+}
+
+Vector<Vector<IntVect> >
+Octree::refine (int lbase, int max_crse, const Vector<Vector<IntVect> >& flags) const
+{
+    BL_PROFILE("Octree::refine()");
+
+    AMREX_ASSERT(lbase < numLevels() && max_crse < static_cast<int>(m_domain.size())-1);
+
+    const Vector<IntVect> offs = neighborOffsets();
+
+    // The blocks to refine at each level, as a set of keys and a list of coordinates
+    Vector<std::unordered_set<Long> > rset(max_crse+1);
+    Vector<Vector<IntVect> > rlist(max_crse+1);
+    auto add = [&] (int lev, IntVect c) {
+        if (wrap(lev, c) && rset[lev].insert(key(lev,c)).second) {
+            rlist[lev].push_back(c);
+        }
+    };
+
+    for (int lev = lbase; lev <= max_crse && lev < static_cast<int>(flags.size()); ++lev) {
+        for (const auto& c : flags[lev]) {
+            add(lev, c);
+        }
+    }
+
+    // Going down, the blocks at level lev-1 must be refined so that the
+    // blocks refined at level lev and all their neighbors exist.
+    for (int lev = max_crse; lev > lbase; --lev) {
+        for (const auto& c : rlist[lev]) {
+            for (const auto& off : offs) {
+                IntVect nb = c + off;
+                if (wrap(lev, nb)) {
+                    add(lev-1, amrex::coarsen(nb,2));
+                }
+            }
+        }
+    }
+
+    // Going up, drop the blocks that cannot be refined, either because
+    // they or some of their neighbors do not exist.
+    for (int lev = lbase; lev <= max_crse; ++lev)
+    {
+        auto exists = [&] (const IntVect& c) -> bool {
+            if (lev == lbase) {
+                return find(lev, c) >= 0;
+            } else {
+                return rset[lev-1].count(key(lev-1, amrex::coarsen(c,2))) > 0;
+            }
+        };
+
+        Vector<IntVect> kept;
+        kept.reserve(rlist[lev].size());
+        for (const auto& c : rlist[lev]) {
+            bool ok = true;
+            for (const auto& off : offs) {
+                IntVect nb = c + off;
+                if (wrap(lev, nb) && !exists(nb)) {
+                    ok = false;
+                    break;
+                }
+            }
+            if (ok) {
+                kept.push_back(c);
+            } else {
+                rset[lev].erase(key(lev,c));
+            }
+        }
+        std::swap(rlist[lev], kept);
+    }
+
+    // The children of the refined blocks in the order of their parents,
+    // which gives Morton order if the parents are.
+    Vector<Vector<IntVect> > new_blocks(max_crse+2);
+    for (int lev = lbase; lev <= max_crse; ++lev)
+    {
+        if (rlist[lev].empty()) break;
+        const Vector<IntVect>& parents = (lev == lbase) ? m_level[lbase].coord : new_blocks[lev];
+        Vector<IntVect>& children = new_blocks[lev+1];
+        children.reserve(rlist[lev].size()*nchildren);
+        for (const auto& c : parents) {
+            if (rset[lev].count(key(lev,c))) {
+                for (int m = 0; m < nchildren; ++m) {
+                    children.push_back(2*c + childOffset(m));
+                }
+            }
+        }
+    }
+
+    return new_blocks;
+}
+
+std::uint64_t
+Octree::mortonKey (const IntVect& c, const Box& domain) noexcept
+{
+    constexpr int nbits = 64/AMREX_SPACEDIM;
+    std::uint64_t r = 0;
+    for (int b = 0; b < nbits; ++b) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const std::uint64_t x = c[idim] - domain.smallEnd(idim);
+            r |= ((x >> b) & 1) << (b*AMREX_SPACEDIM+idim);
+        }
+    }
+    return r;
+}
+
+Vector<IntVect>
+Octree::domainBlocks (const Box& block_domain)
+{
+    Vector<std::pair<std::uint64_t,IntVect> > keyed;
+    keyed.reserve(block_domain.numPts());
+    for (BoxIterator bi(block_domain); bi.ok(); ++bi) {
+        keyed.emplace_back(mortonKey(bi(), block_domain), bi());
+    }
+    std::sort(keyed.begin(), keyed.end(),
+              [] (std::pair<std::uint64_t,IntVect> const& a,
+                  std::pair<std::uint64_t,IntVect> const& b) { return a.first < b.first; });
+    Vector<IntVect> r;
+    r.reserve(keyed.size());
+    for (const auto& kv : keyed) {
+        r.push_back(kv.second);
+    }
+    return r;
+}
+
+BoxArray
+Octree::makeBoxArray (const Vector<IntVect>& coords, const IntVect& block_size)
+{
+    BoxList bl;
+    bl.reserve(coords.size());
+    for (const auto& c : coords) {
+        bl.push_back(Box(c*block_size, (c+1)*block_size-1));
+    }
+    return BoxArray(std::move(bl));
+}
+
+void
+Octree::setNeighbors (const Geometry& geom, const BoxArray& ba, const IntVect& block_size)
+{
+    if (ba.hasNeighbors(IntVect::TheZeroVector())) return;
+
+    BL_PROFILE("Octree::setNeighbors()");
+
+    const Octree tree({geom}, {ba}, 1, block_size);
+    const Vector<IntVect> offs = neighborOffsets();
+    const int n = tree.numBlocks(0);
+    Vector<Vector<int> > nbrs(n);
+    for (int i = 0; i < n; ++i) {
+        auto& nb = nbrs[i];
+        nb.reserve(offs.size());
+        for (const auto& off : offs) {
+            const int k = tree.neighbor(0,i,off);
+            if (k >= 0) nb.push_back(k);
+        }
+        // A periodic domain only a block or two wide may give duplicates.
+        std::sort(nb.begin(), nb.end());
+        nb.erase(std::unique(nb.begin(), nb.end()), nb.end());
+    }
+
+    // Box i grown by less than a block only reaches its neighbors.
+    ba.setNeighbors(std::move(nbrs), block_size-1);
+}
+
+DistributionMapping
+Octree::makeDistributionMap (int n)
+{
+    const int nprocs = ParallelDescriptor::NProcs();
+    Vector<int> pmap(n);
+    for (int iproc = 0; iproc < nprocs; ++iproc) {
+        const int ibegin = static_cast<int>((Long(n)*iproc)/nprocs);
+        const int iend = static_cast<int>((Long(n)*(iproc+1))/nprocs);
+        for (int i = ibegin; i < iend; ++i) {
+            pmap[i] = iproc;
+        }
+    }
+    return DistributionMapping(std::move(pmap));
+}
+
+}
@@ -2,6 +2,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <climits>
+#include <cstdint>
 
 #include <AMReX_TagBox.H>
 #include <AMReX_Geometry.H>
@@ -50,13 +51,25 @@ TagBox::coarsen (const IntVect& ratio, const Box& cbox) noexcept
     Dim3 r{1,1,1};
     AMREX_D_TERM(r.x = ratio[0];, r.y = ratio[1];, r.z = ratio[2]);
 
+    //
+    // OR the fine rows into the coarse rows, one coarse cell at a time
+    // so that the inner loop is over contiguous fine cells.
+    //
+    const int iclo = amrex::coarsen(flo.x,r.x);
+    const int ichi = amrex::coarsen(fhi.x,r.x);
     for (int k = flo.z; k <= fhi.z; ++k) {
         int kc = amrex::coarsen(k,r.z);
         for (int j = flo.y; j <= fhi.y; ++j) {
             int jc = amrex::coarsen(j,r.y);
-            for (int i = flo.x; i <= fhi.x; ++i) {
-                int ic = amrex::coarsen(i,r.x);
-                carr(ic,jc,kc) = carr(ic,jc,kc) || farr(i,j,k);
+            for (int ic = iclo; ic <= ichi; ++ic) {
+                const int ilo = std::max(flo.x, ic*r.x);
+                const int ihi = std::min(fhi.x, ic*r.x+r.x-1);
+                char t = 0;
+                AMREX_PRAGMA_SIMD
+                for (int i = ilo; i <= ihi; ++i) {
+                    t |= farr(i,j,k);
+                }
+                carr(ic,jc,kc) = carr(ic,jc,kc) || t;
             }
         }
     }
@@ -72,53 +85,110 @@ TagBox::buffer (const IntVect& nbuff, const IntVect& nwid) noexcept
     // Note: this routine assumes cell with TagBox::SET tag are in
     // interior of tagbox (region = grow(domain,-nwid)).
     //
+    // The cells within nbuff of a SET cell are the SET cells dilated by
+    // nbuff, which is done one direction at a time on a bit mask with one
+    // bit per cell.  Each row in the first direction is packed into
+    // 64-bit words.  The dilation in the first direction shifts the words
+    // of a row, and in the other directions it ORs whole rows, so the work
+    // does not depend on the number of tags and the inner loops are over
+    // contiguous words.
+    //
+    using Word = std::uint64_t;
+    constexpr int nbits = 64;
+
     Box inside(domain);
     inside.grow(-nwid);
-    const int* inlo = inside.loVect();
-    const int* inhi = inside.hiVect();
 
-    int klo = 0, khi = 0, jlo = 0, jhi = 0, ilo, ihi;
-    AMREX_D_TERM(ilo=inlo[0]; ihi=inhi[0]; ,
-                 jlo=inlo[1]; jhi=inhi[1]; ,
-                 klo=inlo[2]; khi=inhi[2];)
+    const auto lo = amrex::lbound(domain);
+    const auto hi = amrex::ubound(domain);
+    const auto len = amrex::length(domain);
+    const auto ilo = amrex::lbound(inside);
+    const auto ihi = amrex::ubound(inside);
+
+    const int nw = (len.x+nbits-1)/nbits;  // words per row
+    const Long nwords = Long(nw)*len.y*len.z;
+    const Word lastmask = (len.x%nbits == 0) ? ~Word(0) : (Word(1) << (len.x%nbits)) - 1;
+
+    Vector<Word> mask0(nwords, 0), mask1(nwords);
+    Word* a = mask0.data();
+    Word* b = mask1.data();
+    auto row = [&] (Word* p, int j, int k) -> Word* {
+        return p + (Long(k-lo.z)*len.y + (j-lo.y))*nw;
+    };
+
+    Array4<char> const& d = this->array();
+
+    bool any = false;
+    for (int k = ilo.z; k <= ihi.z; ++k) {
+        for (int j = ilo.y; j <= ihi.y; ++j) {
+            Word* AMREX_RESTRICT w = row(a,j,k);
+            for (int i = ilo.x; i <= ihi.x; ++i) {
+                if (d(i,j,k) == TagBox::SET) {
+                    const int ib = i - lo.x;
+                    w[ib/nbits] |= Word(1) << (ib%nbits);
+                    any = true;
+                }
+            }
+        }
+    }
+    if (!any) return;
 
-    int ni = 0, nj = 0, nk = 0;
-    AMREX_D_TERM(ni=nbuff[0];, nj=nbuff[1];, nk=nbuff[2];)
+    // First direction: dilate by one cell at a time, carrying the bits
+    // across word boundaries.
+    for (int m = 0; m < nbuff[0]; ++m)
+    {
+        for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+                Word const* AMREX_RESTRICT pa = row(a,j,k);
+                Word* AMREX_RESTRICT pb = row(b,j,k);
+                AMREX_PRAGMA_SIMD
+                for (int iw = 0; iw < nw; ++iw) {
+                    const Word lower = (iw > 0)    ? pa[iw-1] >> (nbits-1) : 0;
+                    const Word upper = (iw < nw-1) ? pa[iw+1] << (nbits-1) : 0;
+                    pb[iw] = pa[iw] | (pa[iw] << 1) | (pa[iw] >> 1) | lower | upper;
+                }
+                pb[nw-1] &= lastmask;
+            }
+        }
+        std::swap(a, b);
+    }
 
-    IntVect d_length = domain.size();
-    const int* len = d_length.getVect();
-    const int* lo = domain.loVect();
-    TagType* d = dataPtr();
-
-    amrex::ignore_unused(len);
-#define OFF(i,j,k,lo,len) AMREX_D_TERM(i-lo[0], +(j-lo[1])*len[0] , +(k-lo[2])*len[0]*len[1])
-   
-    for (int k = klo; k <= khi; k++)
+    // The other directions: OR the rows within nbuff of each row.
+#if (AMREX_SPACEDIM > 1)
+    for (int idim = 1; idim < AMREX_SPACEDIM; ++idim)
     {
-        for (int j = jlo; j <= jhi; j++)
-        {
-            for (int i = ilo; i <= ihi; i++)
-            {
-                TagType* d_check = d + OFF(i,j,k,lo,len);
-                if (*d_check == TagBox::SET)
-                {
-                    for (int kk = -nk; kk <= nk; kk++)
-                    {
-                        for (int jj = -nj; jj <= nj; jj++)
-                        {
-                            for (int ii = -ni; ii <= ni; ii++)
-                            {
-                                TagType* dn = d_check+ AMREX_D_TERM(ii, +jj*len[0], +kk*len[0]*len[1]);
-                                if (*dn !=TagBox::SET)
-                                    *dn = TagBox::BUF;
-                            }
-                        }
+        const int n = nbuff[idim];
+        if (n <= 0) continue;
+        for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+                Word* AMREX_RESTRICT pb = row(b,j,k);
+                for (int iw = 0; iw < nw; ++iw) pb[iw] = 0;
+                const int mlo = (idim == 1) ? std::max(-n, lo.y-j) : std::max(-n, lo.z-k);
+                const int mhi = (idim == 1) ? std::min( n, hi.y-j) : std::min( n, hi.z-k);
+                for (int m = mlo; m <= mhi; ++m) {
+                    Word const* AMREX_RESTRICT pa = (idim == 1) ? row(a,j+m,k) : row(a,j,k+m);
+                    AMREX_PRAGMA_SIMD
+                    for (int iw = 0; iw < nw; ++iw) {
+                        pb[iw] |= pa[iw];
                     }
                 }
             }
         }
+        std::swap(a, b);
+    }
+#endif
+
+    for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+            Word const* AMREX_RESTRICT w = row(a,j,k);
+            for (int i = lo.x; i <= hi.x; ++i) {
+                const int ib = i - lo.x;
+                if (((w[ib/nbits] >> (ib%nbits)) & 1) && d(i,j,k) != TagBox::SET) {
+                    d(i,j,k) = TagBox::BUF;
+                }
+            }
+        }
     }
-#undef OFF
 }
 
 Long
@@ -421,6 +491,57 @@ TagBoxArray::numTags () const
     return ntag;
 }
 
+namespace {
+
+//
+// Tags are collated as runs of tagged cells along the first direction,
+// each stored as the IntVect of its first cell followed by its length.
+//
+constexpr int run_size = AMREX_SPACEDIM+1;
+
+Long
+collate_runs (const TagBox& tb, Vector<int>& runs)
+{
+    Array4<char const> const& a = tb.const_array();
+    const auto lo = amrex::lbound(tb.box());
+    const auto hi = amrex::ubound(tb.box());
+    const int n = hi.x - lo.x + 1;
+    Long count = 0;
+    for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+            const char* row = a.ptr(lo.x,j,k);
+            int i = 0;
+            while (true) {
+                while (i < n && row[i] == TagBox::CLEAR) ++i;
+                if (i == n) break;
+                const int i0 = i;
+                while (i < n && row[i] != TagBox::CLEAR) ++i;
+                const IntVect iv(AMREX_D_DECL(lo.x+i0,j,k));
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    runs.push_back(iv[idim]);
+                }
+                runs.push_back(i-i0);
+                count += i-i0;
+            }
+        }
+    }
+    return count;
+}
+
+void
+decode_runs (const int* runs, Long nints, IntVect* tags)
+{
+    for (Long r = 0; r < nints; r += run_size) {
+        IntVect iv(runs+r);
+        for (int i = 0, len = runs[r+AMREX_SPACEDIM]; i < len; ++i) {
+            *tags++ = iv;
+            ++iv[0];
+        }
+    }
+}
+
+}
+
 void
 TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
 {
@@ -428,6 +549,10 @@ TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
 
     Gpu::LaunchSafeGuard lsg(false); // xxxxx TODO: gpu
 
+    //
+    // The runs of tags in each local TagBox, in the order of the TagBoxes.
+    //
+    Vector<Vector<int> > fab_runs(local_size());
     Long count = 0;
 
 #ifdef _OPENMP
@@ -435,32 +560,32 @@ TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
 #endif
     for (MFIter fai(*this); fai.isValid(); ++fai)
     {
-        count += get(fai).numTags();
+        count += collate_runs(get(fai), fab_runs[fai.LocalIndex()]);
     }
 
-    //
-    // Local space for holding just those tags we want to gather to the root cpu.
-    //
-    Vector<IntVect> TheLocalCollateSpace(count);
-
-    count = 0;
-
-    // unsafe to do OMP
-    for (MFIter fai(*this); fai.isValid(); ++fai)
-    {
-        count += get(fai).collate(TheLocalCollateSpace,count);
+    Long nints = 0;
+    for (const auto& v : fab_runs) {
+        nints += v.size();
+    }
+    Vector<int> TheLocalRuns;
+    TheLocalRuns.reserve(nints);
+    for (const auto& v : fab_runs) {
+        TheLocalRuns.insert(std::end(TheLocalRuns), std::begin(v), std::end(v));
     }
 
     //
     // The total number of tags system wide that must be collated.
     //
-    Long numtags = count;
-    ParallelDescriptor::ReduceLongSum(numtags);
+    Long nsum[2] = {count, nints};
+    ParallelDescriptor::ReduceLongSum(nsum, 2);
+    const Long numtags = nsum[0];
+    const Long numints = nsum[1];
 
     if (numtags == 0) {
         TheGlobalCollateSpace.clear();
         return;
-    } else if (numtags > static_cast<Long>(std::numeric_limits<int>::max())) {
+    } else if (numtags > static_cast<Long>(std::numeric_limits<int>::max()) ||
+               numints > static_cast<Long>(std::numeric_limits<int>::max())) {
         // xxxxx todo
         amrex::Abort("TagBoxArray::collate: Too many tags. Using a larger blocking factor might help. Please file an issue on github");
     }
@@ -477,10 +602,10 @@ TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
     }
 
     //
-    // Tell root CPU how many tags each CPU will be sending.
+    // Tell root CPU how many ints of runs each CPU will be sending.
     //
     const int IOProcNumber = ParallelDescriptor::IOProcessorNumber();
-    const std::vector<int>& countvec = ParallelDescriptor::Gather(static_cast<int>(count),
+    const std::vector<int>& countvec = ParallelDescriptor::Gather(static_cast<int>(nints),
                                                                   IOProcNumber);
     std::vector<int> offset(countvec.size(),0);
     if (ParallelDescriptor::IOProcessor()) {
@@ -489,14 +614,19 @@ TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
 	}
     }
     //
-    // Gather all the tags to IOProcNumber into TheGlobalCollateSpace.
+    // Gather all the runs to IOProcNumber and expand them into TheGlobalCollateSpace.
     //
-    const IntVect* psend = (count > 0) ? TheLocalCollateSpace.data() : nullptr;
-    IntVect* precv = TheGlobalCollateSpace.data();
-    ParallelDescriptor::Gatherv(psend, count, precv, countvec, offset, IOProcNumber);
+    Vector<int> TheGlobalRuns(ParallelDescriptor::IOProcessor() ? numints : 1);
+    const int* psend = (nints > 0) ? TheLocalRuns.data() : nullptr;
+    ParallelDescriptor::Gatherv(psend, static_cast<int>(nints), TheGlobalRuns.data(),
+                                countvec, offset, IOProcNumber);
 
+    if (ParallelDescriptor::IOProcessor()) {
+        decode_runs(TheGlobalRuns.data(), numints, TheGlobalCollateSpace.data());
+    }
 #else
-    TheGlobalCollateSpace = std::move(TheLocalCollateSpace);
+    TheGlobalCollateSpace.resize(numtags);
+    decode_runs(TheLocalRuns.data(), numints, TheGlobalCollateSpace.data());
 #endif
 }
 
@@ -73,6 +73,7 @@ namespace system
     int call_addr2line;
     int throw_exception;
     int regtest_reduction;
+    int reproducible_sum;
     int abort_on_unused_inputs = 0;
     std::ostream* osout = &std::cout;
     std::ostream* oserr = &std::cerr;
@@ -291,6 +292,7 @@ amrex::Initialize (int& argc, char**& argv, bool build_parm_parse,
     system::exename.clear();
 //    system::verbose = 0;
     system::regtest_reduction = 0;
+    system::reproducible_sum = 0;
     system::signal_handling = 1;
     system::call_addr2line = 1;
     system::throw_exception = 0;
@@ -398,6 +400,7 @@ amrex::Initialize (int& argc, char**& argv, bool build_parm_parse,
     {
         ParmParse pp("amrex");
         pp.query("regtest_reduction", system::regtest_reduction);
+        pp.query("reproducible_sum", system::reproducible_sum);
         pp.query("signal_handling", system::signal_handling);
         pp.query("throw_exception", system::throw_exception);
         pp.query("call_addr2line", system::call_addr2line);
@@ -73,7 +73,7 @@ BARef::BARef (std::istream& is)
 }
 
 BARef::BARef (const BARef& rhs) 
-    : m_abox(rhs.m_abox) // don't copy hash
+    : m_abox(rhs.m_abox) // don't copy hash or neighbors
 {
 #ifdef AMREX_MEM_PROFILING
     updateMemoryUsage_box(1);
@@ -1372,6 +1372,22 @@ BoxArray::clear_hash_bin () const
     }
 }
 
+void
+BoxArray::setNeighbors (Vector<Vector<int> >&& a_nbrs, const IntVect& max_ngrow) const
+{
+    AMREX_ASSERT(a_nbrs.size() == size());
+    m_ref->nbrs = std::move(a_nbrs);
+    m_ref->nbrs_ngrow = max_ngrow;
+}
+
+bool
+BoxArray::hasNeighbors (const IntVect& ng) const noexcept
+{
+    return !m_ref->nbrs.empty() && m_bat.is_simple()
+        && crseRatio() == IntVect::TheUnitVector()
+        && ng.allLE(m_ref->nbrs_ngrow);
+}
+
 //
 // Currently this assumes your Boxes are cell-centered.
 //
@@ -1386,72 +1402,72 @@ BoxArray::removeOverlap (bool simplify)
         amrex::Abort("BoxArray::removeOverlap() must have m_crse_ratio == 1");
     }
 
-    uniqify();
-
-    BARef::HashType& BoxHashMap = m_ref->hash;
-
-    const Box EmptyBox;
+    BL_PROFILE("BoxArray::removeOverlap()");
 
-    std::vector< std::pair<int,Box> > isects;
     //
-    // Note that "size()" can increase in this loop!!!
+    // Each box keeps the part that is not covered by the boxes before it,
+    // so the pieces of different boxes are disjoint and can be computed
+    // independently.  They are collected in chunks of boxes to keep their
+    // order independent of the number of threads.
     //
-#ifdef AMREX_MEM_PROFILING
-    m_ref->updateMemoryUsage_box(-1);
-    m_ref->updateMemoryUsage_hash(-1);
-    Long total_hash_bytes_save = m_ref->total_hash_bytes;
-#endif
+    const int N = size();
+    const int chunk_size = 64;
+    const int nchunks = (N+chunk_size-1) / chunk_size;
+    Vector<Vector<Box> > pieces(nchunks);
 
-    BoxList bl_diff;
+    getHashMap();
 
-    for (int i = 0; i < size(); i++)
+#ifdef _OPENMP
+#pragma omp parallel if (!omp_in_parallel())
+#endif
     {
-        if (m_ref->m_abox[i].ok())
+        std::vector< std::pair<int,Box> > isects;
+        BoxList bl_piece(ixType()), bl_tmp(ixType()), bl_diff(ixType());
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int ichunk = 0; ichunk < nchunks; ++ichunk)
         {
-            intersections(m_ref->m_abox[i],isects);
-
-            for (int j = 0, N = isects.size(); j < N; j++)
+            Vector<Box>& vbox = pieces[ichunk];
+            for (int i = ichunk*chunk_size, iend = std::min(N,i+chunk_size); i < iend; ++i)
             {
-                if (isects[j].first == i) continue;
-
-                Box& bx = m_ref->m_abox[isects[j].first];
-
-                amrex::boxDiff(bl_diff, bx, isects[j].second);
-
-                bx = EmptyBox;
+                const Box& bx = m_ref->m_abox[i];
+                if (!bx.ok()) continue;
+                intersections(bx,isects);
 
-                for (const Box& b : bl_diff)
+                bl_piece.clear();
+                bl_piece.push_back(bx);
+                for (const auto& is : isects)
                 {
-                    m_ref->m_abox.push_back(b);
-                    BoxHashMap[amrex::coarsen(b.smallEnd(),m_ref->crsn)].push_back(size()-1);
+                    if (is.first >= i) continue;
+                    bl_tmp.clear();
+                    for (const Box& b : bl_piece) {
+                        amrex::boxDiff(bl_diff, b, is.second);
+                        bl_tmp.join(bl_diff);
+                    }
+                    bl_piece.swap(bl_tmp);
+                    if (bl_piece.isEmpty()) break;
                 }
+                vbox.insert(std::end(vbox), std::begin(bl_piece), std::end(bl_piece));
             }
         }
     }
-#ifdef AMREX_MEM_PROFILING
-    m_ref->updateMemoryUsage_box(1);
-#endif
-    //
-    // We now have "holes" in our BoxArray. Make us good.
-    //
+
+    Long npieces = 0;
+    for (const auto& v : pieces) {
+        npieces += v.size();
+    }
     BoxList bl(ixType());
-    for (const auto& b : m_ref->m_abox) {
-        if (b.ok()) {
-            bl.push_back(b);
-        }
+    bl.reserve(npieces);
+    for (const auto& v : pieces) {
+        bl.join(v);
     }
-    
+
     if (simplify) {
         bl.simplify();
     }
 
-    BoxArray nba(std::move(bl));
-
-    *this = nba;
-
-#ifdef AMREX_MEM_PROFILING
-    m_ref->total_hash_bytes = total_hash_bytes_save;
-#endif
+    *this = BoxArray(std::move(bl));
 
     BL_ASSERT(isDisjoint());
 }
@@ -1541,6 +1557,7 @@ BoxArray::uniqify ()
 {
     if (m_ref.use_count() == 1) {
         clear_hash_bin();
+        m_ref->nbrs.clear();
     } else {
 	auto p = std::make_shared<BARef>(*m_ref);
 	std::swap(m_ref,p);
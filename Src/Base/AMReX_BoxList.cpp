@@ -59,6 +59,65 @@ static void chop_boxes_dir (Box* bxv, const Box& bx, int nboxes, int idir)
     }
 }
 
+
+// Sorts v with comp, which must be a total order so that the result does
+// not depend on the number of threads.  Each thread sorts a chunk and the
+// chunks are merged in pairs.
+template <class F>
+void sort_boxes (Vector<Box>& v, F const& comp)
+{
+    const Long N = v.size();
+#ifdef _OPENMP
+    const int nchunks = (omp_in_parallel() || N < 10000) ? 1 : omp_get_max_threads();
+#else
+    const int nchunks = 1;
+#endif
+    if (nchunks == 1) {
+        std::sort(v.begin(), v.end(), comp);
+        return;
+    }
+
+    Vector<Long> bnd(nchunks+1);
+    for (int i = 0; i <= nchunks; ++i) {
+        bnd[i] = (N*i)/nchunks;
+    }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < nchunks; ++i) {
+        std::sort(v.begin()+bnd[i], v.begin()+bnd[i+1], comp);
+    }
+    for (int w = 1; w < nchunks; w *= 2) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = 0; i < nchunks; i += 2*w) {
+            if (i+w < nchunks) {
+                std::inplace_merge(v.begin()+bnd[i], v.begin()+bnd[i+w],
+                                   v.begin()+bnd[std::min(i+2*w,nchunks)], comp);
+            }
+        }
+    }
+}
+
+// Orders the boxes by their extents in the directions other than dir
+// first, so that the boxes that can be merged in direction dir are next
+// to each other.
+struct MergeOrder
+{
+    int dir;
+    bool operator() (const Box& a, const Box& b) const noexcept
+    {
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            if (d == dir) continue;
+            if (a.smallEnd(d) != b.smallEnd(d)) return a.smallEnd(d) < b.smallEnd(d);
+            if (a.bigEnd(d) != b.bigEnd(d)) return a.bigEnd(d) < b.bigEnd(d);
+        }
+        if (a.smallEnd(dir) != b.smallEnd(dir)) return a.smallEnd(dir) < b.smallEnd(dir);
+        return a.bigEnd(dir) < b.bigEnd(dir);
+    }
+};
+
 }
 
 void
@@ -658,17 +717,66 @@ boxDiff (BoxList& bl_diff, const Box& b1in, const Box& b2)
 int
 BoxList::simplify (bool best)
 {
-    std::sort(m_lbox.begin(), m_lbox.end(), [](const Box& l, const Box& r) {
-            return l.smallEnd() < r.smallEnd(); });
+    BL_PROFILE("BoxList::simplify()");
+
+    removeEmpty();
+
+    //
+    // Merge the boxes in one direction after the other.  If "best" is
+    // specified we keep going until no more boxes can be merged.
+    //
+    int count = 0;
+    for (int nmerged = 1; nmerged > 0 && size() > 1; )
+    {
+        nmerged = 0;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            nmerged += simplify_dir(idim);
+        }
+        count += nmerged;
+        if (!best) break;
+    }
+
+    sort_boxes(m_lbox, [] (const Box& l, const Box& r) {
+            return (l.smallEnd() == r.smallEnd()) ? l.bigEnd() < r.bigEnd()
+                                                  : l.smallEnd() < r.smallEnd(); });
+
+    return count;
+}
+
+int
+BoxList::simplify_dir (int dir)
+{
+    if (size() < 2) return 0;
+
+    sort_boxes(m_lbox, MergeOrder{dir});
 
     //
-    // If we're not looking for the "best" we can do in one pass, we
-    // limit how far afield we look for abutting boxes.  This greatly
-    // speeds up this routine for large numbers of boxes.  It does not
-    // do quite as good a job though as full brute force.
+    // Boxes with the same extents in the other directions are now sorted
+    // by their small end in direction dir.  Each run of them that abut
+    // in direction dir becomes one box.  Overlapping boxes are not merged.
     //
-    int depth = best ? size() : 100;
-    return simplify_doit(depth);
+    int count = 0;
+    Long j = 0;
+    for (Long i = 1, N = m_lbox.size(); i < N; ++i)
+    {
+        Box& a = m_lbox[j];
+        const Box& b = m_lbox[i];
+        bool same = true;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            if (d != dir) {
+                same = same && a.smallEnd(d) == b.smallEnd(d) && a.bigEnd(d) == b.bigEnd(d);
+            }
+        }
+        if (same && b.smallEnd(dir) == a.bigEnd(dir)+1) {
+            a.setBig(dir, b.bigEnd(dir));
+            ++count;
+        } else {
+            m_lbox[++j] = b;
+        }
+    }
+    m_lbox.resize(j+1);
+
+    return count;
 }
 
 int
@@ -1794,22 +1794,32 @@ DistributionMapping::makeSFC (const LayoutData<Real>& rcost_local,
     
 std::vector<std::vector<int> >
 DistributionMapping::makeSFC (const BoxArray& ba, bool use_box_vol, const int nprocs)
+{
+    const int N = ba.size();
+    std::vector<Long> wgts;
+    wgts.reserve(N);
+    for (int i = 0; i < N; ++i)
+    {
+        wgts.push_back(use_box_vol ? ba[i].volume() : Long(1));
+    }
+    return makeSFC(ba, wgts, nprocs);
+}
+
+std::vector<std::vector<int> >
+DistributionMapping::makeSFC (const BoxArray& ba, const std::vector<Long>& wgts, const int nprocs)
 {
     BL_PROFILE("makeSFC");
 
     const int N = ba.size();
+    BL_ASSERT(N == static_cast<int>(wgts.size()));
     std::vector<SFCToken> tokens;
-    std::vector<Long> wgts;
     tokens.reserve(N);
-    wgts.reserve(N);
     Long vol_sum = 0;
     for (int i = 0; i < N; ++i)
     {
         const Box& bx = ba[i];
         tokens.push_back(makeSFCToken(i, bx.smallEnd()));
-        const Long v = use_box_vol ? bx.volume() : Long(1);
-        vol_sum += v;
-        wgts.push_back(v);
+        vol_sum += wgts[i];
     }
     //
     // Put'm in Morton space filling curve order.
@@ -0,0 +1,120 @@
+
+#include <AMReX_ExactSum.H>
+
+#include <cmath>
+#include <limits>
+
+namespace amrex {
+
+namespace {
+    constexpr int i_posinf = ExactSum::nchunks;
+    constexpr int i_neginf = ExactSum::nchunks+1;
+    constexpr int i_nan    = ExactSum::nchunks+2;
+}
+
+void
+ExactSum::clear () noexcept
+{
+    for (auto& c : m_chunk) c = 0;
+    m_adds_left = max_adds;
+}
+
+void
+ExactSum::add_special (bool nan, bool negative) noexcept
+{
+    if (nan) {
+        ++m_chunk[i_nan];
+    } else if (negative) {
+        ++m_chunk[i_neginf];
+    } else {
+        ++m_chunk[i_posinf];
+    }
+}
+
+void
+ExactSum::propagate () noexcept
+{
+    for (int i = 0; i < nchunks-1; ++i) {
+        const std::int64_t digits = m_chunk[i] & 0xffffffffLL;
+        m_chunk[i+1] += (m_chunk[i] - digits) / (std::int64_t(1) << 32);
+        m_chunk[i] = digits;
+    }
+    m_adds_left = max_adds;
+}
+
+void
+ExactSum::add (ExactSum const& rhs) noexcept
+{
+    // After the propagation, the chunks of this are less than 2^32, and
+    // those of rhs are less than 2^62 + 2^32.
+    propagate();
+    for (int i = 0; i < nchunks+3; ++i) {
+        m_chunk[i] += rhs.m_chunk[i];
+    }
+    propagate();
+}
+
+double
+ExactSum::value () const noexcept
+{
+    ExactSum t = *this;
+    if (t.m_chunk[i_nan] > 0 || (t.m_chunk[i_posinf] > 0 && t.m_chunk[i_neginf] > 0)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    } else if (t.m_chunk[i_posinf] > 0) {
+        return std::numeric_limits<double>::infinity();
+    } else if (t.m_chunk[i_neginf] > 0) {
+        return -std::numeric_limits<double>::infinity();
+    }
+
+    t.propagate();
+
+    // Only the last chunk can be negative now, and its sign is the sign of
+    // the sum.  Work with the absolute value.
+    const bool negative = t.m_chunk[nchunks-1] < 0;
+    if (negative) {
+        for (int i = 0; i < nchunks; ++i) {
+            t.m_chunk[i] = -t.m_chunk[i];
+        }
+        t.propagate();
+    }
+
+    int ih = nchunks-1;
+    while (ih >= 0 && t.m_chunk[ih] == 0) --ih;
+    if (ih < 0) return 0.0;
+
+    // Take the leading 64 bits, and set the lowest of them if any of the
+    // bits below them is set, so that converting them to double rounds
+    // correctly.
+    auto chunk = [&t] (int i) -> std::uint64_t {
+        return (i >= 0) ? static_cast<std::uint64_t>(t.m_chunk[i]) : 0;
+    };
+    const std::uint64_t c0 = chunk(ih);
+    const std::uint64_t c1 = chunk(ih-1);
+    const std::uint64_t c2 = chunk(ih-2);
+    int nbits = 0;
+    while (nbits < 32 && (c0 >> nbits) != 0) ++nbits;
+    std::uint64_t lead = (c0 << (64-nbits)) | (c1 << (32-nbits)) | (c2 >> nbits);
+    bool sticky = (c2 & ((std::uint64_t(1) << nbits) - 1)) != 0;
+    for (int i = ih-3; i >= 0 && !sticky; --i) {
+        sticky = t.m_chunk[i] != 0;
+    }
+    if (sticky) lead |= 1;
+
+    double r = std::ldexp(static_cast<double>(lead), 32*ih + nbits - 64 - 1075);
+    return negative ? -r : r;
+}
+
+void
+ExactSum::ParallelAllReduce (MPI_Comm comm)
+{
+#ifdef BL_USE_MPI
+    propagate();
+    BL_MPI_REQUIRE( MPI_Allreduce(MPI_IN_PLACE, m_chunk, nchunks+3, MPI_INT64_T,
+                                  MPI_SUM, comm) );
+    propagate();
+#else
+    amrex::ignore_unused(comm);
+#endif
+}
+
+}
@@ -624,6 +624,44 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
 // Some stuff for fill boundary
 //
 
+namespace {
+    // The intersections of bx with the boxes of ba grown by ng.  With a
+    // neighbor table, only the neighbors of box i are searched.
+    void neighborIntersections (const BoxArray& ba, bool use_nbrs, int i, const Box& bx,
+                                const IntVect& ng, std::vector< std::pair<int,Box> >& isects)
+    {
+        if (use_nbrs) {
+            isects.clear();
+            for (int k : ba.neighbors(i)) {
+                const Box& isect = amrex::grow(ba[k],ng) & bx;
+                if (isect.ok()) {
+                    isects.emplace_back(k,isect);
+                }
+            }
+        } else {
+            ba.intersections(bx, isects, false, ng);
+        }
+    }
+
+    // The part of bx not covered by the neighbors of box i in the
+    // neighbor table of ba.
+    BoxList neighborComplementIn (const BoxArray& ba, int i, const Box& bx)
+    {
+        BoxList bl(bx);
+        for (int k : ba.neighbors(i)) {
+            const Box& nbx = ba[k];
+            if (nbx.intersects(bx)) {
+                BoxList tmp(bx.ixType());
+                for (const Box& b : bl) {
+                    tmp.join(amrex::boxDiff(b, nbx));
+                }
+                std::swap(bl, tmp);
+            }
+        }
+        return bl;
+    }
+}
+
 FabArrayBase::FB::FB (const FabArrayBase& fa, const IntVect& nghost,
                       bool cross, const Periodicity& period, 
                       bool enforce_periodicity_only,
@@ -668,6 +706,9 @@ FabArrayBase::FB::define_fb(const FabArrayBase& fa)
     std::vector< std::pair<int,Box> > isects;
     
     const std::vector<IntVect>& pshifts = m_period.shiftIntVect();
+
+    // Block-structured grids may carry their neighbors.
+    const bool use_nbrs = ba.hasNeighbors(ng);
     
     auto& send_tags = *m_SndTags;
     
@@ -679,7 +720,7 @@ FabArrayBase::FB::define_fb(const FabArrayBase& fa)
 
 	for (auto pit=pshifts.cbegin(); pit!=pshifts.cend(); ++pit)
 	{
-	    ba.intersections(vbx+(*pit), isects, false, ng);
+	    neighborIntersections(ba, use_nbrs, ksnd, vbx+(*pit), ng, isects);
 
 	    for (int j = 0, M = isects.size(); j < M; ++j)
 	    {
@@ -751,7 +792,7 @@ FabArrayBase::FB::define_fb(const FabArrayBase& fa)
 	
 	for (auto pit=pshifts.cbegin(); pit!=pshifts.cend(); ++pit)
 	{
-	    ba.intersections(bxrcv+(*pit), isects);
+	    neighborIntersections(ba, use_nbrs, krcv, bxrcv+(*pit), IntVect::TheZeroVector(), isects);
 
 	    for (int j = 0, M = isects.size(); j < M; ++j)
 	    {
@@ -1140,8 +1181,13 @@ FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
     const BoxArray& dstba = dstfa.boxArray();
     BL_ASSERT(srcba.ixType() == dstba.ixType());
 
-    BoxArray srcba_simplified = srcba.simplified();
-    BoxArray dstba_simplified = dstba.simplified();
+    // For block-structured grids with a neighbor table, the ghost cells
+    // of a box can only be covered by its neighbors.
+    const bool use_nbrs = BoxArray::SameRefs(srcba, dstba)
+        && srcba.hasNeighbors(dstng) && dstba.hasNeighbors(dstng);
+
+    BoxArray srcba_simplified = use_nbrs ? srcba : srcba.simplified();
+    BoxArray dstba_simplified = use_nbrs ? dstba : dstba.simplified();
 
     const IndexType& boxtype = dstba.ixType();
     BL_ASSERT(boxtype == dstdomain.ixType());
@@ -1169,7 +1215,8 @@ FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
         Box bx = dstba_simplified[i];
         bx.grow(m_dstng);
         bx &= m_dstdomain;
-        BoxList const& leftover = srcba_simplified.complementIn(bx);
+        BoxList const& leftover = use_nbrs ? neighborComplementIn(srcba, i, bx)
+                                           : srcba_simplified.complementIn(bx);
         if (leftover.isNotEmpty()) {
             bl.join(leftover);
         }
@@ -1,8 +1,11 @@
 
 #include <iostream>
 #include <cstdlib>
+#include <cstdint>
 #include <limits>
 #include <cstring>
+#include <algorithm>
+#include <type_traits>
 
 #include <AMReX.H>
 #include <AMReX_FabConv.H>
@@ -906,6 +909,186 @@ operator>> (std::istream&   is,
     return is;
 }
 
+//
+// Fast paths for IEEE 32 and 64 bit data whose byte order is either the
+// native one or its reverse.  These are the cases we see in practice:
+// reading big-endian or 32-bit plotfiles, and writing 32-bit plotfiles
+// from double runs.  The generic bit-field machinery above is only needed
+// for the other formats.
+//
+
+namespace {
+
+inline std::uint32_t
+ieee_bswap (std::uint32_t v)
+{
+    v = ((v << 8) & 0xFF00FF00U) | ((v >> 8) & 0x00FF00FFU);
+    return (v << 16) | (v >> 16);
+}
+
+inline std::uint64_t
+ieee_bswap (std::uint64_t v)
+{
+    v = ((v <<  8) & 0xFF00FF00FF00FF00ULL) | ((v >>  8) & 0x00FF00FF00FF00FFULL);
+    v = ((v << 16) & 0xFFFF0000FFFF0000ULL) | ((v >> 16) & 0x0000FFFF0000FFFFULL);
+    return (v << 32) | (v >> 32);
+}
+
+template <typename T> struct IEEEBits;
+
+template <> struct IEEEBits<float>
+{
+    using type = std::uint32_t;
+    static constexpr std::uint32_t exp_mask = 0x7F800000U;
+};
+
+template <> struct IEEEBits<double>
+{
+    using type = std::uint64_t;
+    static constexpr std::uint64_t exp_mask = 0x7FF0000000000000ULL;
+};
+
+template <typename TI, typename TO>
+inline typename IEEEBits<TO>::type
+ieee_cast (typename IEEEBits<TI>::type u, std::true_type)
+{
+    return u;
+}
+
+//
+// As in the generic path, values that are zero or denormal in the input
+// or the output precision become +0.
+//
+template <typename TI, typename TO>
+inline typename IEEEBits<TO>::type
+ieee_cast (typename IEEEBits<TI>::type u, std::false_type)
+{
+    TI x;
+    std::memcpy(&x, &u, sizeof(TI));
+    const TO y = static_cast<TO>(x);
+    typename IEEEBits<TO>::type v;
+    std::memcpy(&v, &y, sizeof(TO));
+    if ((u & IEEEBits<TI>::exp_mask) == 0 || (v & IEEEBits<TO>::exp_mask) == 0) {
+        v = 0;
+    }
+    return v;
+}
+
+//
+// Convert nitems of TI to TO, reversing the bytes of the input and the
+// output as requested.
+//
+template <typename TI, typename TO, bool SwapIn, bool SwapOut>
+void
+ieee_convert (void* out, const void* in, Long nitems)
+{
+    using UI = typename IEEEBits<TI>::type;
+    using UO = typename IEEEBits<TO>::type;
+
+    const char* pin  = static_cast<const char*>(in);
+    char*       pout = static_cast<char*>(out);
+
+    constexpr Long blocksize = 4096;
+    const Long nblocks = (nitems + blocksize - 1) / blocksize;
+#ifdef _OPENMP
+#pragma omp parallel for if (nblocks > 16)
+#endif
+    for (Long ib = 0; ib < nblocks; ++ib)
+    {
+        const Long ibegin = ib*blocksize;
+        const Long iend = std::min(ibegin+blocksize, nitems);
+        AMREX_PRAGMA_SIMD
+        for (Long i = ibegin; i < iend; ++i)
+        {
+            UI u;
+            std::memcpy(&u, pin + i*sizeof(UI), sizeof(UI));
+            if (SwapIn) u = ieee_bswap(u);
+            UO v = ieee_cast<TI,TO>(u, std::is_same<TI,TO>());
+            if (SwapOut) v = ieee_bswap(v);
+            std::memcpy(pout + i*sizeof(UO), &v, sizeof(UO));
+        }
+    }
+}
+
+template <typename TI, typename TO>
+void
+ieee_convert (void* out, const void* in, Long nitems, bool swap_in, bool swap_out)
+{
+    if (swap_in) {
+        if (swap_out) {
+            ieee_convert<TI,TO,true,true>(out, in, nitems);
+        } else {
+            ieee_convert<TI,TO,true,false>(out, in, nitems);
+        }
+    } else {
+        if (swap_out) {
+            ieee_convert<TI,TO,false,true>(out, in, nitems);
+        } else {
+            ieee_convert<TI,TO,false,false>(out, in, nitems);
+        }
+    }
+}
+
+//
+// Returns the number of bytes if rd is IEEE 32 or 64 bit in the native
+// byte order or its reverse, and 0 otherwise.  swap is set to whether
+// the bytes are reversed from the native order.
+//
+int
+ieee_kind (const RealDescriptor& rd, bool& swap)
+{
+    const int nb = rd.numBytes();
+    const RealDescriptor* native;
+    if (nb == 4 && rd.formatarray() == FPC::Native32RealDescriptor().formatarray()) {
+        native = &FPC::Native32RealDescriptor();
+    } else if (nb == 8 && rd.formatarray() == FPC::Native64RealDescriptor().formatarray()) {
+        native = &FPC::Native64RealDescriptor();
+    } else {
+        return 0;
+    }
+
+    const int* ord  = rd.order();
+    const int* nord = native->order();
+    bool same = true, reversed = true;
+    for (int i = 0; i < nb; ++i) {
+        same     = same     && (ord[i] == nord[i]);
+        reversed = reversed && (ord[i] == nord[nb-1-i]);
+    }
+    swap = !same;
+    return (same || reversed) ? nb : 0;
+}
+
+//
+// Converts with a fast path if both descriptors are IEEE 32 or 64 bit in
+// the native byte order or its reverse.  Returns false otherwise.
+//
+bool
+ieee_fast_convert (void*                 out,
+                   const void*           in,
+                   Long                  nitems,
+                   const RealDescriptor& ord,
+                   const RealDescriptor& ird)
+{
+    bool swap_out = false, swap_in = false;
+    const int nbo = ieee_kind(ord, swap_out);
+    const int nbi = ieee_kind(ird, swap_in);
+    if (nbo == 0 || nbi == 0) return false;
+
+    if (nbi == 4 && nbo == 4) {
+        // Only the relative order matters when the precision is the same.
+        ieee_convert<float,float>(out, in, nitems, swap_in != swap_out, false);
+    } else if (nbi == 8 && nbo == 8) {
+        ieee_convert<double,double>(out, in, nitems, swap_in != swap_out, false);
+    } else if (nbi == 4 && nbo == 8) {
+        ieee_convert<float,double>(out, in, nitems, swap_in, swap_out);
+    } else {
+        ieee_convert<double,float>(out, in, nitems, swap_in, swap_out);
+    }
+    return true;
+}
+
+}
+
 static
 void
 PD_convert (void*                 out,
@@ -924,23 +1107,14 @@ PD_convert (void*                 out,
         BL_ASSERT(int(n) == nitems);
         memcpy(out, in, n*ord.numBytes());
     }
+    else if (boffs == 0 && ! onescmp && ieee_fast_convert(out, in, nitems, ord, ird))
+    {
+        // Done.
+    }
     else if (ord.formatarray() == ird.formatarray() && boffs == 0 && ! onescmp) {
         permute_real_word_order(out, in, nitems,
                                 ord.order(), ird.order(), ord.numBytes());
     }
-    else if (ird == FPC::NativeRealDescriptor() && ord == FPC::Native32RealDescriptor()) {
-      auto rIn = static_cast<const char*>(in);
-      auto rOut= static_cast<char*>(out);
-      for(Long i(0); i < nitems; ++i) {
-        Real x;
-        float y;
-        std::memcpy(&x, rIn, sizeof(Real));
-        y = static_cast<float>(x);
-        std::memcpy(rOut, &y, sizeof(float));
-        rOut += sizeof(float);
-        rIn += sizeof(Real);
-      }
-    }
     else
     {
         PD_fconvert(out, in, nitems, boffs, ord.format(), ord.order(),
@@ -12,6 +12,7 @@
 #include <AMReX_BLProfiler.H>
 #include <AMReX_iMultiFab.H>
 #include <AMReX_FabArrayUtility.H>
+#include <AMReX_ExactSum.H>
 
 #ifdef AMREX_MEM_PROFILING
 #include <AMReX_MemProfiler.H>
@@ -26,10 +27,87 @@ namespace amrex {
 namespace
 {
     bool initialized = false;
+    //! Credit nreals Reals moved and nflops flops per local point (times
+    //! ncomp) touched by an operation to the current tiny profiler timer
+    void profile_work (const FabArrayBase& mf, const IntVect& nghost, int ncomp,
+                       int nreals, int nflops)
+    {
+#ifdef AMREX_TINY_PROFILING
+        double npts = 0.0;
+        for (int i : mf.IndexArray()) {
+            npts += static_cast<double>(amrex::grow(mf.box(i),nghost).numPts());
+        }
+        npts *= ncomp;
+        BL_PROFILE_WORK(nreals*sizeof(Real)*npts, nflops*npts);
+#else
+        amrex::ignore_unused(mf,nghost,ncomp,nreals,nflops);
+#endif
+    }
 #ifdef AMREX_MEM_PROFILING
     int num_multifabs     = 0;
     int num_multifabs_hwm = 0;
 #endif
+#ifndef AMREX_USE_GPU
+    /**
+    * Sum of f(K)(i,j,k,n) over ncomp components of the cells of boxes K of
+    * fa grown by nghost, for amrex.reproducible_sum.  The sums over the
+    * k-planes of the boxes are computed in a fixed order, and the box sums
+    * are added with ExactSum, so the result does not depend on the number
+    * of processes and threads or on the tile size.  With local, the result
+    * is the rounded local partial sum.  Partial sums must not be added
+    * together, because that would make the result depend on the number of
+    * processes again.
+    */
+    template <typename F>
+    Real reproducible_sum (const FabArrayBase& fa, int nghost, int ncomp, bool local, F const& f)
+    {
+        const Vector<int>& index = fa.IndexArray();
+        const int nlocal = index.size();
+        Vector<int> offset(nlocal+1, 0);
+        for (int li = 0; li < nlocal; ++li) {
+            const Box& bx = amrex::grow(fa.box(index[li]), nghost);
+            offset[li+1] = offset[li] + ncomp * (amrex::ubound(bx).z - amrex::lbound(bx).z + 1);
+        }
+
+        Vector<Real> plane_sum(offset[nlocal]);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int ip = 0; ip < offset[nlocal]; ++ip)
+        {
+            const int li = std::upper_bound(offset.begin(), offset.end(), ip) - offset.begin() - 1;
+            const Box& bx = amrex::grow(fa.box(index[li]), nghost);
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            const int nk = hi.z - lo.z + 1;
+            const int n = (ip - offset[li]) / nk;
+            const int k = lo.z + (ip - offset[li]) % nk;
+            const auto g = f(index[li]);
+            Real r = 0.0;
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                r += g(i,j,k,n);
+            }}
+            plane_sum[ip] = r;
+        }
+
+        // The box sums are added exactly, so that neither their order nor
+        // the distribution of the boxes matter, and the global reduction is
+        // of the fixed size accumulator instead of a vector of box sums.
+        ExactSum sm;
+        for (int li = 0; li < nlocal; ++li) {
+            Real r = 0.0;
+            for (int ip = offset[li]; ip < offset[li+1]; ++ip) {
+                r += plane_sum[ip];
+            }
+            sm.add(r);
+        }
+        if (!local) {
+            sm.ParallelAllReduce(ParallelContext::CommunicatorSub());
+        }
+        return static_cast<Real>(sm.value());
+    }
+#endif
 }
 
 Real
@@ -42,6 +120,32 @@ MultiFab::Dot (const MultiFab& x, int xcomp,
     BL_ASSERT(x.nGrow() >= nghost and y.nGrow() >= nghost);
 
     BL_PROFILE("MultiFab::Dot()");
+    profile_work(x, IntVect(nghost), numcomp, 2, 2);
+
+#ifndef AMREX_USE_GPU
+    if (system::reproducible_sum) {
+        return reproducible_sum(x, nghost, numcomp, local, [&] (int K) {
+            auto const& xfab = x.const_array(K);
+            auto const& yfab = y.const_array(K);
+            return [=] (int i, int j, int k, int n) {
+                return xfab(i,j,k,xcomp+n) * yfab(i,j,k,ycomp+n);
+            };
+        });
+    }
+#endif
+
+    if (Gpu::notInLaunchRegion() && xcomp == 0 && ycomp == 0 && numcomp == x.nComp()
+        && IntVect(nghost) == x.nGrowVect() && x.sameSlabLayout(y))
+    {
+        Real const* xp = x.slabData();
+        Real const* yp = y.slabData();
+        Real sm = detail::SlabReduceSum<Real>(x.slabSize(), [=] (Long i) noexcept
+        {
+            return xp[i]*yp[i];
+        });
+        if (!local) ParallelAllReduce::Sum(sm, ParallelContext::CommunicatorSub());
+        return sm;
+    }
 
     Real sm = amrex::ReduceSum(x, y, nghost,
     [=] AMREX_GPU_HOST_DEVICE (Box const& bx, Array4<Real const> const& xfab, Array4<Real const> const& yfab) -> Real
@@ -64,6 +168,30 @@ MultiFab::Dot (const MultiFab& x, int xcomp, int numcomp, int nghost, bool local
 {
     BL_ASSERT(x.nGrow() >= nghost); 
 
+#ifndef AMREX_USE_GPU
+    if (system::reproducible_sum) {
+        return reproducible_sum(x, nghost, numcomp, local, [&] (int K) {
+            auto const& xfab = x.const_array(K);
+            return [=] (int i, int j, int k, int n) {
+                Real tmp = xfab(i,j,k,xcomp+n);
+                return tmp*tmp;
+            };
+        });
+    }
+#endif
+
+    if (Gpu::notInLaunchRegion() && xcomp == 0 && numcomp == x.nComp()
+        && IntVect(nghost) == x.nGrowVect() && x.isContiguous())
+    {
+        Real const* xp = x.slabData();
+        Real sm = detail::SlabReduceSum<Real>(x.slabSize(), [=] (Long i) noexcept
+        {
+            return xp[i]*xp[i];
+        });
+        if (!local) ParallelAllReduce::Sum(sm, ParallelContext::CommunicatorSub());
+        return sm;
+    }
+
     Real sm = amrex::ReduceSum(x, nghost,
     [=] AMREX_GPU_HOST_DEVICE (Box const& bx, Array4<Real const> const& xfab) -> Real
     {
@@ -95,6 +223,20 @@ MultiFab::Dot (const iMultiFab& mask,
     BL_ASSERT(x.nGrow() >= nghost and y.nGrow() >= nghost);
     BL_ASSERT(mask.nGrow() >= nghost);
 
+#ifndef AMREX_USE_GPU
+    if (system::reproducible_sum) {
+        return reproducible_sum(x, nghost, numcomp, local, [&] (int K) {
+            auto const& xfab = x.const_array(K);
+            auto const& yfab = y.const_array(K);
+            auto const& mskfab = mask.const_array(K);
+            return [=] (int i, int j, int k, int n) {
+                int mi = static_cast<int>(static_cast<bool>(mskfab(i,j,k)));
+                return xfab(i,j,k,xcomp+n) * yfab(i,j,k,ycomp+n) * mi;
+            };
+        });
+    }
+#endif
+
     Real sm = amrex::ReduceSum(x, y, mask, nghost,
     [=] AMREX_GPU_HOST_DEVICE (Box const& bx, Array4<Real const> const& xfab,
                                Array4<Real const> const& yfab,
@@ -287,6 +429,19 @@ MultiFab::Saxpy (MultiFab& dst, Real a, const MultiFab& src,
     BL_ASSERT(dst.nGrowVect().allGE(nghost) and src.nGrowVect().allGE(nghost));
 
     BL_PROFILE("MultiFab::Saxpy()");
+    profile_work(dst, nghost, numcomp, 3, 2);
+
+    if (srccomp == 0 && dstcomp == 0 && numcomp == dst.nComp() && nghost == dst.nGrowVect()
+        && dst.sameSlabLayout(src))
+    {
+        Real const* s = src.slabData();
+        Real      * d = dst.slabData();
+        detail::SlabFor(dst.slabSize(), [=] AMREX_GPU_HOST_DEVICE (Long i) noexcept
+        {
+            d[i] += a * s[i];
+        });
+        return;
+    }
 
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
@@ -322,6 +477,19 @@ MultiFab::Xpay (MultiFab& dst, Real a, const MultiFab& src,
     BL_ASSERT(dst.nGrowVect().allGE(nghost) and src.nGrowVect().allGE(nghost));
 
     BL_PROFILE("MultiFab::Xpay()");
+    profile_work(dst, nghost, numcomp, 3, 2);
+
+    if (srccomp == 0 && dstcomp == 0 && numcomp == dst.nComp() && nghost == dst.nGrowVect()
+        && dst.sameSlabLayout(src))
+    {
+        Real const* s = src.slabData();
+        Real      * d = dst.slabData();
+        detail::SlabFor(dst.slabSize(), [=] AMREX_GPU_HOST_DEVICE (Long i) noexcept
+        {
+            d[i] = s[i] + a * d[i];
+        });
+        return;
+    }
 
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
@@ -362,6 +530,20 @@ MultiFab::LinComb (MultiFab& dst,
     BL_ASSERT(dst.nGrowVect().allGE(nghost) and x.nGrowVect().allGE(nghost) and y.nGrowVect().allGE(nghost));
 
     BL_PROFILE("MultiFab::LinComb()");
+    profile_work(dst, nghost, numcomp, 3, 3);
+
+    if (xcomp == 0 && ycomp == 0 && dstcomp == 0 && numcomp == dst.nComp()
+        && nghost == dst.nGrowVect() && dst.sameSlabLayout(x) && dst.sameSlabLayout(y))
+    {
+        Real const* xp = x.slabData();
+        Real const* yp = y.slabData();
+        Real      * d = dst.slabData();
+        detail::SlabFor(dst.slabSize(), [=] AMREX_GPU_HOST_DEVICE (Long i) noexcept
+        {
+            d[i] = a*xp[i] + b*yp[i];
+        });
+        return;
+    }
 
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
@@ -404,6 +586,7 @@ MultiFab::AddProduct (MultiFab& dst,
     BL_ASSERT(dst.nGrowVect().allGE(nghost) and src1.nGrowVect().allGE(nghost) and src2.nGrowVect().allGE(nghost));
 
     BL_PROFILE("MultiFab::AddProduct()");
+    profile_work(dst, nghost, numcomp, 4, 2);
 
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
@@ -956,6 +1139,20 @@ MultiFab::norm2 (int comp, const Periodicity& period) const
 {
     auto mask = OverlapMask(period);
 
+#ifndef AMREX_USE_GPU
+    if (system::reproducible_sum) {
+        Real nm2 = reproducible_sum(*this, 0, 1, false, [&] (int K) {
+            auto const& xfab = this->const_array(K);
+            auto const& mfab = mask->const_array(K);
+            return [=] (int i, int j, int k, int) {
+                Real tmp = xfab(i,j,k,comp);
+                return tmp*tmp/mfab(i,j,k);
+            };
+        });
+        return std::sqrt(nm2);
+    }
+#endif
+
     Real nm2 = amrex::ReduceSum(*this, *mask, 0,
     [=] AMREX_GPU_HOST_DEVICE (Box const& bx, Array4<Real const> const& xfab,
                                Array4<Real const> const& mfab) -> Real
@@ -1013,6 +1210,17 @@ MultiFab::norm1 (int comp, const Periodicity& period, bool ignore_covered ) cons
 Real
 MultiFab::norm1 (int comp, int ngrow, bool local) const
 {
+#ifndef AMREX_USE_GPU
+    if (system::reproducible_sum) {
+        return reproducible_sum(*this, ngrow, 1, local, [&] (int K) {
+            auto const& fab = this->const_array(K);
+            return [=] (int i, int j, int k, int) {
+                return amrex::Math::abs(fab(i,j,k,comp));
+            };
+        });
+    }
+#endif
+
     Real nm1 = amrex::ReduceSum(*this, ngrow,
     [=] AMREX_GPU_HOST_DEVICE (Box const& bx, Array4<Real const> const& fab) -> Real
     {
@@ -1052,6 +1260,15 @@ MultiFab::norm1 (const Vector<int>& comps, int ngrow, bool local) const
 Real
 MultiFab::sum (int comp, bool local) const
 {
+#ifndef AMREX_USE_GPU
+    if (system::reproducible_sum) {
+        return reproducible_sum(*this, 0, 1, local, [&] (int K) {
+            auto const& fab = this->const_array(K);
+            return [=] (int i, int j, int k, int) { return fab(i,j,k,comp); };
+        });
+    }
+#endif
+
     // 0 ghost cells
     Real sm = amrex::ReduceSum(*this, 0,
     [=] AMREX_GPU_HOST_DEVICE (Box const& bx, Array4<Real const> const& fab) -> Real
@@ -0,0 +1,164 @@
+
+#include <AMReX_PerfCounters.H>
+#include <AMReX_OpenMP.H>
+
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#include <cstdint>
+#endif
+
+namespace amrex {
+namespace PerfCounters {
+
+namespace {
+    bool s_available = false;
+#if defined(__linux__)
+    constexpr int nevents = 3;
+
+    // The counters of one thread.  The group leader is fd[0].
+    struct Group
+    {
+        int fd[nevents] = {-1, -1, -1};
+        // position of each event in the group read buffer, -1 if not opened.
+        int pos[nevents] = {-1, -1, -1};
+        int nopen = 0;
+    };
+
+    // One group per OpenMP thread, opened by that thread
+    std::vector<Group> s_groups;
+    // Is the event open for every thread?
+    bool s_has_event[nevents] = {false, false, false};
+
+    int open_counter (std::uint32_t type, std::uint64_t config, int group_fd) noexcept
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = (group_fd == -1) ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+    }
+
+    // Opens the counters of the calling thread
+    bool open_group (Group& g) noexcept
+    {
+        const std::uint64_t llc_miss = PERF_COUNT_HW_CACHE_LL
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+        g.fd[0] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (g.fd[0] < 0) return false;
+        g.pos[0] = g.nopen++;
+
+        g.fd[1] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, g.fd[0]);
+        if (g.fd[1] >= 0) g.pos[1] = g.nopen++;
+
+        g.fd[2] = open_counter(PERF_TYPE_HW_CACHE, llc_miss, g.fd[0]);
+        if (g.fd[2] >= 0) g.pos[2] = g.nopen++;
+
+        ioctl(g.fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        return ioctl(g.fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) == 0;
+    }
+#endif
+}
+
+bool
+Initialize () noexcept
+{
+#if defined(__linux__)
+    if (s_available) return true;
+
+    // A counter only counts the thread that opened it, so every thread of
+    // the OpenMP team opens its own group.  The file descriptors belong to
+    // the process, and the master thread reads all of them.
+    const int nthreads = OpenMP::get_max_threads();
+    s_groups.resize(nthreads);
+    int nfailed = 0;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads) reduction(+:nfailed)
+#endif
+    {
+        if (!open_group(s_groups[OpenMP::get_thread_num()])) ++nfailed;
+    }
+    if (nfailed > 0) {
+        Finalize();
+        return false;
+    }
+
+    for (int i = 0; i < nevents; ++i) {
+        s_has_event[i] = true;
+        for (auto const& g : s_groups) {
+            if (g.pos[i] < 0) s_has_event[i] = false;
+        }
+    }
+
+    s_available = true;
+#endif
+    return s_available;
+}
+
+void
+Finalize () noexcept
+{
+#if defined(__linux__)
+    for (auto& g : s_groups) {
+        for (int i = nevents-1; i >= 0; --i) {
+            if (g.fd[i] >= 0) close(g.fd[i]);
+        }
+    }
+    s_groups.clear();
+    for (int i = 0; i < nevents; ++i) {
+        s_has_event[i] = false;
+    }
+#endif
+    s_available = false;
+}
+
+int
+NumThreads () noexcept
+{
+#if defined(__linux__)
+    return static_cast<int>(s_groups.size());
+#else
+    return 0;
+#endif
+}
+
+bool
+Available () noexcept
+{
+    return s_available;
+}
+
+void
+Read (Counts& c) noexcept
+{
+    c = Counts{};
+#if defined(__linux__)
+    if (!s_available) return;
+
+    for (auto const& g : s_groups)
+    {
+        // PERF_FORMAT_GROUP layout: { u64 nr; u64 values[nr]; }
+        std::uint64_t buf[1+nevents];
+        const ssize_t nbytes = static_cast<ssize_t>((1+g.nopen)*sizeof(std::uint64_t));
+        if (read(g.fd[0], buf, nbytes) != nbytes) continue;
+
+        if (s_has_event[0]) c.cycles       += static_cast<Long>(buf[1+g.pos[0]]);
+        if (s_has_event[1]) c.instructions += static_cast<Long>(buf[1+g.pos[1]]);
+        if (s_has_event[2]) c.llc_misses   += static_cast<Long>(buf[1+g.pos[2]]);
+    }
+#endif
+}
+
+}}
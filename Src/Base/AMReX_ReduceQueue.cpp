@@ -0,0 +1,183 @@
+
+#include <AMReX_ReduceQueue.H>
+#include <AMReX_BLProfiler.H>
+#include <AMReX.H>
+
+#include <algorithm>
+
+namespace amrex {
+
+namespace {
+
+    std::unique_ptr<ReduceQueue> global_queue;
+
+#ifdef BL_USE_MPI
+    MPI_Datatype mpi_item_type = MPI_DATATYPE_NULL;
+    MPI_Op mpi_item_op = MPI_OP_NULL;
+
+    template <typename T>
+    inline void reduce_value (int op, T const& in, T& inout) noexcept
+    {
+        switch (static_cast<ReduceQueue::Op>(op)) {
+        case ReduceQueue::Op::Sum: inout += in;                    break;
+        case ReduceQueue::Op::Min: inout = std::min(inout, in);    break;
+        case ReduceQueue::Op::Max: inout = std::max(inout, in);    break;
+        }
+    }
+#endif
+}
+
+#ifdef BL_USE_MPI
+extern "C" {
+    // All processes have the same op and type for each item, so the
+    // reduction of items is elementwise.
+    static void amrex_reduce_queue_items (void* invec, void* inoutvec, int* len, MPI_Datatype*)
+    {
+        auto in = static_cast<ReduceQueue::Item const*>(invec);
+        auto inout = static_cast<ReduceQueue::Item*>(inoutvec);
+        for (int i = 0; i < *len; ++i) {
+            const int op = inout[i].op;
+            switch (inout[i].type) {
+            case 0: reduce_value(op, in[i].v.d, inout[i].v.d); break;
+            case 1: reduce_value(op, in[i].v.f, inout[i].v.f); break;
+            case 2: reduce_value(op, in[i].v.i, inout[i].v.i); break;
+            default: reduce_value(op, in[i].v.l, inout[i].v.l);
+            }
+        }
+    }
+}
+
+namespace {
+
+    void free_mpi_types ()
+    {
+        if (mpi_item_op != MPI_OP_NULL) {
+            MPI_Op_free(&mpi_item_op);
+        }
+        if (mpi_item_type != MPI_DATATYPE_NULL) {
+            MPI_Type_free(&mpi_item_type);
+        }
+    }
+
+    void init_mpi_types ()
+    {
+        if (mpi_item_type == MPI_DATATYPE_NULL) {
+            BL_MPI_REQUIRE( MPI_Type_contiguous(sizeof(ReduceQueue::Item), MPI_BYTE,
+                                                &mpi_item_type) );
+            BL_MPI_REQUIRE( MPI_Type_commit(&mpi_item_type) );
+            BL_MPI_REQUIRE( MPI_Op_create(amrex_reduce_queue_items, 1, &mpi_item_op) );
+            amrex::ExecOnFinalize(free_mpi_types);
+        }
+    }
+}
+#endif
+
+ReduceQueue::Batch::~Batch ()
+{
+    if (m_started) wait();
+}
+
+void
+ReduceQueue::Batch::start ()
+{
+    if (m_started) return;
+    m_started = true;
+
+#ifdef BL_USE_MPI
+    int nprocs;
+    MPI_Comm_size(m_comm, &nprocs);
+    if (nprocs > 1) {
+        init_mpi_types();
+        m_result.resize(m_items.size());
+#if defined(MPI_VERSION) && (MPI_VERSION >= 3)
+        BL_MPI_REQUIRE( MPI_Iallreduce(m_items.data(), m_result.data(), m_items.size(),
+                                       mpi_item_type, mpi_item_op, m_comm, &m_request) );
+#else
+        BL_MPI_REQUIRE( MPI_Allreduce(m_items.data(), m_result.data(), m_items.size(),
+                                      mpi_item_type, mpi_item_op, m_comm) );
+        m_done = true;
+#endif
+        return;
+    }
+#endif
+
+    m_result = m_items;
+    m_done = true;
+}
+
+void
+ReduceQueue::Batch::wait ()
+{
+    if (m_done) return;
+    if (!m_started) start();
+#ifdef BL_USE_MPI
+    if (!m_done) {
+        BL_PROFILE("ReduceQueue::Wait()");
+        BL_MPI_REQUIRE( MPI_Wait(&m_request, MPI_STATUS_IGNORE) );
+    }
+#endif
+    m_done = true;
+}
+
+bool
+ReduceQueue::Batch::test ()
+{
+#ifdef BL_USE_MPI
+    if (m_started && !m_done) {
+        int flag;
+        BL_MPI_REQUIRE( MPI_Test(&m_request, &flag, MPI_STATUS_IGNORE) );
+        m_done = flag;
+    }
+#endif
+    return m_done;
+}
+
+ReduceQueue::ReduceQueue (MPI_Comm comm, int max_batch_size)
+    : m_comm(comm),
+      m_max_batch_size(std::max(max_batch_size,1))
+{}
+
+ReduceQueue::~ReduceQueue ()
+{
+    for (auto& b : m_in_flight) {
+        b->wait();
+    }
+}
+
+void
+ReduceQueue::Flush ()
+{
+    // Remove the batches that are done
+    m_in_flight.erase(std::remove_if(m_in_flight.begin(), m_in_flight.end(),
+                                     [] (std::shared_ptr<Batch> const& b) { return b->test(); }),
+                      m_in_flight.end());
+
+    if (m_pending && !m_pending->started()) {
+        BL_PROFILE("ReduceQueue::Flush()");
+        m_pending->start();
+        m_in_flight.push_back(m_pending);
+    }
+    m_pending.reset();
+}
+
+void
+ReduceQueue::Wait ()
+{
+    Flush();
+    for (auto& b : m_in_flight) {
+        b->wait();
+    }
+    m_in_flight.clear();
+}
+
+ReduceQueue&
+ReduceQueue::Global ()
+{
+    if (!global_queue) {
+        global_queue.reset(new ReduceQueue(ParallelDescriptor::Communicator()));
+        amrex::ExecOnFinalize([] () { global_queue.reset(); });
+    }
+    return *global_queue;
+}
+
+}
@@ -12,6 +12,7 @@
 #include <AMReX_ParallelReduce.H>
 #include <AMReX_Utility.H>
 #include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
 
 #ifdef AMREX_USE_CUPTI
 #include <AMReX_CuptiTrace.H>
@@ -26,9 +27,10 @@
 namespace amrex {
 
 std::vector<std::string>          TinyProfiler::regionstack;
-std::deque<std::tuple<double,double,std::string*> > TinyProfiler::ttstack;
+std::deque<TinyProfiler::TimerInfo> TinyProfiler::ttstack;
 std::map<std::string,std::map<std::string, TinyProfiler::Stats> > TinyProfiler::statsmap;
 double TinyProfiler::t_init = std::numeric_limits<double>::max();
+bool TinyProfiler::use_perf_counters = false;
 
 namespace {
     std::set<std::string> improperly_nested_timers;
@@ -84,8 +86,11 @@ TinyProfiler::start () noexcept
 #endif
 	}
 
-	ttstack.emplace_back(std::make_tuple(t, 0.0, &fname));
+	ttstack.emplace_back(t, &fname);
 	global_depth = ttstack.size();
+        if (use_perf_counters) {
+            PerfCounters::Read(ttstack.back().hw0);
+        }
 
 #ifdef AMREX_USE_CUDA
 	nvtxRangePush(fname.c_str());
@@ -128,26 +133,33 @@ TinyProfiler::stop () noexcept
 
 	if (static_cast<int>(ttstack.size()) == global_depth)
 	{
-	    const std::tuple<double,double,std::string*>& tt = ttstack.back();
+	    const TimerInfo& tt = ttstack.back();
 
-	    // first: wall time when the pair is pushed into the stack
-	    // second: accumulated dt of children
 	    double dtin;
 	    double dtex;
 	    if (!uCUPTI) {
-	        dtin = t - std::get<0>(tt); // elapsed time since start() is called.
-	        dtex = dtin - std::get<1>(tt);
+	        dtin = t - tt.t0; // elapsed time since start() is called.
+	        dtex = dtin - tt.dtchild;
 	    } else {
 	        dtin = t;
-	        dtex = dtin - std::get<1>(tt); 
+	        dtex = dtin - tt.dtchild;
 	    }
 
+            PerfCounters::Counts hw;
+            if (use_perf_counters) {
+                PerfCounters::Read(hw);
+                hw -= tt.hw0;
+            }
+
         for (Stats* st : stats)
         {
             --(st->depth);
             ++(st->n);
             if (st->depth == 0) {
                 st->dtin += dtin;
+                st->bytes += tt.bytes;
+                st->flops += tt.flops;
+                st->hw += hw;
             }
             st->dtex += dtex;
             st->usesCUPTI = uCUPTI;
@@ -156,10 +168,14 @@ TinyProfiler::stop () noexcept
             }
         }
 
+        const double bytes = tt.bytes;
+        const double flops = tt.flops;
         ttstack.pop_back();
         if (!ttstack.empty()) {
-            std::tuple<double,double,std::string*>& parent = ttstack.back();
-            std::get<1>(parent) += dtin;
+            TimerInfo& parent = ttstack.back();
+            parent.dtchild += dtin;
+            parent.bytes += bytes;
+            parent.flops += flops;
         }
 
 #ifdef AMREX_USE_CUDA
@@ -200,15 +216,13 @@ TinyProfiler::stop (unsigned boxUintID) noexcept
 
         if (static_cast<int>(ttstack.size()) == global_depth)
         {
-            const std::tuple<double,double,std::string*>& tt = ttstack.back();
+            const TimerInfo& tt = ttstack.back();
 
-            // first: wall time when the pair is pushed into the stack
-            // second: accumulated dt of children
             double dtin;
             double dtex;
 
             dtin = t;
-            dtex = dtin - std::get<1>(tt); 
+            dtex = dtin - tt.dtchild;
 
             for (Stats* st : stats)
             {
@@ -217,17 +231,23 @@ TinyProfiler::stop (unsigned boxUintID) noexcept
                 if (st->depth == 0) 
                 {
                     st->dtin += dtin;
+                    st->bytes += tt.bytes;
+                    st->flops += tt.flops;
                 }
                 st->dtex += dtex;
                 st->usesCUPTI = uCUPTI;
                 st->nk += nKernelCalls;		
             }
 
+            const double bytes = tt.bytes;
+            const double flops = tt.flops;
             ttstack.pop_back();
             if (!ttstack.empty()) 
             {
-                std::tuple<double,double,std::string*>& parent = ttstack.back();
-                std::get<1>(parent) += dtin;
+                TimerInfo& parent = ttstack.back();
+                parent.dtchild += dtin;
+                parent.bytes += bytes;
+                parent.flops += flops;
             }
 
 #ifdef AMREX_USE_CUDA
@@ -248,6 +268,18 @@ TinyProfiler::Initialize () noexcept
 {
     regionstack.push_back(mainregion);
     t_init = amrex::second();
+
+    {
+        ParmParse pp("tiny_profiler");
+        int perf_counters = 0;
+        pp.query("perf_counters", perf_counters);
+        if (perf_counters) {
+            use_perf_counters = PerfCounters::Initialize();
+            if (!use_perf_counters && ParallelDescriptor::IOProcessor()) {
+                amrex::Print() << "TinyProfiler: hardware counters are not available on this system\n";
+            }
+        }
+    }
 }
 
 void
@@ -329,13 +361,20 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
     }
 
     PrintStats(lstatsmap[mainregion], dt_max);
+    PrintRoofline(lstatsmap[mainregion]);
     for (auto& kv : lstatsmap) {
         if (kv.first != mainregion) {
             amrex::Print() << "\n\nBEGIN REGION " << kv.first << "\n";
             PrintStats(kv.second, dt_max);
+            PrintRoofline(kv.second);
             amrex::Print() << "END REGION " << kv.first << "\n";
         }
     }
+
+    if (!bFlushing) {
+        PerfCounters::Finalize();
+        use_perf_counters = false;
+    }
 }
 
 void
@@ -535,6 +574,119 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
     }
 }
 
+void
+TinyProfiler::PrintRoofline (std::map<std::string,Stats>& regstats)
+{
+    // PrintStats has already made sure that the set of profiled functions
+    // is the same on all processes.
+
+    bool has_hw = use_perf_counters;
+    ParallelDescriptor::ReduceBoolAnd(has_hw);
+
+    bool has_work = false;
+    for (auto const& kv : regstats) {
+        if (kv.second.bytes > 0.0 || kv.second.flops > 0.0) {
+            has_work = true;
+            break;
+        }
+    }
+    ParallelDescriptor::ReduceBoolOr(has_work);
+
+    if (!has_work && !has_hw) return;
+
+    int ioproc = ParallelDescriptor::IOProcessorNumber();
+
+    struct RooflineStats
+    {
+        std::string fname;
+        double dtinmax, bytes, flops, cycles, instructions, llc_misses;
+    };
+    std::vector<RooflineStats> allstats;
+    int maxfnamelen = 0;
+
+    for (auto const& kv : regstats)
+    {
+        const Stats& st = kv.second;
+        double dtinmax = st.dtin;
+        double sums[5] = {st.bytes, st.flops, static_cast<double>(st.hw.cycles),
+                          static_cast<double>(st.hw.instructions),
+                          static_cast<double>(st.hw.llc_misses)};
+        ParallelReduce::Max(dtinmax, ioproc, ParallelDescriptor::Communicator());
+        ParallelReduce::Sum(sums, 5, ioproc, ParallelDescriptor::Communicator());
+
+        if (ParallelDescriptor::IOProcessor()) {
+            // Without hardware counters, only report annotated timers.
+            if (has_hw || sums[0] > 0.0 || sums[1] > 0.0) {
+                allstats.push_back({kv.first, dtinmax, sums[0], sums[1],
+                                    sums[2], sums[3], sums[4]});
+                maxfnamelen = std::max(maxfnamelen, int(kv.first.size()));
+            }
+        }
+    }
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::sort(allstats.begin(), allstats.end(),
+                  [] (const RooflineStats& lhs, const RooflineStats& rhs)
+                  { return lhs.dtinmax > rhs.dtinmax; });
+
+        auto& os = amrex::OutStream();
+        const int w = 11;
+        const int ncols = has_hw ? 8 : 6;
+        const std::string hline(maxfnamelen+(w+2)*ncols,'-');
+
+        os << "\n" << hline << "\n";
+        os << std::left << std::setw(maxfnamelen) << "Name" << std::right
+           << std::setw(w+2) << "Incl. Max"
+           << std::setw(w+2) << "GBytes"
+           << std::setw(w+2) << "GFlops"
+           << std::setw(w+2) << "GB/s"
+           << std::setw(w+2) << "GFlop/s"
+           << std::setw(w+2) << "Flops/Byte";
+        if (has_hw) {
+            os << std::setw(w+2) << "IPC"
+               << std::setw(w+2) << "LLC Misses";
+        }
+        os << "\n" << hline << "\n";
+
+        for (auto const& r : allstats)
+        {
+            const double dt = (r.dtinmax > 0.0) ? r.dtinmax : 1.0;
+            os << std::setprecision(4) << std::left
+               << std::setw(maxfnamelen) << r.fname << std::right
+               << std::setw(w+2) << r.dtinmax
+               << std::setw(w+2) << r.bytes*1.e-9
+               << std::setw(w+2) << r.flops*1.e-9
+               << std::setw(w+2) << r.bytes*1.e-9/dt
+               << std::setw(w+2) << r.flops*1.e-9/dt
+               << std::setw(w+2) << ((r.bytes > 0.0) ? r.flops/r.bytes : 0.0);
+            if (has_hw) {
+                os << std::setw(w+2) << ((r.cycles > 0.0) ? r.instructions/r.cycles : 0.0)
+                   << std::setw(w+2) << r.llc_misses;
+            }
+            os << "\n";
+        }
+        os << hline << "\n";
+        if (has_hw) {
+            os << "IPC and LLC misses are summed over the " << PerfCounters::NumThreads()
+               << " OpenMP thread(s) of each process.\n";
+        }
+        os << std::endl;
+    }
+}
+
+void
+TinyProfiler::AddWork (double bytes, double flops) noexcept
+{
+#ifdef _OPENMP
+#pragma omp master
+#endif
+    if (!ttstack.empty()) {
+        ttstack.back().bytes += bytes;
+        ttstack.back().flops += flops;
+    }
+}
+
 void
 TinyProfiler::StartRegion (std::string regname) noexcept
 {
@@ -578,7 +730,7 @@ TinyProfiler::PrintCallStack (std::ostream& os)
 {
     os << "===== TinyProfilers ======\n";
     for (auto const& x : ttstack) {
-        os << *(std::get<2>(x)) << "\n";
+        os << *(x.fname) << "\n";
     }
 }
 
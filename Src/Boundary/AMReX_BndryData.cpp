@@ -28,6 +28,19 @@ BndryData::BndryData (const BoxArray& _grids,
     define(_grids,_dmap,_ncomp,_geom);
 }
 
+BndryData::BndryData (const BoxArray& _grids,
+		      const DistributionMapping& _dmap,
+                      int             _ncomp, 
+                      const Geometry& _geom,
+                      const Vector<MultiMask>& a_masks)
+    :
+    geom(_geom),
+    m_ncomp(_ncomp),
+    m_defined(false)
+{
+    define(_grids,_dmap,_ncomp,_geom,a_masks);
+}
+
 void
 BndryData::setBoundCond (Orientation     _face,
                          int              _n,
@@ -133,6 +146,42 @@ BndryData::define (const BoxArray& _grids,
 		   const DistributionMapping& _dmap,
                    int             _ncomp,
                    const Geometry& _geom)
+{
+    define(_grids, _dmap, _ncomp, _geom, nullptr);
+}
+
+void
+BndryData::define (const BoxArray& _grids,
+		   const DistributionMapping& _dmap,
+                   int             _ncomp,
+                   const Geometry& _geom,
+                   const Vector<MultiMask>& a_masks)
+{
+    define(_grids, _dmap, _ncomp, _geom, &a_masks);
+}
+
+Vector<MultiMask>
+BndryData::makeMasks (const BoxArray& _grids,
+                      const DistributionMapping& _dmap,
+                      const Geometry& _geom)
+{
+    BL_PROFILE("BndryData::makeMasks()");
+
+    Vector<MultiMask> r(2*AMREX_SPACEDIM);
+    for (OrientationIter fi; fi; ++fi)
+    {
+        Orientation face = fi();
+        r[face].define(_grids, _dmap, _geom, face, 0, 2, NTangHalfWidth, 1, true);
+    }
+    return r;
+}
+
+void
+BndryData::define (const BoxArray& _grids,
+		   const DistributionMapping& _dmap,
+                   int             _ncomp,
+                   const Geometry& _geom,
+                   const Vector<MultiMask>* a_masks)
 {
     BL_PROFILE("BndryData::define()");
 
@@ -160,7 +209,13 @@ BndryData::define (const BoxArray& _grids,
     {
         Orientation face = fi();
         BndryRegister::define(face,IndexType::TheCellType(),0,1,1,_ncomp,_dmap);
-	masks[face].define(grids, _dmap, geom, face, 0, 2, NTangHalfWidth, 1, true);
+        if (a_masks) {
+            AMREX_ASSERT((*a_masks)[face].boxArray() ==
+                         BoxArray(grids, BATransformer(face,IndexType::TheCellType(),0,2,NTangHalfWidth)));
+            masks[face].define((*a_masks)[face], amrex::make_alias, 0, 1);
+        } else {
+            masks[face].define(grids, _dmap, geom, face, 0, 2, NTangHalfWidth, 1, true);
+        }
     }
     //
     // Define "bcond" and "bcloc".
@@ -38,6 +38,15 @@ InterpBndryData::InterpBndryData (const BoxArray& _grids,
     BndryData(_grids,_dmap,_ncomp,_geom)
 {}
 
+InterpBndryData::InterpBndryData (const BoxArray& _grids,
+				  const DistributionMapping& _dmap,
+                                  int             _ncomp,
+                                  const Geometry& _geom,
+                                  const Vector<MultiMask>& a_masks)
+    :
+    BndryData(_grids,_dmap,_ncomp,_geom,a_masks)
+{}
+
 InterpBndryData::~InterpBndryData () {}
 
 void
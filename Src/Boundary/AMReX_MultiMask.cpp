@@ -14,6 +14,10 @@ MultiMask::MultiMask (const BoxArray& regba, const DistributionMapping& dm, cons
     define(regba, dm, geom, face, in_rad, out_rad, extent_rad, ncomp, initval);
 }
 
+MultiMask::MultiMask (const MultiMask& rhs, MakeType maketype, int scomp, int ncomp)
+    : m_fa(rhs.m_fa, maketype, scomp, ncomp)
+{ }
+
 void
 MultiMask::define (const BoxArray& ba, const DistributionMapping& dm, int ncomp)
 {
@@ -70,6 +74,13 @@ MultiMask::define (const BoxArray& regba, const DistributionMapping& dm, const G
     }
 }
 
+void
+MultiMask::define (const MultiMask& rhs, MakeType maketype, int scomp, int ncomp)
+{
+    BL_ASSERT(m_fa.size() == 0);
+    m_fa = FabArray<Mask>(rhs.m_fa, maketype, scomp, ncomp);
+}
+
 void 
 MultiMask::Copy (MultiMask& dst, const MultiMask& src)
 {
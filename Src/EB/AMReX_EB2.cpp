@@ -10,21 +10,33 @@
 #include <AMReX_EB2_GeometryShop.H>
 #include <AMReX_EB2.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_Utility.H>
 #include <AMReX.H>
 #include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
 
 namespace amrex { namespace EB2 {
 
 Vector<std::unique_ptr<IndexSpace> > IndexSpace::m_instance;
+int IndexSpace::m_next_id = 0;
 
 int max_grid_size = 64;
 bool extend_domain_face = true;
 
+namespace {
+    std::string chkpt_file;
+    const char* chkpt_file_version = "EB2_IndexSpace_ChkptFile_V2";
+}
+
 void Initialize ()
 {
     ParmParse pp("eb2");
     pp.query("max_grid_size", max_grid_size);
     pp.query("extend_domain_face", extend_domain_face);
+    pp.query("chkpt_file", chkpt_file);
 
     amrex::ExecOnFinalize(Finalize);
 }
@@ -39,6 +51,145 @@ bool ExtendDomainFace ()
     return extend_domain_face;
 }
 
+const std::string& ChkptFile ()
+{
+    return chkpt_file;
+}
+
+std::string
+HashString (const std::string& s)
+{
+    std::uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << h;
+    return os.str();
+}
+
+std::string
+ChkptFileHash (const std::string& dirname)
+{
+    const std::string hdrname = dirname + "/Header";
+    int exist = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        exist = amrex::FileExists(hdrname);
+    }
+    ParallelDescriptor::Bcast(&exist, 1, ParallelDescriptor::IOProcessorNumber());
+    if (!exist) return std::string();
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(hdrname, fileCharPtr);
+    std::istringstream is(fileCharPtr.dataPtr(), std::istringstream::in);
+
+    std::string version, hash;
+    is >> version >> hash;
+    if (version != chkpt_file_version) return std::string();
+    return hash;
+}
+
+void
+WriteChkptFile (const std::string& dirname, const std::string& hash,
+                const Vector<Level const*>& levels)
+{
+    BL_PROFILE("EB2::WriteChkptFile()");
+
+    const int nlevels = levels.size();
+    amrex::PreBuildDirectorHierarchy(dirname, "Level_", nlevels, true);
+
+    for (int ilev = 0; ilev < nlevels; ++ilev) {
+        levels[ilev]->writeChkptFile(amrex::LevelFullPath(ilev, dirname));
+    }
+
+    // The IndexSpace header is written last so that an incomplete
+    // directory is never considered valid.
+    ParallelDescriptor::Barrier();
+    if (ParallelDescriptor::IOProcessor())
+    {
+        const std::string hdrname = dirname + "/Header";
+        std::ofstream ofs(hdrname.c_str());
+        if (!ofs.good()) amrex::FileOpenFailed(hdrname);
+        ofs << chkpt_file_version << "\n"
+            << (hash.empty() ? std::string("none") : hash) << "\n"
+            << nlevels << "\n";
+        for (auto const* lev : levels) {
+            ofs << lev->Geom().Domain() << "\n";
+        }
+        ofs.flush();
+        if (!ofs.good()) amrex::Abort("EB2::WriteChkptFile: failed to write "+hdrname);
+    }
+    ParallelDescriptor::Barrier();
+}
+
+IndexSpaceChkptFile::IndexSpaceChkptFile (const std::string& dirname, const Geometry& geom)
+{
+    BL_PROFILE("EB2::IndexSpaceChkptFile()");
+
+    int nlevels;
+    Vector<Box> domains;
+    {
+        Vector<char> fileCharPtr;
+        ParallelDescriptor::ReadAndBcastFile(dirname+"/Header", fileCharPtr);
+        std::istringstream is(fileCharPtr.dataPtr(), std::istringstream::in);
+        std::string version, hash;
+        is >> version >> hash >> nlevels;
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(version == chkpt_file_version,
+                                         "EB2::IndexSpaceChkptFile: unknown file format in "+dirname);
+        domains.resize(nlevels);
+        for (auto& b : domains) {
+            is >> b;
+        }
+    }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nlevels > 0 && domains[0] == geom.Domain(),
+                                     "EB2::IndexSpaceChkptFile: domain does not match "+dirname);
+
+    m_chkptlevel.reserve(nlevels);
+    for (int ilev = 0; ilev < nlevels; ++ilev)
+    {
+        Geometry lgeom = (ilev == 0) ? geom : amrex::coarsen(m_geom.back(),2);
+        AMREX_ALWAYS_ASSERT(lgeom.Domain() == domains[ilev]);
+        m_chkptlevel.emplace_back(this, amrex::LevelFullPath(ilev, dirname), lgeom);
+        m_geom.push_back(lgeom);
+        m_domain.push_back(lgeom.Domain());
+    }
+}
+
+const Level&
+IndexSpaceChkptFile::getLevel (const Geometry& geom) const
+{
+    auto it = std::find(std::begin(m_domain), std::end(m_domain), geom.Domain());
+    int i = std::distance(m_domain.begin(), it);
+    return m_chkptlevel[i];
+}
+
+const Geometry&
+IndexSpaceChkptFile::getGeometry (const Box& dom) const
+{
+    auto it = std::find(std::begin(m_domain), std::end(m_domain), dom);
+    int i = std::distance(m_domain.begin(), it);
+    return m_geom[i];
+}
+
+void
+IndexSpaceChkptFile::writeChkptFile (const std::string& dirname, const std::string& hash) const
+{
+    Vector<Level const*> levels;
+    for (auto const& lev : m_chkptlevel) {
+        levels.push_back(&lev);
+    }
+    EB2::WriteChkptFile(dirname, hash, levels);
+}
+
+void
+BuildFromChkptFile (const std::string& dirname, const Geometry& geom)
+{
+    BL_PROFILE("EB2::BuildFromChkptFile()");
+    IndexSpace::push(new IndexSpaceChkptFile(dirname, geom));
+}
+
 void
 IndexSpace::push (IndexSpace* ispace)
 {
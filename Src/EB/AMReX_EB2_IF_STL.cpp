@@ -0,0 +1,582 @@
+
+#include <AMReX_EB2_IF_STL.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_BLProfiler.H>
+#include <AMReX.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+namespace amrex { namespace EB2 {
+
+namespace {
+
+    inline RealArray sub (const RealArray& a, const RealArray& b) noexcept
+    {
+        return RealArray{a[0]-b[0], a[1]-b[1], a[2]-b[2]};
+    }
+
+    inline Real dot (const RealArray& a, const RealArray& b) noexcept
+    {
+        return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+    }
+
+    inline RealArray cross (const RealArray& a, const RealArray& b) noexcept
+    {
+        return RealArray{a[1]*b[2]-a[2]*b[1], a[2]*b[0]-a[0]*b[2], a[0]*b[1]-a[1]*b[0]};
+    }
+
+    //! Squared distance from a point to a box.  It's zero if the point is inside.
+    inline Real box_dist2 (const RealArray& p, const RealArray& lo, const RealArray& hi) noexcept
+    {
+        Real r = 0.0;
+        for (int idim = 0; idim < 3; ++idim) {
+            Real d = amrex::max(lo[idim]-p[idim], Real(0.0), p[idim]-hi[idim]);
+            r += d*d;
+        }
+        return r;
+    }
+
+    /**
+    * \brief Closest point q on triangle abc to p (Ericson, Real-Time Collision
+    * Detection, 5.1.5).
+    *
+    * Returns the squared distance.  The feature containing q is returned
+    * in region: 0 for the face, 1, 2 and 3 for vertices a, b and c, and
+    * 4, 5 and 6 for edges ab, bc and ca.
+    */
+    Real triangle_closest (const RealArray& p, const RealArray& a, const RealArray& b,
+                           const RealArray& c, RealArray& q, int& region) noexcept
+    {
+        const RealArray ab = sub(b,a);
+        const RealArray ac = sub(c,a);
+        const RealArray ap = sub(p,a);
+        const Real d1 = dot(ab,ap);
+        const Real d2 = dot(ac,ap);
+        if (d1 <= 0.0 && d2 <= 0.0) {
+            q = a;
+            region = 1;
+        } else {
+            const RealArray bp = sub(p,b);
+            const Real d3 = dot(ab,bp);
+            const Real d4 = dot(ac,bp);
+            const RealArray cp = sub(p,c);
+            const Real d5 = dot(ab,cp);
+            const Real d6 = dot(ac,cp);
+            const Real vc = d1*d4 - d3*d2;
+            const Real vb = d5*d2 - d1*d6;
+            const Real va = d3*d6 - d5*d4;
+            if (d3 >= 0.0 && d4 <= d3) {
+                q = b;
+                region = 2;
+            } else if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+                const Real v = d1 / (d1-d3);
+                q = RealArray{a[0]+v*ab[0], a[1]+v*ab[1], a[2]+v*ab[2]};
+                region = 4;
+            } else if (d6 >= 0.0 && d5 <= d6) {
+                q = c;
+                region = 3;
+            } else if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+                const Real w = d2 / (d2-d6);
+                q = RealArray{a[0]+w*ac[0], a[1]+w*ac[1], a[2]+w*ac[2]};
+                region = 6;
+            } else if (va <= 0.0 && (d4-d3) >= 0.0 && (d5-d6) >= 0.0) {
+                const Real w = (d4-d3) / ((d4-d3) + (d5-d6));
+                q = RealArray{b[0]+w*(c[0]-b[0]), b[1]+w*(c[1]-b[1]), b[2]+w*(c[2]-b[2])};
+                region = 5;
+            } else {
+                const Real denom = 1.0 / (va+vb+vc);
+                const Real v = vb*denom;
+                const Real w = vc*denom;
+                q = RealArray{a[0]+ab[0]*v+ac[0]*w, a[1]+ab[1]*v+ac[1]*w, a[2]+ab[2]*v+ac[2]*w};
+                region = 0;
+            }
+        }
+        const RealArray pq = sub(p,q);
+        return dot(pq,pq);
+    }
+
+    //! Does the ray p+t*dir, t>0, cross triangle abc?  (Moller-Trumbore)
+    bool ray_crosses (const RealArray& p, const RealArray& dir, const RealArray& a,
+                      const RealArray& b, const RealArray& c) noexcept
+    {
+        const RealArray e1 = sub(b,a);
+        const RealArray e2 = sub(c,a);
+        const RealArray h = cross(dir,e2);
+        const Real det = dot(e1,h);
+        if (det == 0.0) return false;
+        const Real invdet = 1.0/det;
+        const RealArray s = sub(p,a);
+        const Real u = invdet*dot(s,h);
+        if (u < 0.0 || u > 1.0) return false;
+        const RealArray q = cross(s,e1);
+        const Real v = invdet*dot(dir,q);
+        if (v < 0.0 || u+v > 1.0) return false;
+        return invdet*dot(e2,q) > 0.0;
+    }
+
+    //! Does the ray p+t*dir, t>0, hit the box?  invdir is 1/dir.
+    bool ray_hits_box (const RealArray& p, const RealArray& invdir,
+                       const RealArray& lo, const RealArray& hi) noexcept
+    {
+        Real tmin = 0.0;
+        Real tmax = std::numeric_limits<Real>::max();
+        for (int idim = 0; idim < 3; ++idim) {
+            Real t1 = (lo[idim]-p[idim])*invdir[idim];
+            Real t2 = (hi[idim]-p[idim])*invdir[idim];
+            tmin = amrex::max(tmin, amrex::min(t1,t2));
+            tmax = amrex::min(tmax, amrex::max(t1,t2));
+        }
+        return tmin <= tmax;
+    }
+
+    // Rays used by the inside test for points far from the surface.  The
+    // directions are chosen so that they are unlikely to be aligned with the
+    // edges and vertices of CAD meshes.
+    constexpr int nrays = 3;
+    const RealArray ray_dir[nrays] = {{ 0.5773502691896258,  0.5773502691896258,  0.5773502691896258},
+                                      {-0.2672612419124244,  0.5345224838248488, -0.8017837257372732},
+                                      { 0.8728715609439694, -0.2182178902359924, -0.4364357804719848}};
+
+    //! Angle of triangle abc at vertex a
+    Real vertex_angle (const RealArray& a, const RealArray& b, const RealArray& c) noexcept
+    {
+        const RealArray ab = sub(b,a);
+        const RealArray ac = sub(c,a);
+        const RealArray n = cross(ab,ac);
+        return std::atan2(std::sqrt(dot(n,n)), dot(ab,ac));
+    }
+}
+
+TriangleBVH::TriangleBVH (Vector<Triangle>&& triangles)
+    : m_triangles(std::move(triangles))
+{
+    BL_PROFILE("TriangleBVH::TriangleBVH()");
+
+    const int ntri = m_triangles.size();
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ntri > 0, "TriangleBVH: no triangles");
+
+    Vector<RealArray> centroid(ntri);
+    Vector<int> perm(ntri);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < ntri; ++i) {
+        const Triangle& t = m_triangles[i];
+        for (int idim = 0; idim < 3; ++idim) {
+            centroid[i][idim] = (t.v0[idim]+t.v1[idim]+t.v2[idim]) * (1.0/3.0);
+        }
+        perm[i] = i;
+    }
+
+    m_nodes.resize(numNodes(ntri));
+
+#ifdef _OPENMP
+#pragma omp parallel
+#pragma omp single
+#endif
+    buildNode(0, 0, ntri, perm, centroid);
+
+    // Store the triangles in the order of the leaves.
+    Vector<Triangle> sorted(ntri);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < ntri; ++i) {
+        sorted[i] = m_triangles[perm[i]];
+    }
+    std::swap(m_triangles, sorted);
+
+    computePseudoNormals();
+}
+
+void
+TriangleBVH::computePseudoNormals ()
+{
+    BL_PROFILE("TriangleBVH::computePseudoNormals()");
+
+    const int ntri = m_triangles.size();
+    m_normals.resize(ntri);
+
+    auto vertex = [&] (int iv) -> RealArray const& {
+        const Triangle& t = m_triangles[iv/3];
+        const int k = iv%3;
+        return (k == 0) ? t.v0 : ((k == 1) ? t.v1 : t.v2);
+    };
+
+    // Weld the vertices of the triangle soup.
+    Vector<int> vperm(3*ntri);
+    for (int iv = 0; iv < 3*ntri; ++iv) vperm[iv] = iv;
+    std::sort(vperm.begin(), vperm.end(),
+              [&] (int a, int b) { return vertex(a) < vertex(b); });
+    Vector<int> vid(3*ntri);
+    int nverts = 0;
+    for (int i = 0; i < 3*ntri; ++i) {
+        if (i > 0 && vertex(vperm[i]) != vertex(vperm[i-1])) ++nverts;
+        vid[vperm[i]] = nverts;
+    }
+    ++nverts;
+
+    // Unit face normals and the orientation of the surface
+    Real volume = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:volume)
+#endif
+    for (int i = 0; i < ntri; ++i) {
+        const Triangle& t = m_triangles[i];
+        RealArray n = cross(sub(t.v1,t.v0), sub(t.v2,t.v0));
+        const Real area2 = std::sqrt(dot(n,n));
+        if (area2 > 0.0) {
+            for (auto& x : n) x /= area2;
+        }
+        m_normals[i][0] = n;
+        volume += dot(t.v0, cross(t.v1,t.v2));
+    }
+    // The normals point outward if the volume is positive.
+    const Real orientation = (volume < 0.0) ? -1.0 : 1.0;
+
+    // Angle weighted vertex normals
+    Vector<RealArray> vnormal(nverts, RealArray{0.,0.,0.});
+    for (int i = 0; i < ntri; ++i) {
+        const Triangle& t = m_triangles[i];
+        const Real angle[3] = {vertex_angle(t.v0,t.v1,t.v2),
+                               vertex_angle(t.v1,t.v2,t.v0),
+                               vertex_angle(t.v2,t.v0,t.v1)};
+        for (int k = 0; k < 3; ++k) {
+            RealArray& vn = vnormal[vid[3*i+k]];
+            for (int idim = 0; idim < 3; ++idim) {
+                vn[idim] += angle[k]*m_normals[i][0][idim];
+            }
+        }
+    }
+
+    // Edge normals are the sums of the normals of the adjacent faces.
+    Vector<std::pair<std::pair<int,int>,int> > edges(3*ntri);
+    for (int i = 0; i < ntri; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            const int va = vid[3*i+k];
+            const int vb = vid[3*i+(k+1)%3];
+            edges[3*i+k] = std::make_pair(std::make_pair(std::min(va,vb), std::max(va,vb)), 3*i+k);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (int ibegin = 0; ibegin < 3*ntri; ) {
+        int iend = ibegin+1;
+        while (iend < 3*ntri && edges[iend].first == edges[ibegin].first) ++iend;
+        RealArray en{0.,0.,0.};
+        for (int ie = ibegin; ie < iend; ++ie) {
+            const RealArray& fn = m_normals[edges[ie].second/3][0];
+            for (int idim = 0; idim < 3; ++idim) en[idim] += fn[idim];
+        }
+        for (int ie = ibegin; ie < iend; ++ie) {
+            const int i = edges[ie].second/3;
+            const int k = edges[ie].second%3;
+            m_normals[i][4+k] = en;
+        }
+        ibegin = iend;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < ntri; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            m_normals[i][1+k] = vnormal[vid[3*i+k]];
+        }
+        for (auto& n : m_normals[i]) {
+            for (auto& x : n) x *= orientation;
+        }
+    }
+}
+
+int
+TriangleBVH::numNodes (int ntri) noexcept
+{
+    if (ntri <= leaf_size) {
+        return 1;
+    } else {
+        const int nleft = ntri/2;
+        return 1 + numNodes(nleft) + numNodes(ntri-nleft);
+    }
+}
+
+void
+TriangleBVH::buildNode (int inode, int begin, int end, Vector<int>& perm,
+                        Vector<RealArray> const& centroid)
+{
+    Node& node = m_nodes[inode];
+    const int n = end - begin;
+
+    if (n <= leaf_size)
+    {
+        node.begin = begin;
+        node.end = end;
+        node.lo.fill(std::numeric_limits<Real>::max());
+        node.hi.fill(std::numeric_limits<Real>::lowest());
+        for (int i = begin; i < end; ++i) {
+            const Triangle& t = m_triangles[perm[i]];
+            for (int idim = 0; idim < 3; ++idim) {
+                node.lo[idim] = amrex::min(node.lo[idim], t.v0[idim], t.v1[idim], t.v2[idim]);
+                node.hi[idim] = amrex::max(node.hi[idim], t.v0[idim], t.v1[idim], t.v2[idim]);
+            }
+        }
+        return;
+    }
+
+    RealArray clo, chi;
+    clo.fill(std::numeric_limits<Real>::max());
+    chi.fill(std::numeric_limits<Real>::lowest());
+    for (int i = begin; i < end; ++i) {
+        for (int idim = 0; idim < 3; ++idim) {
+            clo[idim] = amrex::min(clo[idim], centroid[perm[i]][idim]);
+            chi[idim] = amrex::max(chi[idim], centroid[perm[i]][idim]);
+        }
+    }
+    int dir = 0;
+    if (chi[1]-clo[1] > chi[dir]-clo[dir]) dir = 1;
+    if (chi[2]-clo[2] > chi[dir]-clo[dir]) dir = 2;
+
+    const int mid = begin + n/2;
+    std::nth_element(perm.begin()+begin, perm.begin()+mid, perm.begin()+end,
+                     [&] (int a, int b) { return centroid[a][dir] < centroid[b][dir]; });
+
+    const int ileft = inode + 1;
+    const int iright = ileft + numNodes(n/2);
+    node.right = iright;
+
+    // Only spawn tasks for large subtrees.
+#ifdef _OPENMP
+#pragma omp task default(shared) if (n > 65536)
+#endif
+    buildNode(ileft, begin, mid, perm, centroid);
+    buildNode(iright, mid, end, perm, centroid);
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
+
+    for (int idim = 0; idim < 3; ++idim) {
+        node.lo[idim] = amrex::min(m_nodes[ileft].lo[idim], m_nodes[iright].lo[idim]);
+        node.hi[idim] = amrex::max(m_nodes[ileft].hi[idim], m_nodes[iright].hi[idim]);
+    }
+}
+
+Real
+TriangleBVH::closest (const RealArray& p, Real max_dist2, RealArray& q, int& itri,
+                      int& region) const noexcept
+{
+    Real best = max_dist2;
+    itri = -1;
+    int stack[max_depth];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const int inode = stack[--top];
+        const Node& node = m_nodes[inode];
+        if (box_dist2(p, node.lo, node.hi) >= best) continue;
+        if (node.right < 0) {
+            for (int i = node.begin; i < node.end; ++i) {
+                const Triangle& t = m_triangles[i];
+                RealArray qt;
+                int rt;
+                const Real d2 = triangle_closest(p, t.v0, t.v1, t.v2, qt, rt);
+                if (d2 < best) {
+                    best = d2;
+                    q = qt;
+                    itri = i;
+                    region = rt;
+                }
+            }
+        } else {
+            const int ileft = inode + 1;
+            const Real dl = box_dist2(p, m_nodes[ileft].lo, m_nodes[ileft].hi);
+            const Real dr = box_dist2(p, m_nodes[node.right].lo, m_nodes[node.right].hi);
+            // Push the farther child first so that the nearer one is visited first.
+            if (dl < dr) {
+                if (dr < best) stack[top++] = node.right;
+                if (dl < best) stack[top++] = ileft;
+            } else {
+                if (dl < best) stack[top++] = ileft;
+                if (dr < best) stack[top++] = node.right;
+            }
+        }
+    }
+    return best;
+}
+
+Real
+TriangleBVH::distance (const RealArray& p) const noexcept
+{
+    RealArray q;
+    int itri, region;
+    return std::sqrt(closest(p, std::numeric_limits<Real>::max(), q, itri, region));
+}
+
+Real
+TriangleBVH::signedDistance (const RealArray& p, Real max_distance) const noexcept
+{
+    RealArray q;
+    int itri, region;
+    const Real max_dist2 = (max_distance < std::sqrt(std::numeric_limits<Real>::max()))
+        ? max_distance*max_distance : std::numeric_limits<Real>::max();
+    const Real d2 = closest(p, max_dist2, q, itri, region);
+    if (itri < 0) {
+        return isInsideByRays(p) ? -max_distance : max_distance;
+    } else if (d2 == 0.0) {
+        return 0.0;
+    } else {
+        const RealArray& n = m_normals[itri][region];
+        return (dot(sub(p,q), n) < 0.0) ? -std::sqrt(d2) : std::sqrt(d2);
+    }
+}
+
+bool
+TriangleBVH::isInside (const RealArray& p) const noexcept
+{
+    return signedDistance(p) < 0.0;
+}
+
+int
+TriangleBVH::countCrossings (const RealArray& p, const RealArray& dir) const noexcept
+{
+    const RealArray invdir{1.0/dir[0], 1.0/dir[1], 1.0/dir[2]};
+    int ncross = 0;
+    int stack[max_depth];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const int inode = stack[--top];
+        const Node& node = m_nodes[inode];
+        if (!ray_hits_box(p, invdir, node.lo, node.hi)) continue;
+        if (node.right < 0) {
+            for (int i = node.begin; i < node.end; ++i) {
+                const Triangle& t = m_triangles[i];
+                if (ray_crosses(p, dir, t.v0, t.v1, t.v2)) ++ncross;
+            }
+        } else {
+            stack[top++] = node.right;
+            stack[top++] = inode+1;
+        }
+    }
+    return ncross;
+}
+
+bool
+TriangleBVH::isInsideByRays (const RealArray& p) const noexcept
+{
+    if (box_dist2(p, boxLo(), boxHi()) > 0.0) return false;
+
+    // Majority vote of several rays to be robust against rays going
+    // through edges and vertices.
+    int ninside = 0;
+    for (int iray = 0; iray < nrays; ++iray) {
+        if (countCrossings(p, ray_dir[iray]) % 2 == 1) ++ninside;
+        if (ninside*2 > nrays) return true;
+        if ((iray+1-ninside)*2 > nrays) return false;
+    }
+    return false;
+}
+
+STLIF::STLIF (const std::string& filename, Real scale, const RealArray& center,
+              bool has_fluid_inside, Real max_distance)
+    : STLIF(readSTL(filename, scale, center), has_fluid_inside, max_distance)
+{}
+
+STLIF::STLIF (Vector<TriangleBVH::Triangle>&& triangles, bool has_fluid_inside,
+              Real max_distance)
+    : m_bvh(std::make_shared<TriangleBVH>(std::move(triangles))),
+      m_sign(has_fluid_inside ? 1.0 : -1.0),
+      m_max_distance(max_distance)
+{
+    if (m_max_distance <= 0.0) {
+        Real diag2 = 0.0;
+        for (int idim = 0; idim < 3; ++idim) {
+            diag2 += (m_bvh->boxHi()[idim]-m_bvh->boxLo()[idim])
+                *    (m_bvh->boxHi()[idim]-m_bvh->boxLo()[idim]);
+        }
+        m_max_distance = 0.1*std::sqrt(diag2);
+    }
+}
+
+Vector<TriangleBVH::Triangle>
+STLIF::readSTL (const std::string& filename, Real scale, const RealArray& center)
+{
+    BL_PROFILE("STLIF::readSTL()");
+
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(filename, buf);
+    // ReadAndBcastFile appends a null character.
+    const Long nbytes = buf.size() - 1;
+
+    Vector<TriangleBVH::Triangle> tri;
+
+    auto transform = [&] (RealArray& v) {
+        for (int idim = 0; idim < 3; ++idim) {
+            v[idim] = v[idim]*scale + center[idim];
+        }
+    };
+
+    // A binary STL file has an 80 byte header, the number of triangles as
+    // a 32-bit integer, and 50 bytes per triangle.  Note that some binary
+    // files also start with "solid", so we check the file size instead.
+    std::uint32_t nbin = 0;
+    if (nbytes >= 84) {
+        std::memcpy(&nbin, buf.data()+80, sizeof(nbin));
+    }
+
+    if (nbytes >= 84 && nbytes == 84 + 50*static_cast<Long>(nbin))
+    {
+        const int ntri = nbin;
+        tri.resize(ntri);
+        const char* p = buf.data() + 84;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = 0; i < ntri; ++i) {
+            // normal (3 floats), 3 vertices (9 floats), attribute (2 bytes)
+            float v[9];
+            std::memcpy(v, p + 50*static_cast<Long>(i) + 12, sizeof(v));
+            tri[i].v0 = RealArray{v[0], v[1], v[2]};
+            tri[i].v1 = RealArray{v[3], v[4], v[5]};
+            tri[i].v2 = RealArray{v[6], v[7], v[8]};
+            transform(tri[i].v0);
+            transform(tri[i].v1);
+            transform(tri[i].v2);
+        }
+    }
+    else
+    {
+        std::istringstream is(std::string(buf.data(), nbytes));
+        std::string word;
+        RealArray v[3];
+        int nv = 0;
+        while (is >> word) {
+            if (word == "vertex") {
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nv < 3, "STLIF: facet with more than 3 vertices");
+                is >> v[nv][0] >> v[nv][1] >> v[nv][2];
+                transform(v[nv]);
+                ++nv;
+            } else if (word == "endloop") {
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nv == 3, "STLIF: facet is not a triangle");
+                tri.push_back(TriangleBVH::Triangle{v[0], v[1], v[2]});
+                nv = 0;
+            }
+        }
+        if (is.bad()) {
+            amrex::Abort("STLIF: failed to read " + filename);
+        }
+    }
+
+    if (tri.empty()) {
+        amrex::Abort("STLIF: no triangles found in " + filename);
+    }
+
+    return tri;
+}
+
+}}
@@ -1,7 +1,13 @@
 
 #include <AMReX_EB2_Level.H>
 #include <AMReX_IArrayBox.H>
+#include <AMReX_Utility.H>
+#include <AMReX_IntConv.H>
 #include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
 
 namespace amrex { namespace EB2 {
 
@@ -871,4 +877,174 @@ Level::fillLevelSet (MultiFab& levelset, const Geometry& geom) const
     }
 }
         
+namespace {
+    //! Per-process file of the cell flags written by Level::writeChkptFile
+    std::string cellflag_file_name (const std::string& dirname, int rank)
+    {
+        return amrex::Concatenate(dirname+"/CellFlag_D_", rank, 5);
+    }
+}
+
+void
+Level::writeChkptFile (const std::string& dirname) const
+{
+    BL_PROFILE("EB2::Level::writeChkptFile()");
+
+    const int ng = m_allregular ? 0 : m_cellflag.nGrow();
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        const std::string hdrname = dirname + "/Header";
+        std::ofstream ofs(hdrname.c_str());
+        if (!ofs.good()) amrex::FileOpenFailed(hdrname);
+        ofs << m_allregular << "\n"
+            << m_ngrow << "\n"
+            << m_levelset.nGrow() << "\n"
+            << ng << "\n";
+        m_grids.writeOn(ofs);
+        ofs << "\n";
+        m_covered_grids.writeOn(ofs);
+        ofs << "\n";
+        if (!m_allregular) {
+            // The cell flags are written as 32-bit integers, box by box in
+            // the order of the box index, into one file per process.
+            ofs << FPC::NativeIntDescriptor() << "\n"
+                << m_dmap.size() << "\n";
+            for (int rank : m_dmap.ProcessorMap()) {
+                ofs << rank << "\n";
+            }
+        }
+        ofs.flush();
+        if (!ofs.good()) amrex::Abort("EB2::Level::writeChkptFile: failed to write "+hdrname);
+    }
+
+    if (m_allregular) return;
+
+    if (m_cellflag.local_size() > 0)
+    {
+        const std::string fname = cellflag_file_name(dirname, ParallelDescriptor::MyProc());
+        std::ofstream ofs(fname.c_str(), std::ios::out | std::ios::binary);
+        if (!ofs.good()) amrex::FileOpenFailed(fname);
+        for (int i : m_cellflag.IndexArray()) {
+            auto const& fab = m_cellflag[i];
+            static_assert(sizeof(EBCellFlag) == sizeof(std::uint32_t),
+                          "EBCellFlag must be a 32-bit integer");
+            writeIntData<std::uint32_t,std::uint32_t>((std::uint32_t const*)fab.dataPtr(),
+                                                      fab.box().numPts(), ofs,
+                                                      FPC::NativeIntDescriptor());
+        }
+        ofs.flush();
+        if (!ofs.good()) amrex::Abort("EB2::Level::writeChkptFile: failed to write "+fname);
+    }
+
+    VisMF::Write(m_levelset,  dirname+"/LevelSet");
+    VisMF::Write(m_volfrac,   dirname+"/VolFrac");
+    VisMF::Write(m_centroid,  dirname+"/Centroid");
+    VisMF::Write(m_bndryarea, dirname+"/BndryArea");
+    VisMF::Write(m_bndrycent, dirname+"/BndryCent");
+    VisMF::Write(m_bndrynorm, dirname+"/BndryNorm");
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        VisMF::Write(m_areafrac[idim], dirname+"/AreaFrac_"+std::to_string(idim));
+        VisMF::Write(m_facecent[idim], dirname+"/FaceCent_"+std::to_string(idim));
+    }
+}
+
+ChkptFileLevel::ChkptFileLevel (IndexSpace const* is, const std::string& dirname,
+                                const Geometry& geom)
+    : Level(is, geom)
+{
+    BL_PROFILE("EB2::ChkptFileLevel()");
+
+    int ngrow_levelset, ng;
+    IntDescriptor cellflag_id;
+    Vector<int> cellflag_rank;
+    {
+        Vector<char> fileCharPtr;
+        ParallelDescriptor::ReadAndBcastFile(dirname+"/Header", fileCharPtr);
+        std::istringstream is(fileCharPtr.dataPtr(), std::istringstream::in);
+        is >> m_allregular >> m_ngrow >> ngrow_levelset >> ng;
+        m_grids.readFrom(is);
+        m_covered_grids.readFrom(is);
+        if (!m_allregular) {
+            int nboxes;
+            is >> cellflag_id >> nboxes;
+            AMREX_ALWAYS_ASSERT(nboxes == m_grids.size());
+            cellflag_rank.resize(nboxes);
+            for (auto& rank : cellflag_rank) {
+                is >> rank;
+            }
+        }
+    }
+
+    if (m_allregular) {
+        m_ok = true;
+        return;
+    }
+
+    m_dmap.define(m_grids);
+
+    MFInfo mf_info;
+    mf_info.SetTag("EB2::Level");
+
+    m_levelset.define(amrex::convert(m_grids,IntVect::TheNodeVector()), m_dmap, 1,
+                      ngrow_levelset, mf_info);
+    VisMF::Read(m_levelset, dirname+"/LevelSet");
+
+    m_volfrac.define(m_grids, m_dmap, 1, ng, mf_info);
+    VisMF::Read(m_volfrac, dirname+"/VolFrac");
+
+    m_centroid.define(m_grids, m_dmap, AMREX_SPACEDIM, ng, mf_info);
+    VisMF::Read(m_centroid, dirname+"/Centroid");
+
+    m_bndryarea.define(m_grids, m_dmap, 1, ng, mf_info);
+    VisMF::Read(m_bndryarea, dirname+"/BndryArea");
+
+    m_bndrycent.define(m_grids, m_dmap, AMREX_SPACEDIM, ng, mf_info);
+    VisMF::Read(m_bndrycent, dirname+"/BndryCent");
+
+    m_bndrynorm.define(m_grids, m_dmap, AMREX_SPACEDIM, ng, mf_info);
+    VisMF::Read(m_bndrynorm, dirname+"/BndryNorm");
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const BoxArray& faceba = amrex::convert(m_grids, IntVect::TheDimensionVector(idim));
+        m_areafrac[idim].define(faceba, m_dmap, 1, ng, mf_info);
+        VisMF::Read(m_areafrac[idim], dirname+"/AreaFrac_"+std::to_string(idim));
+        m_facecent[idim].define(faceba, m_dmap, AMREX_SPACEDIM-1, ng, mf_info);
+        VisMF::Read(m_facecent[idim], dirname+"/FaceCent_"+std::to_string(idim));
+    }
+
+    m_cellflag.define(m_grids, m_dmap, 1, ng, mf_info);
+    {
+        // Offset of every box in the file of the process that wrote it
+        const int nboxes = m_grids.size();
+        Vector<Long> offset(nboxes);
+        {
+            std::map<int,Long> pos;
+            for (int i = 0; i < nboxes; ++i) {
+                Long& p = pos[cellflag_rank[i]];
+                offset[i] = p;
+                p += amrex::grow(m_grids[i],ng).numPts() * sizeof(std::uint32_t);
+            }
+        }
+
+        for (int i : m_cellflag.IndexArray())
+        {
+            const std::string fname = cellflag_file_name(dirname, cellflag_rank[i]);
+            std::ifstream ifs(fname.c_str(), std::ios::in | std::ios::binary);
+            if (!ifs.good()) amrex::FileOpenFailed(fname);
+            ifs.seekg(offset[i], std::ios::beg);
+
+            auto& fab = m_cellflag[i];
+            readIntData<std::uint32_t,std::uint32_t>((std::uint32_t*)fab.dataPtr(),
+                                                     fab.box().numPts(), ifs, cellflag_id);
+            if (!ifs.good()) amrex::Abort("EB2::ChkptFileLevel: failed to read "+fname);
+
+            fab.setType(FabType::undefined);
+            fab.setType(fab.getType(fab.box()));
+        }
+    }
+
+    m_ok = true;
+}
+
 }}
@@ -36,25 +36,23 @@ extern "C" {
             amrex::Abort("amrex_fi_init_octree: must use the same max_grid_size for all levels");
         }
 
-        int blocking_factor = 2*max_grid_size;
-        pp.add("blocking_factor", blocking_factor);
+        // In the octree mode of AmrMesh, the grids are blocks of
+        // max_grid_size cells, which is also the blocking factor.
+        pp.add("blocking_factor", max_grid_size);
 
         int max_grid_size_x = max_grid_size;
         pp.query("max_grid_size_x", max_grid_size_x);
-        int blocking_factor_x = 2*max_grid_size_x;
-        pp.add("blocking_factor_x", blocking_factor_x);
+        pp.add("blocking_factor_x", max_grid_size_x);
 
         int max_grid_size_y = max_grid_size;
         pp.query("max_grid_size_y", max_grid_size_y);
-        int blocking_factor_y = 2*max_grid_size_y;
-        pp.add("blocking_factor_y", blocking_factor_y);
+        pp.add("blocking_factor_y", max_grid_size_y);
 
         int max_grid_size_z = max_grid_size;
         pp.query("max_grid_size_z", max_grid_size_z);
-        int blocking_factor_z = 2*max_grid_size_z;
-        pp.add("blocking_factor_z", blocking_factor_z);
+        pp.add("blocking_factor_z", max_grid_size_z);
 
-        pp.add("grid_eff", 1.0);
+        pp.add("use_octree", 1);
 
         int max_level;
         pp.get("max_level", max_level);
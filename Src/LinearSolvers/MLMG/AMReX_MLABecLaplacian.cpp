@@ -10,9 +10,10 @@ MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
                                   const Vector<BoxArray>& a_grids,
                                   const Vector<DistributionMapping>& a_dmap,
                                   const LPInfo& a_info,
-                                  const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                                  const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                                  const int a_ncomp)
 {
-    define(a_geom, a_grids, a_dmap, a_info, a_factory);
+    define(a_geom, a_grids, a_dmap, a_info, a_factory, a_ncomp);
 }
 
 MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
@@ -20,9 +21,10 @@ MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
                                   const Vector<DistributionMapping>& a_dmap,
                                   const Vector<iMultiFab const*>& a_overset_mask,
                                   const LPInfo& a_info,
-                                  const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                                  const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                                  const int a_ncomp)
 {
-    define(a_geom, a_grids, a_dmap, a_overset_mask, a_info, a_factory);
+    define(a_geom, a_grids, a_dmap, a_overset_mask, a_info, a_factory, a_ncomp);
 }
 
 void
@@ -30,16 +32,22 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
                          const Vector<BoxArray>& a_grids,
                          const Vector<DistributionMapping>& a_dmap,
                          const LPInfo& a_info,
-                         const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                         const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                         const int a_ncomp)
 {
     BL_PROFILE("MLABecLaplacian::define()");
 
+    AMREX_ALWAYS_ASSERT(a_ncomp >= 1);
+    m_ncomp = a_ncomp;
+
     MLCellABecLap::define(a_geom, a_grids, a_dmap, a_info, a_factory);
 
     const int ncomp = getNComp();
 
     m_a_coeffs.resize(m_num_amr_levels);
     m_b_coeffs.resize(m_num_amr_levels);
+    m_a_changed.assign(m_num_amr_levels, 1);
+    m_b_changed.assign(m_num_amr_levels, 1);
     m_overset_mask.resize(m_num_amr_levels);
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
     {
@@ -69,10 +77,14 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
                          const Vector<DistributionMapping>& a_dmap,
                          const Vector<iMultiFab const*>& a_overset_mask,
                          const LPInfo& a_info,
-                         const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                         const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                         const int a_ncomp)
 {
     BL_PROFILE("MLABecLaplacian::define(overset)");
 
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!a_info.do_semicoarsening,
+                                     "MLABecLaplacian: semicoarsening not supported with overset mask");
+
     int namrlevs = a_geom.size();
     m_overset_mask.resize(namrlevs);
     for (int amrlev = 0; amrlev < namrlevs; ++amrlev)
@@ -129,7 +141,7 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
     LPInfo linfo = a_info;
     linfo.max_coarsening_level = std::min(a_info.max_coarsening_level,
                                           max_overset_mask_coarsening_level);
-    define(a_geom, a_grids, a_dmap, linfo, a_factory);
+    define(a_geom, a_grids, a_dmap, linfo, a_factory, a_ncomp);
 
     amrlev = 0;
     for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; ++mglev) {
@@ -162,6 +174,7 @@ MLABecLaplacian::setScalars (Real a, Real b) noexcept
         for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
         {
             m_a_coeffs[amrlev][0].setVal(0.0);
+            m_a_changed[amrlev] = 1;
         }
     }
 }
@@ -170,6 +183,7 @@ void
 MLABecLaplacian::setACoeffs (int amrlev, const MultiFab& alpha)
 {
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, 1, 0);
+    m_a_changed[amrlev] = 1;
     m_needs_update = true;
 }
 
@@ -177,6 +191,7 @@ void
 MLABecLaplacian::setACoeffs (int amrlev, Real alpha)
 {
     m_a_coeffs[amrlev][0].setVal(alpha);
+    m_a_changed[amrlev] = 1;
     m_needs_update = true;
 }
 
@@ -198,6 +213,7 @@ MLABecLaplacian::setBCoeffs (int amrlev,
                 MultiFab::Copy(m_b_coeffs[amrlev][0][idim], *beta[idim], 0, icomp, 1, 0);
             }
         }
+    m_b_changed[amrlev] = 1;
     m_needs_update = true;
 }
 
@@ -207,6 +223,7 @@ MLABecLaplacian::setBCoeffs (int amrlev, Real beta)
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         m_b_coeffs[amrlev][0][idim].setVal(beta);
     }
+    m_b_changed[amrlev] = 1;
     m_needs_update = true;
 }
 
@@ -216,9 +233,10 @@ MLABecLaplacian::setBCoeffs (int amrlev, Vector<Real> const& beta)
     const int ncomp = getNComp();
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         for (int icomp = 0; icomp < ncomp; ++icomp) {
-            m_b_coeffs[amrlev][0][idim].setVal(beta[icomp]);
+            m_b_coeffs[amrlev][0][idim].setVal(beta[icomp], icomp, 1);
         }
     }
+    m_b_changed[amrlev] = 1;
     m_needs_update = true;
 }
 
@@ -227,6 +245,8 @@ MLABecLaplacian::averageDownCoeffs ()
 {
     BL_PROFILE("MLABecLaplacian::averageDownCoeffs()");
 
+    // Only the coefficients set since the last call are averaged down.
+    // Averaging to a coarser AMR level changes that level too.
     for (int amrlev = m_num_amr_levels-1; amrlev > 0; --amrlev)
     {
         auto& fine_a_coeffs = m_a_coeffs[amrlev];
@@ -234,9 +254,14 @@ MLABecLaplacian::averageDownCoeffs ()
 
         averageDownCoeffsSameAmrLevel(amrlev, fine_a_coeffs, fine_b_coeffs);
         averageDownCoeffsToCoarseAmrLevel(amrlev);
+        m_a_changed[amrlev-1] = m_a_changed[amrlev-1] || m_a_changed[amrlev];
+        m_b_changed[amrlev-1] = m_b_changed[amrlev-1] || m_b_changed[amrlev];
     }
 
     averageDownCoeffsSameAmrLevel(0, m_a_coeffs[0], m_b_coeffs[0]);
+
+    m_a_changed.assign(m_num_amr_levels, 0);
+    m_b_changed.assign(m_num_amr_levels, 0);
 }
 
 void
@@ -248,28 +273,34 @@ MLABecLaplacian::averageDownCoeffsSameAmrLevel (int amrlev, Vector<MultiFab>& a,
     {
         IntVect ratio = (amrlev > 0) ? IntVect(mg_coarsen_ratio) : mg_coarsen_ratio_vec[mglev-1];
 
-        if (m_a_scalar == 0.0)
+        if (m_a_changed[amrlev])
         {
-            a[mglev].setVal(0.0);
+            if (m_a_scalar == 0.0)
+            {
+                a[mglev].setVal(0.0);
+            }
+            else
+            {
+                amrex::average_down(a[mglev-1], a[mglev], 0, 1, ratio);
+            }
         }
-        else
+
+        if (m_b_changed[amrlev])
         {
-            amrex::average_down(a[mglev-1], a[mglev], 0, 1, ratio);
+            Vector<const MultiFab*> fine {AMREX_D_DECL(&(b[mglev-1][0]),
+                                                       &(b[mglev-1][1]),
+                                                       &(b[mglev-1][2]))};
+            Vector<MultiFab*> crse {AMREX_D_DECL(&(b[mglev][0]),
+                                                 &(b[mglev][1]),
+                                                 &(b[mglev][2]))};
+
+            amrex::average_down_faces(fine, crse, ratio, 0);
         }
-        
-        Vector<const MultiFab*> fine {AMREX_D_DECL(&(b[mglev-1][0]),
-                                                   &(b[mglev-1][1]),
-                                                   &(b[mglev-1][2]))};
-        Vector<MultiFab*> crse {AMREX_D_DECL(&(b[mglev][0]),
-                                             &(b[mglev][1]),
-                                             &(b[mglev][2]))};
-
-        amrex::average_down_faces(fine, crse, ratio, 0);
     }
 
     for (int mglev = 1; mglev < nmglevs; ++mglev)
     {
-        if (m_overset_mask[amrlev][mglev]) {
+        if (m_overset_mask[amrlev][mglev] && m_b_changed[amrlev]) {
             const Real fac = static_cast<Real>(1 << mglev); // 2**mglev
             const Real osfac = 2.0*fac/(fac+1.0);
             const int ncomp = getNComp();
@@ -311,15 +342,18 @@ MLABecLaplacian::averageDownCoeffsToCoarseAmrLevel (int flev)
     auto& crse_a_coeffs = m_a_coeffs[flev-1].front();
     auto& crse_b_coeffs = m_b_coeffs[flev-1].front();
 
-    if (m_a_scalar != 0.0) {
+    // Setting the coarse coefficients overwrites the covered region too.
+    if (m_a_scalar != 0.0 && (m_a_changed[flev] || m_a_changed[flev-1])) {
         // We coarsen from the back of flev to the front of flev-1.
         // So we use mg_coarsen_ratio.
         amrex::average_down(fine_a_coeffs, crse_a_coeffs, 0, 1, mg_coarsen_ratio);
     }
 
-    amrex::average_down_faces(amrex::GetArrOfConstPtrs(fine_b_coeffs),
-                              amrex::GetArrOfPtrs(crse_b_coeffs),
-                              IntVect(mg_coarsen_ratio), m_geom[flev-1][0]);
+    if (m_b_changed[flev] || m_b_changed[flev-1]) {
+        amrex::average_down_faces(amrex::GetArrOfConstPtrs(fine_b_coeffs),
+                                  amrex::GetArrOfPtrs(crse_b_coeffs),
+                                  IntVect(mg_coarsen_ratio), m_geom[flev-1][0]);
+    }
 }
 
 void
@@ -329,10 +363,14 @@ MLABecLaplacian::applyMetricTermsCoeffs ()
     for (int alev = 0; alev < m_num_amr_levels; ++alev)
     {
         const int mglev = 0;
-        applyMetricTerm(alev, mglev, m_a_coeffs[alev][mglev]);
-        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
-        {
-            applyMetricTerm(alev, mglev, m_b_coeffs[alev][mglev][idim]);
+        if (m_a_changed[alev]) {
+            applyMetricTerm(alev, mglev, m_a_coeffs[alev][mglev]);
+        }
+        if (m_b_changed[alev]) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+            {
+                applyMetricTerm(alev, mglev, m_b_coeffs[alev][mglev][idim]);
+            }
         }
     }
 #endif
@@ -462,15 +500,49 @@ MLABecLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
     }
 }
 
+int
+MLABecLaplacian::lineSolveDir (int amrlev, int mglev) const noexcept
+{
+    if (amrlev > 0 or !doSemicoarsening()) return -1;
+
+    // Point relaxation damps the error that oscillates in the strongly
+    // coupled directions only.  If there is a direction that is not
+    // coarsened and is more strongly coupled than a coarsened one, relax
+    // lines along it.  The bottom level uses the ratio of the level above.
+    const IntVect& ratio = (mglev < m_num_mg_levels[0]-1) ? mg_coarsen_ratio_vec[mglev]
+                                                           : mg_coarsen_ratio_vec[mglev-1];
+    const Real* dx = m_geom[amrlev][mglev].CellSize();
+    Real hcrse = 0.0;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (ratio[idim] > 1) hcrse = std::max(hcrse, dx[idim]);
+    }
+    int dir = -1;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (ratio[idim] == 1 and 1.5*dx[idim] < hcrse and (dir < 0 or dx[idim] < dx[dir])) {
+            dir = idim;
+        }
+    }
+    return dir;
+}
+
 void
 MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, int redblack) const
 {
     BL_PROFILE("MLABecLaplacian::Fsmooth()");
-
-    bool regular_coarsening = true;
-    if (amrlev == 0 and mglev > 0) {
-        regular_coarsening = mg_coarsen_ratio_vec[mglev-1] == mg_coarsen_ratio;
+#ifdef AMREX_TINY_PROFILING
+    {
+        // Estimate per cell and component: sol, rhs, a and the b coefficients
+        // are read, half of sol is written and updated with about 6*dim+6 flops.
+        double npts = 0.0;
+        for (int i : sol.IndexArray()) {
+            npts += static_cast<double>(sol.box(i).numPts());
+        }
+        npts *= getNComp();
+        BL_PROFILE_WORK(npts*(4+AMREX_SPACEDIM)*sizeof(Real), npts*(3*AMREX_SPACEDIM+3));
     }
+#endif
+
+    const int line_dir = lineSolveDir(amrlev, mglev);
 
     const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
     AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
@@ -511,7 +583,12 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
     const Real alpha = m_a_scalar;
 
     MFItInfo mfi_info;
-    if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
+    if (Gpu::notInLaunchRegion()) {
+        IntVect tilesize = FabArrayBase::mfiter_tile_size;
+        // The lines are not cut by tiles.
+        if (line_dir >= 0) tilesize[line_dir] = 1024000;
+        mfi_info.EnableTiling(tilesize).SetDynamic(true);
+    }
 
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
@@ -579,7 +656,7 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                              AMREX_D_DECL(dp[1],dp[3],dp[5]),
                              osm, vbx, redblack, nc);
             });
-        } else if (regular_coarsening) {
+        } else if (line_dir < 0) {
             AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
             {
                 abec_gsrb(thread_box, solnfab, rhsfab, alpha, afab,
@@ -592,6 +669,8 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                           vbx, redblack, nc);
             });
         } else {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(tbx.length(line_dir) <= mlabec_max_line_length,
+                                             "MLABecLaplacian: line relaxation with too long boxes");
             Gpu::LaunchSafeGuard lsg(false); // xxxxx gpu todo
             // line solve does not with with GPU
             AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
@@ -603,7 +682,7 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                                           AMREX_D_DECL(m1,m3,m5),
                                           AMREX_D_DECL(dp[0],dp[2],dp[4]),
                                           AMREX_D_DECL(dp[1],dp[3],dp[5]),
-                                          vbx, redblack, nc);
+                                          vbx, redblack, nc, line_dir);
             });
         }
 #else
@@ -620,7 +699,7 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                              AMREX_D_DECL(f1fab,f3fab,f5fab),
                              osm, vbx, redblack, nc);
             });
-        } else if (regular_coarsening) {
+        } else if (line_dir < 0) {
             AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
             {
                 abec_gsrb(thread_box, solnfab, rhsfab, alpha, afab,
@@ -633,6 +712,8 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                           vbx, redblack, nc);
             });
         } else {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(tbx.length(line_dir) <= mlabec_max_line_length,
+                                             "MLABecLaplacian: line relaxation with too long boxes");
             Gpu::LaunchSafeGuard lsg(false); // xxxxx gpu todo
             // line solve does not with with GPU
             AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
@@ -644,7 +725,7 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                                           AMREX_D_DECL(m1,m3,m5),
                                           AMREX_D_DECL(f0fab,f2fab,f4fab),
                                           AMREX_D_DECL(f1fab,f3fab,f5fab),
-                                          vbx, redblack, nc);
+                                          vbx, redblack, nc, line_dir);
             });
         }
 #endif
@@ -11,6 +11,7 @@
 #include <AMReX_VisMF.H>
 #include <AMReX_ParallelReduce.H>
 #include <AMReX_MLMG.H>
+#include <AMReX_MultiFabExpr.H>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -111,13 +112,30 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
  
     // Then normalize
     Lp.normalize(amrlev, mglev, r);
- 
-    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
-    MultiFab::Copy(rh,   r,  0,0,ncomp,nghost);
+
+    // The vector operations are fused into as few passes over memory as
+    // possible.  The dot products can be fused too, unless the operator
+    // has its own xdoty, or the sums must be reproducible.
+    const MultiFab* dot_mask = nullptr;
+    const bool fuse_dot = Lp.getDotMask(amrlev, mglev, dot_mask)
+        && !system::reproducible_sum;
+    const MPI_Comm comm = Lp.BottomCommunicator();
+
+    Real rnorm, rho_next;
+    {
+        auto rv = amrex::evalLocal(nghost, Expr::assign(sorig, sol),
+                                           Expr::assign(rh, r),
+                                           Expr::norm_inf(r),
+                                           Expr::dot(rh, r, dot_mask));
+        rnorm = rv[2];
+        rho_next = rv[3];
+        BL_PROFILE("MLCGSolver::ParallelAllReduce");
+        ParallelAllReduce::Max(rnorm, comm);
+        if (fuse_dot) ParallelAllReduce::Sum(rho_next, comm);
+    }
 
     sol.setVal(0);
 
-    Real rnorm = norm_inf(r);
     const Real rnorm0   = rnorm;
 
     if ( verbose > 0 )
@@ -141,22 +159,21 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
     for (; iter <= maxiter; ++iter)
     {
-        const Real rho = dotxy(rh,r);
+        const Real rho = (fuse_dot) ? rho_next : dotxy(rh,r);
         if ( rho == 0 ) 
 	{
             ret = 1; break;
 	}
         if ( iter == 1 )
         {
-            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+            amrex::evalLocal(nghost, Expr::assign(p, r), Expr::assign(ph, p));
         }
         else
         {
             const Real beta = (rho/rho_1)*(alpha/omega);
-            sxay(p, p, -omega, v, nghost);
-            sxay(p, r,   beta, p, nghost);
+            amrex::evalLocal(nghost, Expr::assign(p, r + beta*(p - omega*v)),
+                                     Expr::assign(ph, p));
         }
-        MultiFab::Copy(ph,p,0,0,ncomp,nghost);
         Lp.apply(amrlev, mglev, v, ph, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
         Lp.normalize(amrlev, mglev, v);
 
@@ -169,13 +186,18 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 	{
             ret = 2; break;
 	}
-        sxay(sol, sol,  alpha, ph, nghost);
-        sxay(s,     r, -alpha,  v, nghost);
+        {
+            auto rv = amrex::evalLocal(nghost, Expr::assign(sol, sol + alpha*ph),
+                                               Expr::assign(s, r - alpha*v),
+                                               Expr::assign(sh, s),
+                                               Expr::norm_inf(s));
+            rnorm = rv[3];
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            ParallelAllReduce::Max(rnorm, comm);
+        }
 
         //Subtract mean from s 
 //        if (Lp.isBottomSingular()) mlmg->makeSolvable(amrlev, mglev, s);
- 
-        rnorm = norm_inf(s);
 
         if ( verbose > 2 && ParallelDescriptor::IOProcessor() )
         {
@@ -187,19 +209,31 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
         if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
 
-        MultiFab::Copy(sh,s,0,0,ncomp,nghost);
         Lp.apply(amrlev, mglev, t, sh, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
         Lp.normalize(amrlev, mglev, t);
         //
         // This is a little funky.  I want to elide one of the reductions
         // in the following two dotxy()s.  We do that by calculating the "local"
         // values and then reducing the two local values at the same time.
+        // The sum of the local values is not reproducible, so with
+        // amrex.reproducible_sum the two dotxy()s are reduced separately.
         //
-        Real tvals[2] = { dotxy(t,t,true), dotxy(t,s,true) };
+        Real tvals[2];
+        const bool local_dot = !system::reproducible_sum;
+        if (fuse_dot) {
+            auto rv = amrex::evalLocal(0, Expr::dot(t, t, dot_mask),
+                                          Expr::dot(t, s, dot_mask));
+            tvals[0] = rv[0];
+            tvals[1] = rv[1];
+        } else {
+            tvals[0] = dotxy(t,t,local_dot);
+            tvals[1] = dotxy(t,s,local_dot);
+        }
 
-        BL_PROFILE_VAR("MLCGSolver::ParallelAllReduce", blp_par);
-        ParallelAllReduce::Sum(tvals,2,Lp.BottomCommunicator());
-        BL_PROFILE_VAR_STOP(blp_par);
+        if (local_dot) {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            ParallelAllReduce::Sum(tvals,2,comm);
+        }
 
         if ( tvals[0] != Real(0.0) )
 	{
@@ -209,13 +243,21 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 	{
             ret = 3; break;
 	}
-        sxay(sol, sol,  omega, sh, nghost);
-        sxay(r,     s, -omega,  t, nghost);
+        {
+            auto rv = amrex::evalLocal(nghost, Expr::assign(sol, sol + omega*sh),
+                                               Expr::assign(r, s - omega*t),
+                                               Expr::norm_inf(r),
+                                               Expr::dot(rh, r, dot_mask));
+            Real vals[2] = {rv[2], rv[3]};
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            ParallelAllReduce::Max(vals[0], comm);
+            if (fuse_dot) ParallelAllReduce::Sum(vals[1], comm);
+            rnorm = vals[0];
+            rho_next = vals[1];
+        }
 
 //        if (Lp.isBottomSingular()) mlmg->makeSolvable(amrlev, mglev, r);
 
-        rnorm = norm_inf(r);
-
         if ( verbose > 2 )
         {
             amrex::Print() << "MLCGSolver_BiCGStab: Iteration "
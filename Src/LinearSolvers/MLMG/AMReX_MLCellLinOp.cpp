@@ -9,6 +9,11 @@
 
 namespace amrex {
 
+namespace {
+    using MaskVals = Vector<Vector<Array<MultiMask,2*AMREX_SPACEDIM> > >;
+    using BndryMasks = Vector<Vector<MultiMask> >;
+}
+
 MLCellLinOp::MLCellLinOp ()
 {
     m_ixtype = IntVect::TheCellVector();
@@ -50,6 +55,34 @@ MLCellLinOp::defineAuxData ()
         }
     }
     
+    // The masks only depend on the grids, so they are built once for
+    // all operators sharing the MG hierarchy.
+    const int extent = isCrossStencil() ? 0 : 1; // extend to corners
+    std::shared_ptr<void>& shared_maskvals = sharedData(extent ? "MLCellLinOp::maskvals_corner"
+                                                               : "MLCellLinOp::maskvals");
+    if (!shared_maskvals)
+    {
+        auto maskvals = std::make_shared<MaskVals>(m_num_amr_levels);
+        for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+        {
+            (*maskvals)[amrlev].resize(m_num_mg_levels[amrlev]);
+            for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+            {
+                for (OrientationIter oitr; oitr; ++oitr)
+                {
+                    const Orientation face = oitr();
+                    const int ngrow = 1;
+                    (*maskvals)[amrlev][mglev][face].define(m_grids[amrlev][mglev],
+                                                            m_dmap[amrlev][mglev],
+                                                            m_geom[amrlev][mglev],
+                                                            face, 0, ngrow, extent, 1, true);
+                }
+            }
+        }
+        shared_maskvals = maskvals;
+    }
+
+    const auto& maskvals = *std::static_pointer_cast<MaskVals>(shared_maskvals);
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
     {
         m_maskvals[amrlev].resize(m_num_mg_levels[amrlev]);
@@ -58,12 +91,8 @@ MLCellLinOp::defineAuxData ()
             for (OrientationIter oitr; oitr; ++oitr)
             {
                 const Orientation face = oitr();
-                const int ngrow = 1;
-                const int extent = isCrossStencil() ? 0 : 1; // extend to corners
-                m_maskvals[amrlev][mglev][face].define(m_grids[amrlev][mglev],
-                                                       m_dmap[amrlev][mglev],
-                                                       m_geom[amrlev][mglev],
-                                                       face, 0, ngrow, extent, 1, true);
+                m_maskvals[amrlev][mglev][face].define(maskvals[amrlev][mglev][face],
+                                                       amrex::make_alias, 0, 1);
             }
         }
     }
@@ -95,10 +124,23 @@ MLCellLinOp::defineBC ()
     m_bndry_cor.resize(m_num_amr_levels);
     m_crse_cor_br.resize(m_num_amr_levels);
 
+    std::shared_ptr<void>& shared_masks = sharedData("MLCellLinOp::bndry_masks");
+    if (!shared_masks)
+    {
+        auto masks = std::make_shared<BndryMasks>();
+        for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+        {
+            masks->push_back(BndryData::makeMasks(m_grids[amrlev][0], m_dmap[amrlev][0],
+                                                  m_geom[amrlev][0]));
+        }
+        shared_masks = masks;
+    }
+    const auto& bndry_masks = *std::static_pointer_cast<BndryMasks>(shared_masks);
+
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
     {
         m_bndry_sol[amrlev].reset(new MLMGBndry(m_grids[amrlev][0], m_dmap[amrlev][0],
-                                                ncomp, m_geom[amrlev][0]));
+                                                ncomp, m_geom[amrlev][0], bndry_masks[amrlev]));
     }
 
     for (int amrlev = 1; amrlev < m_num_amr_levels; ++amrlev)
@@ -130,7 +172,7 @@ MLCellLinOp::defineBC ()
     for (int amrlev = 1; amrlev < m_num_amr_levels; ++amrlev)
     {
         m_bndry_cor[amrlev].reset(new MLMGBndry(m_grids[amrlev][0], m_dmap[amrlev][0],
-                                                ncomp, m_geom[amrlev][0]));
+                                                ncomp, m_geom[amrlev][0], bndry_masks[amrlev]));
         MultiFab bc_data(m_grids[amrlev][0], m_dmap[amrlev][0], ncomp, 1);
         bc_data.setVal(0.0);
 
@@ -205,6 +247,9 @@ MLCellLinOp::setLevelBC (int amrlev, const MultiFab* a_levelbcdata)
             m_bndry_sol[amrlev]->setBndryValues(*m_crse_sol_br[amrlev], 0,
                                                 bcdata, 0, 0, ncomp,
                                                 br_ref_ratio, BCRec());
+            if (needsCrseData4()) {
+                m_bndry_sol[amrlev]->setCrseData4(m_coarse_data_for_bc, br_ref_ratio, ncomp);
+            }
             br_ref_ratio = m_coarse_data_crse_ratio;
         }
         else
@@ -841,11 +886,7 @@ MLCellLinOp::xdoty (int /*amrlev*/, int /*mglev*/, const MultiFab& x, const Mult
 {
     const int ncomp = getNComp();
     const int nghost = 0;
-    Real result = MultiFab::Dot(x,0,y,0,ncomp,nghost,true);
-    if (!local) {
-        ParallelAllReduce::Sum(result, ParallelContext::CommunicatorSub());
-    }
-    return result;
+    return MultiFab::Dot(x,0,y,0,ncomp,nghost,local);
 }
 
 MLCellLinOp::BndryCondLoc::BndryCondLoc (const BoxArray& ba, const DistributionMapping& dm, int ncomp)
@@ -0,0 +1,376 @@
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <AMReX_MLDirectSolver.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_Utility.H>
+
+namespace amrex {
+
+namespace {
+    // Only neighbors at most this far away are coupled by the operators.
+    constexpr int stencil_radius = 1;
+}
+
+MLDirectSolver::MLDirectSolver (MLLinOp& a_lp)
+    : Lp(a_lp),
+      amrlev(0),
+      mglev(a_lp.NMGLevels(0)-1)
+{
+}
+
+MLDirectSolver::~MLDirectSolver ()
+{
+}
+
+bool
+MLDirectSolver::setup (const MultiFab& sol)
+{
+    BL_PROFILE("MLDirectSolver::setup()");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(Lp.getNComp() == 1,
+                                     "MLDirectSolver doesn't work with ncomp > 1");
+
+    is_setup = true;
+
+    Real setup_start_time = amrex::second();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const Geometry& geom = Lp.m_geom[amrlev][mglev];
+    const Box& cdomain = geom.Domain();
+    const Box domain = amrex::convert(cdomain, ba.ixType());
+    const Box mbox = ba.minimalBox();
+
+    // The matrix has a row for each point of region.  In a periodic
+    // direction, region is the whole domain without the periodic images
+    // of the nodes.  The points are colored such that the points of the
+    // same color are never coupled to the same point.
+    constexpr int r = stencil_radius;
+    IntVect lo, hi, ncolor;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (geom.isPeriodic(idim)) {
+            const int n = cdomain.length(idim);
+            lo[idim] = domain.smallEnd(idim);
+            hi[idim] = domain.smallEnd(idim) + n - 1;
+            ncolor[idim] = n;
+            for (int m = 2*r+1; m < n; ++m) {
+                if (n % m == 0) {
+                    ncolor[idim] = m;
+                    break;
+                }
+            }
+        } else {
+            lo[idim] = mbox.smallEnd(idim);
+            hi[idim] = mbox.bigEnd(idim);
+            ncolor[idim] = 2*r+1;
+        }
+    }
+    region = Box(lo, hi, ba.ixType());
+    nrows = region.numPts();
+
+    // Rows are numbered with the longest direction running slowest.
+    // Periodic directions are folded, i.e., 0, n-1, 1, n-2, ..., so that
+    // the points across the periodic boundary are close.
+    const IntVect len = region.length();
+    Array<int,AMREX_SPACEDIM> order;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) order[idim] = idim;
+    std::stable_sort(order.begin(), order.end(),
+                     [&] (int a, int b) { return len[a] < len[b]; });
+    Array<Long,AMREX_SPACEDIM> stride;
+    Long bw = 0;
+    {
+        Long s = 1;
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+            const int idim = order[i];
+            stride[idim] = s;
+            bw += r * (geom.isPeriodic(idim) ? 2 : 1) * s;
+            s *= len[idim];
+        }
+    }
+
+    if (nrows * (3*bw+1) > maxsize) {
+        too_large = true;
+        if (verbose > 0) {
+            amrex::Print() << "MLDirectSolver: " << nrows << " rows with bandwidth " << bw
+                           << " exceed the maximal size " << maxsize << "\n";
+        }
+        return false;
+    }
+
+    root = ParallelContext::local_to_global_rank(ParallelContext::IOProcessorNumberSub());
+    const bool is_root = ParallelContext::MyProcSub() == ParallelContext::IOProcessorNumberSub();
+
+    if (is_root) {
+        Array<Vector<Long>,AMREX_SPACEDIM> pos;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const int n = len[idim];
+            pos[idim].resize(n);
+            for (int l = 0; l < n; ++l) {
+                int fl = l;
+                if (geom.isPeriodic(idim)) {
+                    fl = (l < (n+1)/2) ? 2*l : 2*(n-1-l)+1;
+                }
+                pos[idim][l] = fl * stride[idim];
+            }
+        }
+        perm.resize(nrows);
+        amrex::LoopOnCpu(region, [&] (int i, int j, int k) noexcept
+        {
+            amrex::ignore_unused(j,k);
+            const IntVect p(AMREX_D_DECL(i,j,k));
+            perm[region.index(p)] = AMREX_D_TERM(pos[0][i-lo[0]],
+                                                +pos[1][j-lo[1]],
+                                                +pos[2][k-lo[2]]);
+        });
+    }
+
+    // Probe the operator with the indicator function of each color
+
+    MultiFab xp(ba, dm, 1, sol.nGrow(), MFInfo(), sol.Factory());
+    MultiFab yp(ba, dm, 1, 0, MFInfo(), sol.Factory());
+    MultiFab yroot(BoxArray(region), DistributionMapping(Vector<int>{root}), 1, 0,
+                   MFInfo().SetArena(The_Pinned_Arena()));
+
+    Vector<Long> rows, cols;
+    Vector<Real> vals;
+
+    const int ncolors = AMREX_D_TERM(ncolor[0],*ncolor[1],*ncolor[2]);
+    for (int icolor = 0; icolor < ncolors; ++icolor)
+    {
+        const IntVect c(AMREX_D_DECL(icolor % ncolor[0],
+                                     (icolor / ncolor[0]) % ncolor[1],
+                                     icolor / (ncolor[0]*ncolor[1])));
+        xp.setVal(0.0);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(xp,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            Array4<Real> const& a = xp.array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_3D(bx, i, j, k,
+            {
+                amrex::ignore_unused(j,k);
+                bool on = true;
+                AMREX_D_TERM(on = on && (((i-lo[0]) % ncolor[0]) + ncolor[0]) % ncolor[0] == c[0];,
+                             on = on && (((j-lo[1]) % ncolor[1]) + ncolor[1]) % ncolor[1] == c[1];,
+                             on = on && (((k-lo[2]) % ncolor[2]) + ncolor[2]) % ncolor[2] == c[2];)
+                if (on) a(i,j,k) = 1.0;
+            });
+        }
+
+        Lp.apply(amrlev, mglev, yp, xp, MLLinOp::BCMode::Homogeneous,
+                 MLLinOp::StateMode::Correction);
+
+        yroot.setVal(0.0);
+        yroot.ParallelCopy(yp, 0, 0, 1);
+        Gpu::synchronize();
+
+        for (MFIter mfi(yroot); mfi.isValid(); ++mfi)
+        {
+            Array4<Real const> const& y = yroot.const_array(mfi);
+            amrex::LoopOnCpu(region, [&] (int i, int j, int k) noexcept
+            {
+                const Real v = y(i,j,k);
+                if (v == 0.0) return;
+                // The only point of color c coupled to p
+                const IntVect p(AMREX_D_DECL(i,j,k));
+                IntVect q;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    bool found = false;
+                    for (int o = -r; o <= r && !found; ++o) {
+                        int t = p[idim] + o;
+                        if (geom.isPeriodic(idim)) {
+                            const int n = len[idim];
+                            t = lo[idim] + ((t-lo[idim]) % n + n) % n;
+                        } else if (t < lo[idim] || t > hi[idim]) {
+                            continue;
+                        }
+                        if ((t-lo[idim]) % ncolor[idim] == c[idim]) {
+                            q[idim] = t;
+                            found = true;
+                        }
+                    }
+                    if (!found) return;
+                }
+                rows.push_back(perm[region.index(p)]);
+                cols.push_back(perm[region.index(q)]);
+                vals.push_back(v);
+            });
+        }
+    }
+
+    if (is_root)
+    {
+        kl = 0;
+        ku = 0;
+        for (Long n = 0, N = rows.size(); n < N; ++n) {
+            kl = std::max(kl, static_cast<int>(rows[n]-cols[n]));
+            ku = std::max(ku, static_cast<int>(cols[n]-rows[n]));
+        }
+
+        const Long ld = 2*kl+ku+1;
+        ab.assign(nrows*ld, 0.0);
+        empty_row.assign(nrows, 1);
+        for (Long n = 0, N = rows.size(); n < N; ++n) {
+            ab[kl+ku+rows[n]-cols[n] + cols[n]*ld] += vals[n];
+            empty_row[rows[n]] = 0;
+        }
+        for (Long i = 0; i < nrows; ++i) {
+            if (empty_row[i]) ab[kl+ku + i*ld] = 1.0;
+        }
+
+        factor();
+    }
+
+    if (verbose > 0) {
+        Real setup_time = amrex::second() - setup_start_time;
+        ParallelAllReduce::Max(setup_time, ParallelContext::CommunicatorSub());
+        amrex::Print() << "MLDirectSolver: " << nrows << " rows, bandwidth "
+                       << kl << " + " << ku << ", setup time = " << setup_time << "\n";
+    }
+
+    return true;
+}
+
+// Banded LU factorization with partial pivoting as in LAPACK's dgbtf2.
+// Column j of the band is at ab[j*ld], with a(i,j) at ab[kl+ku+i-j+j*ld].
+// A pivot that is zero up to roundoff only happens for singular
+// matrices.  Its column is skipped and the solution is set to zero
+// there, which is fine because the right hand side of a singular bottom
+// problem has been made solvable.
+void
+MLDirectSolver::factor ()
+{
+    BL_PROFILE("MLDirectSolver::factor()");
+
+    const Long n = nrows;
+    const int kv = kl+ku;
+    const Long ld = 2*kl+ku+1;
+    Real* AMREX_RESTRICT a = ab.data();
+
+    Real amax = 0.0;
+    for (Long i = 0, N = ab.size(); i < N; ++i) {
+        amax = std::max(amax, std::abs(a[i]));
+    }
+    const Real tiny = amax * 1.e3 * std::numeric_limits<Real>::epsilon();
+
+    ipiv.resize(n);
+    zero_pivot.assign(n, 0);
+
+    Long ju = 0;
+    for (Long j = 0; j < n; ++j)
+    {
+        Real* AMREX_RESTRICT cj = a + kv + j*ld; // a(j,j)
+        const Long km = std::min(Long(kl), n-1-j);
+        Long jp = 0;
+        for (Long i = 1; i <= km; ++i) {
+            if (std::abs(cj[i]) > std::abs(cj[jp])) jp = i;
+        }
+        ipiv[j] = j + jp;
+
+        if (std::abs(cj[jp]) <= tiny) {
+            zero_pivot[j] = 1;
+            continue;
+        }
+
+        ju = std::max(ju, std::min(j+ku+jp, n-1));
+        if (jp != 0) {
+            for (Long jj = j; jj <= ju; ++jj) {
+                Real* cc = a + kv + j - jj + jj*ld;
+                std::swap(cc[0], cc[jp]);
+            }
+        }
+
+        const Real rpiv = 1.0/cj[0];
+        for (Long i = 1; i <= km; ++i) {
+            cj[i] *= rpiv;
+        }
+        for (Long jj = j+1; jj <= ju; ++jj) {
+            Real* AMREX_RESTRICT cc = a + kv + j - jj + jj*ld; // a(j,jj)
+            const Real t = cc[0];
+            if (t != 0.0) {
+                AMREX_PRAGMA_SIMD
+                for (Long i = 1; i <= km; ++i) {
+                    cc[i] -= cj[i]*t;
+                }
+            }
+        }
+    }
+}
+
+int
+MLDirectSolver::solve (MultiFab& sol, const MultiFab& rhs)
+{
+    BL_PROFILE("MLDirectSolver::solve()");
+
+    if (!is_setup) setup(sol);
+    if (too_large) return 1;
+
+    MultiFab rootmf(BoxArray(region), DistributionMapping(Vector<int>{root}), 1, 0,
+                    MFInfo().SetArena(The_Pinned_Arena()));
+    rootmf.setVal(0.0);
+    rootmf.ParallelCopy(rhs, 0, 0, 1);
+    Gpu::synchronize();
+
+    for (MFIter mfi(rootmf); mfi.isValid(); ++mfi)
+    {
+        Array4<Real> const& fab = rootmf.array(mfi);
+        Vector<Real> v(nrows);
+        amrex::LoopOnCpu(region, [&] (int i, int j, int k) noexcept
+        {
+            const Long row = perm[region.index(IntVect(AMREX_D_DECL(i,j,k)))];
+            v[row] = empty_row[row] ? 0.0 : fab(i,j,k);
+        });
+
+        const Long n = nrows;
+        const int kv = kl+ku;
+        const Long ld = 2*kl+ku+1;
+        Real const* AMREX_RESTRICT a = ab.data();
+        Real* AMREX_RESTRICT b = v.data();
+
+        // Solve L y = P b
+        for (Long j = 0; j < n; ++j) {
+            if (zero_pivot[j]) continue;
+            const Long km = std::min(Long(kl), n-1-j);
+            if (ipiv[j] != j) std::swap(b[j], b[ipiv[j]]);
+            Real const* cj = a + kv + j*ld;
+            const Real t = b[j];
+            for (Long i = 1; i <= km; ++i) {
+                b[j+i] -= cj[i]*t;
+            }
+        }
+
+        // Solve U x = y
+        for (Long j = n-1; j >= 0; --j) {
+            if (zero_pivot[j]) {
+                b[j] = 0.0;
+                continue;
+            }
+            Real const* cj = a + kv + j*ld;
+            b[j] /= cj[0];
+            const Real t = b[j];
+            const Long i0 = std::max(Long(0), j-kv);
+            for (Long i = i0; i < j; ++i) {
+                b[i] -= cj[i-j]*t;
+            }
+        }
+
+        amrex::LoopOnCpu(region, [&] (int i, int j, int k) noexcept
+        {
+            fab(i,j,k) = v[perm[region.index(IntVect(AMREX_D_DECL(i,j,k)))]];
+        });
+    }
+
+    const Geometry& geom = Lp.m_geom[amrlev][mglev];
+    sol.setVal(0.0);
+    sol.ParallelCopy(rootmf, 0, 0, 1, IntVect(0), IntVect(0), geom.periodicity());
+
+    return 0;
+}
+
+}
@@ -4,6 +4,7 @@
 #include <AMReX_MultiFabUtil.H>
 #include <AMReX_EBMultiFabUtil.H>
 #include <AMReX_EBFArrayBox.H>
+#include <AMReX_EB2.H>
 
 #include <AMReX_MLABecLap_K.H>
 #include <AMReX_MLEBABecLap_K.H>
@@ -38,6 +39,50 @@ MLEBABecLap::makeFactory (int amrlev, int mglev) const
                             {1,1,1}, EBSupport::full);
 }
 
+// The kernels of a box with cut cells process all its cells the EB way, so
+// each of them costs mg.eb_cell_cost times a cell of a regular box, and a
+// cut cell mg.eb_cut_cell_cost times.  Covered boxes cost nothing.
+Vector<Real>
+MLEBABecLap::getMGLevelBoxCosts (int mglev) const
+{
+    BL_PROFILE("MLEBABecLap::getMGLevelBoxCosts()");
+
+    const Geometry& geom = m_geom[0][mglev];
+    const BoxArray& ba = m_grids[0][mglev];
+    const EB2::Level& eb_level = EB2::IndexSpace::top().getLevel(geom);
+    FabArray<EBCellFlagFab> flags(ba, m_dmap[0][mglev], 1, 0);
+    eb_level.fillEBCellFlag(flags, geom);
+
+    Vector<Real> cost(ba.size(), 0.0);
+    for (MFIter mfi(flags); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto& flagfab = flags[mfi];
+        const FabType fabtyp = flagfab.getType(bx);
+        if (fabtyp == FabType::regular)
+        {
+            cost[mfi.index()] = bx.d_numPts();
+        }
+        else if (fabtyp != FabType::covered)
+        {
+            Array4<EBCellFlag const> const& flag = flagfab.const_array();
+            ReduceOps<ReduceOpSum> reduce_op;
+            ReduceData<int> reduce_data(reduce_op);
+            using ReduceTuple = typename decltype(reduce_data)::Type;
+            reduce_op.eval(bx, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                const EBCellFlag f = flag(i,j,k);
+                return { static_cast<int>(!f.isRegular() and !f.isCovered()) };
+            });
+            const Real ncut = amrex::get<0>(reduce_data.value());
+            cost[mfi.index()] = eb_cell_cost*(bx.d_numPts()-ncut) + eb_cut_cell_cost*ncut;
+        }
+    }
+    ParallelAllReduce::Sum(cost.data(), cost.size(), m_default_comm);
+    return cost;
+}
+
 void
 MLEBABecLap::define (const Vector<Geometry>& a_geom,
                      const Vector<BoxArray>& a_grids,
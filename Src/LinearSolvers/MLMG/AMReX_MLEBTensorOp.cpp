@@ -44,10 +44,14 @@ MLEBTensorOp::define (const Vector<Geometry>& a_geom,
     m_kappa.resize(NAMRLevels());
     m_eb_kappa.resize(NAMRLevels());
     m_tauflux.resize(NAMRLevels());
+    m_local_flux.resize(NAMRLevels());
+    m_need_tauflux.resize(NAMRLevels());
     for (int amrlev = 0; amrlev < NAMRLevels(); ++amrlev) {
         m_kappa[amrlev].resize(std::min(kappa_num_mglevs,NMGLevels(amrlev)));
         m_eb_kappa[amrlev].resize(m_kappa[amrlev].size());
         m_tauflux[amrlev].resize(m_kappa[amrlev].size());
+        m_local_flux[amrlev].resize(m_kappa[amrlev].size());
+        m_need_tauflux[amrlev].resize(m_kappa[amrlev].size());
         for (int mglev = 0; mglev < m_kappa[amrlev].size(); ++mglev) {
             for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
                 m_kappa[amrlev][mglev][idim].define
@@ -67,6 +71,21 @@ MLEBTensorOp::define (const Vector<Geometry>& a_geom,
                                              m_dmap[amrlev][mglev],
                                              1, 0, MFInfo(),
                                              *m_factory[amrlev][mglev]);
+
+            auto factory = dynamic_cast<EBFArrayBoxFactory const*>(m_factory[amrlev][mglev].get());
+            const FabArray<EBCellFlagFab>* flags = (factory) ? &(factory->getMultiEBCellFlagFab()) : nullptr;
+            LayoutData<int>& local_flux = m_local_flux[amrlev][mglev];
+            local_flux.define(m_grids[amrlev][mglev], m_dmap[amrlev][mglev]);
+            int need_tauflux = 0;
+            for (MFIter mfi(local_flux); mfi.isValid(); ++mfi) {
+                const Box& gbx = amrex::grow(mfi.validbox(),2);
+                local_flux[mfi] = (flags == nullptr) ||
+                    ((*flags)[mfi].box().contains(gbx) &&
+                     (*flags)[mfi].getType(gbx) == FabType::regular);
+                if (!local_flux[mfi]) need_tauflux = 1;
+            }
+            ParallelAllReduce::Max(need_tauflux, ParallelContext::CommunicatorSub());
+            m_need_tauflux[amrlev][mglev] = need_tauflux;
         }
     }
 }
@@ -220,15 +239,90 @@ MLEBTensorOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode
     MultiFab const& kapebmf = m_eb_kappa[amrlev][mglev];
     Real bscalar = m_b_scalar;
 
-    compCrossTerms(amrlev, mglev, in);
+    // The cut-cell kernels read fluxes on the faces next to the tile, so
+    // boxes near the EB compute them in m_tauflux, whose halo exchange is
+    // overlapped with the boxes away from the EB.  The fluxes of those are
+    // used where they are computed.
+    const LayoutData<int>& local_flux = m_local_flux[amrlev][mglev];
+    const bool need_tauflux = m_need_tauflux[amrlev][mglev];
+    if (need_tauflux) {
+        compCrossFluxes(amrlev, mglev, in, true);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            fluxmf[idim].FillBoundary_nowait(0, AMREX_SPACEDIM, geom.periodicity());
+        }
+    }
+
+    Array<MultiFab,AMREX_SPACEDIM> const& etamf = m_b_coeffs[amrlev][mglev];
+    Array<MultiFab,AMREX_SPACEDIM> const& kapmf = m_kappa[amrlev][mglev];
 
     MFItInfo mfi_info;
     if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    {
+        FArrayBox fluxfab_tmp[AMREX_SPACEDIM];
+        for (MFIter mfi(out, mfi_info); mfi.isValid(); ++mfi)
+        {
+            if (!local_flux[mfi]) continue;
+
+            const Box& bx = mfi.tilebox();
+            Array4<Real> const axfab = out.array(mfi);
+            Array4<Real const> const vfab = in.const_array(mfi);
+            AMREX_D_TERM(Array4<Real const> const etaxfab = etamf[0].const_array(mfi);,
+                         Array4<Real const> const etayfab = etamf[1].const_array(mfi);,
+                         Array4<Real const> const etazfab = etamf[2].const_array(mfi););
+            AMREX_D_TERM(Array4<Real const> const kapxfab = kapmf[0].const_array(mfi);,
+                         Array4<Real const> const kapyfab = kapmf[1].const_array(mfi);,
+                         Array4<Real const> const kapzfab = kapmf[2].const_array(mfi););
+            AMREX_D_TERM(Box const xbx = amrex::surroundingNodes(bx,0);,
+                         Box const ybx = amrex::surroundingNodes(bx,1);,
+                         Box const zbx = amrex::surroundingNodes(bx,2););
+            AMREX_D_TERM(fluxfab_tmp[0].resize(xbx,AMREX_SPACEDIM);,
+                         fluxfab_tmp[1].resize(ybx,AMREX_SPACEDIM);,
+                         fluxfab_tmp[2].resize(zbx,AMREX_SPACEDIM););
+            AMREX_D_TERM(Elixir fxeli = fluxfab_tmp[0].elixir();,
+                         Elixir fyeli = fluxfab_tmp[1].elixir();,
+                         Elixir fzeli = fluxfab_tmp[2].elixir(););
+            AMREX_D_TERM(Array4<Real> const fxfab = fluxfab_tmp[0].array();,
+                         Array4<Real> const fyfab = fluxfab_tmp[1].array();,
+                         Array4<Real> const fzfab = fluxfab_tmp[2].array(););
+
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_DIM
+            ( xbx, txbx,
+              {
+                  mltensor_cross_terms_fx(txbx,fxfab,vfab,etaxfab,kapxfab,dxinv);
+              }
+            , ybx, tybx,
+              {
+                  mltensor_cross_terms_fy(tybx,fyfab,vfab,etayfab,kapyfab,dxinv);
+              }
+            , zbx, tzbx,
+              {
+                  mltensor_cross_terms_fz(tzbx,fzfab,vfab,etazfab,kapzfab,dxinv);
+              }
+            );
+
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+            {
+                mltensor_cross_terms(tbx, axfab, AMREX_D_DECL(fxfab,fyfab,fzfab), dxinv, bscalar);
+            });
+        }
+    }
+
+    if (!need_tauflux) return;
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        fluxmf[idim].FillBoundary_finish();
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
     for (MFIter mfi(out, mfi_info); mfi.isValid(); ++mfi)
     {
+        if (local_flux[mfi]) continue;
+
         const Box& bx = mfi.tilebox();
 
         auto fabtyp = (flags) ? (*flags)[mfi].getType(bx) : FabType::regular;
@@ -408,6 +502,18 @@ MLEBTensorOp::applyBCTensor (int amrlev, int mglev, MultiFab& vel,
 
 void
 MLEBTensorOp::compCrossTerms(int amrlev, int mglev, MultiFab const& mf) const
+{
+    compCrossFluxes(amrlev, mglev, mf, false);
+
+    const Geometry& geom = m_geom[amrlev][mglev];
+    Array<MultiFab,AMREX_SPACEDIM>& fluxmf = m_tauflux[amrlev][mglev];
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        fluxmf[idim].FillBoundary(0, AMREX_SPACEDIM, geom.periodicity());
+    }
+}
+
+void
+MLEBTensorOp::compCrossFluxes(int amrlev, int mglev, MultiFab const& mf, bool skip_local) const
 {
 
     auto factory = dynamic_cast<EBFArrayBoxFactory const*>(m_factory[amrlev][mglev].get());
@@ -421,6 +527,7 @@ MLEBTensorOp::compCrossTerms(int amrlev, int mglev, MultiFab const& mf) const
     Array<MultiFab,AMREX_SPACEDIM> const& etamf = m_b_coeffs[amrlev][mglev];
     Array<MultiFab,AMREX_SPACEDIM> const& kapmf = m_kappa[amrlev][mglev];
     Array<MultiFab,AMREX_SPACEDIM>& fluxmf = m_tauflux[amrlev][mglev];
+    const LayoutData<int>& local_flux = m_local_flux[amrlev][mglev];
     
     MFItInfo mfi_info;
     if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
@@ -429,6 +536,8 @@ MLEBTensorOp::compCrossTerms(int amrlev, int mglev, MultiFab const& mf) const
 #endif
     for (MFIter mfi(mf, mfi_info); mfi.isValid(); ++mfi)
     {
+        if (skip_local && local_flux[mfi]) continue;
+
         const Box& bx = mfi.tilebox();
 	AMREX_D_TERM(Box const xbx = mfi.nodaltilebox(0);,
 		     Box const ybx = mfi.nodaltilebox(1);,
@@ -517,10 +626,6 @@ MLEBTensorOp::compCrossTerms(int amrlev, int mglev, MultiFab const& mf) const
 	  }
 	}
     }
-
-    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-        fluxmf[idim].FillBoundary(0, AMREX_SPACEDIM, geom.periodicity());
-    }
 }
   
 void
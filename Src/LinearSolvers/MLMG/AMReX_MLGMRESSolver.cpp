@@ -0,0 +1,531 @@
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+#include <AMReX_MLGMRESSolver.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MultiFabExpr.H>
+#include <AMReX_ParallelReduce.H>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace amrex {
+
+MLGMRESSolver::MLGMRESSolver (MLMG& a_mlmg, Type a_type)
+    : mlmg(a_mlmg),
+      Lp(a_mlmg.linop),
+      solver_type(a_type)
+{}
+
+MLGMRESSolver::~MLGMRESSolver ()
+{}
+
+Real
+MLGMRESSolver::solve (MultiFab& a_sol, const MultiFab& a_rhs, Real tol_rel, Real tol_abs)
+{
+    BL_PROFILE("MLGMRESSolver::solve()");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(Lp.NAMRLevels() == 1,
+                                     "MLGMRESSolver: only one AMR level is supported");
+    AMREX_ALWAYS_ASSERT(restart_length >= 1);
+
+    if (mlmg.bottom_solver == BottomSolver::Default) {
+        mlmg.bottom_solver = Lp.getDefaultBottomSolver();
+    }
+
+    if (mlmg.bottom_solver == BottomSolver::hypre) {
+        int mo = Lp.getMaxOrder();
+        Lp.setMaxOrder(std::min(3,mo));  // maxorder = 4 not supported
+    }
+
+    const Real solve_start_time = amrex::second();
+
+    mlmg.prepareForSolve({&a_sol}, {&a_rhs});
+
+    MultiFab& sol = *mlmg.sol[0];
+    MultiFab& res = mlmg.res[0][0];
+    const MultiFab& cor = *mlmg.cor[0][0];
+    const int ncomp = Lp.getNComp();
+
+    fuse_dot = Lp.getDotMask(0, 0, dot_mask) && !system::reproducible_sum
+        && Gpu::notInLaunchRegion();
+
+    // The Krylov vectors are kept for the next solve.  The preconditioned
+    // vectors have the layout of MLMG's correction, so that they can be
+    // swapped with it instead of copied.
+    const int m = restart_length;
+    const bool flexible = solver_type == Type::FGMRES;
+    if (static_cast<int>(V.size()) != m+1 || V[0]->boxArray() != res.boxArray()
+        || V[0]->DistributionMap() != res.DistributionMap())
+    {
+        V.clear();
+        Z.clear();
+        ztmp.reset();
+    }
+    if (V.empty()) {
+        V.resize(m+1);
+        for (auto& v : V) {
+            v.reset(new MultiFab(res.boxArray(), res.DistributionMap(), ncomp, 0,
+                                 MFInfo(), res.Factory()));
+        }
+    }
+    if (flexible && Z.empty()) {
+        Z.resize(m);
+        for (auto& z : Z) {
+            z.reset(new MultiFab(cor.boxArray(), cor.DistributionMap(), ncomp, cor.nGrow(),
+                                 MFInfo(), cor.Factory()));
+        }
+    }
+    if (!flexible && !ztmp) {
+        ztmp.reset(new MultiFab(cor.boxArray(), cor.DistributionMap(), ncomp, cor.nGrow(),
+                                MFInfo(), cor.Factory()));
+    }
+
+    // Hessenberg matrix, column major, and the Givens rotations
+    Vector<Real> H((m+1)*m, 0.0);
+    Vector<Real> cs(m), sn(m), g(m+1), y(m);
+    Vector<Real> hcol(m+1);
+    auto Hij = [&] (int i, int j) -> Real& { return H[i+j*(m+1)]; };
+
+    Real beta = trueResidual(res);
+    const Real rnorm0 = beta;
+    const Real target = std::max(tol_rel*rnorm0, tol_abs);
+    m_init_resnorm0 = m_final_resnorm0;
+
+    if (verbose >= 1) {
+        amrex::Print() << "MLGMRESSolver: Initial rhs               = " << mlmg.MLRhsNormInf() << "\n"
+                       << "MLGMRESSolver: Initial residual (resid0) = " << m_init_resnorm0 << "\n";
+    }
+
+    iter = 0;
+    bool converged = beta <= target;
+    int restarts = 0;
+
+    while (!converged && iter < maxiter)
+    {
+        amrex::eval(*V[0], (Real(1.0)/beta)*res);
+        std::fill(g.begin(), g.end(), 0.0);
+        g[0] = beta;
+
+        int k = 0;
+        while (k < m && iter < maxiter)
+        {
+            auto& z = flexible ? Z[k] : ztmp;
+            precondition(z, *V[k]);
+            applyOp(*V[k+1], *z);
+            ++iter;
+
+            orthogonalize(k, hcol);
+
+            for (int i = 0; i <= k+1; ++i) {
+                Hij(i,k) = hcol[i];
+            }
+            for (int i = 0; i < k; ++i) {
+                const Real t = cs[i]*Hij(i,k) + sn[i]*Hij(i+1,k);
+                Hij(i+1,k) = -sn[i]*Hij(i,k) + cs[i]*Hij(i+1,k);
+                Hij(i,k) = t;
+            }
+            const Real d = std::sqrt(Hij(k,k)*Hij(k,k) + Hij(k+1,k)*Hij(k+1,k));
+            cs[k] = (d > 0.0) ? Hij(k,k)/d : 1.0;
+            sn[k] = (d > 0.0) ? Hij(k+1,k)/d : 0.0;
+            Hij(k,k) = d;
+            Hij(k+1,k) = 0.0;
+            g[k+1] = -sn[k]*g[k];
+            g[k]   =  cs[k]*g[k];
+            ++k;
+
+            const Real rnorm = std::abs(g[k]);
+            if (verbose >= 2) {
+                amrex::Print() << "MLGMRESSolver: Iteration " << std::setw(3) << iter
+                               << " 2-norm resid/resid0 = " << rnorm/rnorm0 << "\n";
+            }
+            if (rnorm <= target || hcol[k] == 0.0) break;
+        }
+
+        // Solve the triangular system and update the solution
+        for (int i = k-1; i >= 0; --i) {
+            Real t = g[i];
+            for (int j = i+1; j < k; ++j) {
+                t -= Hij(i,j)*y[j];
+            }
+            y[i] = t/Hij(i,i);
+        }
+
+        for (int i = 0; i < k; ++i) {
+            y[i] = -y[i];
+        }
+        if (flexible) {
+            update(sol, Z, k, y.data());
+        } else {
+            // V[k] is no longer needed and holds the combination of the
+            // basis vectors before it is preconditioned.
+            V[k]->setVal(0.0);
+            update(*V[k], V, k, y.data());
+            precondition(ztmp, *V[k]);
+            MultiFab::Add(sol, *ztmp, 0, 0, ncomp, 0);
+        }
+
+        // The GMRES estimate can differ from the true residual if the
+        // preconditioner is not exactly linear.
+        beta = trueResidual(res);
+        converged = beta <= target;
+
+        if (!converged && iter < maxiter) {
+            ++restarts;
+            if (verbose >= 2) {
+                amrex::Print() << "MLGMRESSolver: Restart " << restarts << " after iteration "
+                               << iter << ", 2-norm resid/resid0 = " << beta/rnorm0 << "\n";
+            }
+        }
+    }
+
+    if (!converged) {
+        if (verbose > 0) {
+            amrex::Print() << "MLGMRESSolver: Failed to converge after " << iter << " iterations."
+                           << " resid, resid/resid0 = " << m_final_resnorm0 << ", "
+                           << m_final_resnorm0/m_init_resnorm0 << "\n";
+        }
+        amrex::Abort("MLGMRESSolver failed");
+    }
+
+    if (&a_sol != &sol) {
+        MultiFab::Copy(a_sol, sol, 0, 0, ncomp, mlmg.final_fill_bc ? 1 : 0);
+    }
+
+    ++mlmg.solve_called;
+
+    const Real solve_time = amrex::second() - solve_start_time;
+    if (verbose >= 1) {
+        amrex::Print() << "MLGMRESSolver: Final Iter. " << iter
+                       << " resid, resid/resid0 = " << m_final_resnorm0 << ", "
+                       << m_final_resnorm0/m_init_resnorm0 << "\n"
+                       << "MLGMRESSolver: Timers: Solve = " << solve_time << "\n";
+    }
+
+    return m_final_resnorm0;
+}
+
+// z = M^{-1} v, one MLMG cycle with a zero initial guess
+void
+MLGMRESSolver::precondition (std::unique_ptr<MultiFab>& z, const MultiFab& v)
+{
+    BL_PROFILE("MLGMRESSolver::precondition()");
+
+    const int ncomp = Lp.getNComp();
+    MultiFab& res = mlmg.res[0][0];
+    MultiFab::Copy(res, v, 0, 0, ncomp, 0);
+
+    if (Lp.isSingular(0)) {
+        mlmg.makeSolvable(0, 0, res);
+    }
+
+    if (precond_cycle == Cycle::F) {
+        mlmg.mgFcycle();
+    } else {
+        mlmg.mgVcycle(0, 0);
+    }
+
+    std::swap(z, mlmg.cor[0][0]);
+}
+
+// w = L(z) with homogeneous boundary conditions
+void
+MLGMRESSolver::applyOp (MultiFab& w, MultiFab& z)
+{
+    Lp.apply(0, 0, w, z, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+}
+
+// r = rhs - L(sol).  Returns the 2-norm and sets m_final_resnorm0 to the max norm.
+Real
+MLGMRESSolver::trueResidual (MultiFab& r)
+{
+    mlmg.computeResidual(0);
+    m_final_resnorm0 = mlmg.ResNormInf(0);
+    return std::sqrt(Lp.xdoty(0, 0, r, r, false));
+}
+
+// Orthogonalize V[j+1] against V[0:j] with classical Gram-Schmidt and
+// normalize it.  On return, h[0:j+1] is column j of the Hessenberg matrix.
+void
+MLGMRESSolver::orthogonalize (int j, Vector<Real>& h)
+{
+    BL_PROFILE("MLGMRESSolver::orthogonalize()");
+
+    const int nv = j+1;
+    MultiFab& w = *V[nv];
+    Vector<Real> d(nv+1), d2(nv+1);
+    const MPI_Comm comm = ParallelContext::CommunicatorSub();
+
+    auto dots = [&] (Vector<Real>& r)
+    {
+        for (int i = 0; i < nv; ++i) {
+            r[i] = Lp.xdoty(0, 0, w, *V[i], false);
+        }
+        r[nv] = Lp.xdoty(0, 0, w, w, false);
+    };
+
+    // With |w - V h|^2 = |w|^2 - |h|^2, one reduction gives both the
+    // projections and the norm of the new vector.  If more than half of w
+    // cancels, that norm is inaccurate and the new vector not orthogonal
+    // enough, and the projection is repeated once ("twice is enough").
+    // The second set of dot products is computed in the same pass as the
+    // first projection.
+    if (fuse_dot) {
+        dotLocal(w, nv, d.data());
+        BL_PROFILE("MLGMRESSolver::ParallelAllReduce");
+        ParallelAllReduce::Sum(d.data(), nv+1, comm);
+    } else {
+        dots(d);
+    }
+
+    const Real wnorm2 = d[nv];
+    Real hnorm2 = 0.0;
+    for (int i = 0; i < nv; ++i) {
+        h[i] = d[i];
+        hnorm2 += d[i]*d[i];
+    }
+
+    if (wnorm2 - hnorm2 > Real(0.5)*wnorm2)
+    {
+        h[nv] = std::sqrt(wnorm2 - hnorm2);
+        update(w, V, nv, d.data(), Real(1.0)/h[nv]);
+    }
+    else
+    {
+        if (fuse_dot) {
+            update(w, V, nv, d.data(), 1.0, d2.data());
+            BL_PROFILE("MLGMRESSolver::ParallelAllReduce");
+            ParallelAllReduce::Sum(d2.data(), nv+1, comm);
+        } else {
+            update(w, V, nv, d.data(), 1.0);
+            dots(d2);
+        }
+        hnorm2 = 0.0;
+        for (int i = 0; i < nv; ++i) {
+            h[i] += d2[i];
+            hnorm2 += d2[i]*d2[i];
+        }
+        h[nv] = std::sqrt(std::max(d2[nv] - hnorm2, Real(0.0)));
+        update(w, V, nv, d2.data(), (h[nv] > 0.0) ? Real(1.0)/h[nv] : Real(1.0));
+    }
+}
+
+namespace {
+
+// The kernels below work on B vectors at a time.  A box of w stays in
+// cache, and streaming several vectors at once makes better use of the
+// memory bandwidth than one dot product or axpy after another.
+
+// s[b] += sum w*v[b], or sum w*mask*v[b]
+template <int B, bool MASK>
+void
+dot_block (Box const& bx, int ncomp, Array4<Real const> const& w, Array4<Real const> const& mask,
+           Array4<Real const> const* v, Real* s) noexcept
+{
+    const auto lo = amrex::lbound(bx);
+    const auto hi = amrex::ubound(bx);
+    Real t[B] = {};
+    for (int n = 0; n < ncomp; ++n) {
+    for (int k = lo.z; k <= hi.z; ++k) {
+    for (int j = lo.y; j <= hi.y; ++j) {
+#if defined(_OPENMP) && (_OPENMP >= 201511) && !defined(AMREX_DEBUG)
+#pragma omp simd reduction(+:t[:B])
+#endif
+        for (int i = lo.x; i <= hi.x; ++i) {
+            const Real x = MASK ? w(i,j,k,n)*mask(i,j,k) : w(i,j,k,n);
+            for (int b = 0; b < B; ++b) {
+                t[b] += x * v[b](i,j,k,n);
+            }
+        }
+    }}}
+    for (int b = 0; b < B; ++b) {
+        s[b] += t[b];
+    }
+}
+
+template <bool MASK>
+void
+dot_blocks (Box const& bx, int ncomp, Array4<Real const> const& w, Array4<Real const> const& mask,
+            Array4<Real const> const* v, int nv, Real* s) noexcept
+{
+    int iv = 0;
+    for (; iv+4 <= nv; iv += 4) {
+        dot_block<4,MASK>(bx, ncomp, w, mask, v+iv, s+iv);
+    }
+    switch (nv-iv) {
+    case 3: dot_block<3,MASK>(bx, ncomp, w, mask, v+iv, s+iv); break;
+    case 2: dot_block<2,MASK>(bx, ncomp, w, mask, v+iv, s+iv); break;
+    case 1: dot_block<1,MASK>(bx, ncomp, w, mask, v+iv, s+iv); break;
+    default: break;
+    }
+}
+
+// w -= sum h[b]*v[b]
+template <int B>
+void
+axpy_block (Box const& bx, int ncomp, Array4<Real> const& w, Array4<Real const> const* v,
+            Real const* h) noexcept
+{
+    const auto lo = amrex::lbound(bx);
+    const auto hi = amrex::ubound(bx);
+    for (int n = 0; n < ncomp; ++n) {
+    for (int k = lo.z; k <= hi.z; ++k) {
+    for (int j = lo.y; j <= hi.y; ++j) {
+        AMREX_PRAGMA_SIMD
+        for (int i = lo.x; i <= hi.x; ++i) {
+            Real x = w(i,j,k,n);
+            for (int b = 0; b < B; ++b) {
+                x -= h[b] * v[b](i,j,k,n);
+            }
+            w(i,j,k,n) = x;
+        }
+    }}}
+}
+
+void
+axpy_blocks (Box const& bx, int ncomp, Array4<Real> const& w, Array4<Real const> const* v,
+             int nv, Real const* h) noexcept
+{
+    int iv = 0;
+    for (; iv+4 <= nv; iv += 4) {
+        axpy_block<4>(bx, ncomp, w, v+iv, h+iv);
+    }
+    switch (nv-iv) {
+    case 3: axpy_block<3>(bx, ncomp, w, v+iv, h+iv); break;
+    case 2: axpy_block<2>(bx, ncomp, w, v+iv, h+iv); break;
+    case 1: axpy_block<1>(bx, ncomp, w, v+iv, h+iv); break;
+    default: break;
+    }
+}
+
+}
+
+// out[i] = w . V[i] for i < nv, and out[nv] = w . w, local sums in one
+// pass over w.
+void
+MLGMRESSolver::dotLocal (const MultiFab& w, int nv, Real* out) const
+{
+    BL_PROFILE("MLGMRESSolver::dotLocal()");
+
+    const int ncomp = w.nComp();
+    std::fill(out, out+nv+1, Real(0.0));
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<Real> priv(nv+1, 0.0);
+        Vector<Array4<Real const> > va(nv+1);
+        for (MFIter mfi(w); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            for (int iv = 0; iv < nv; ++iv) {
+                va[iv] = V[iv]->const_array(mfi);
+            }
+            va[nv] = w.const_array(mfi);
+            if (dot_mask) {
+                dot_blocks<true>(bx, ncomp, va[nv], dot_mask->const_array(mfi),
+                                 va.data(), nv+1, priv.data());
+            } else {
+                dot_blocks<false>(bx, ncomp, va[nv], Array4<Real const>(),
+                                  va.data(), nv+1, priv.data());
+            }
+        }
+#ifdef _OPENMP
+#pragma omp critical (mlgmres_dotlocal)
+#endif
+        for (int iv = 0; iv <= nv; ++iv) {
+            out[iv] += priv[iv];
+        }
+    }
+}
+
+// w = scale * (w - sum_i h[i]*basis[i]) on the valid region.  If dots is
+// not null, it is set to the local sums of basis[i] . w and w . w of the
+// new w, computed in the same pass.
+void
+MLGMRESSolver::update (MultiFab& w, const Vector<std::unique_ptr<MultiFab> >& basis,
+                       int nv, const Real* h, Real scale, Real* dots) const
+{
+    BL_PROFILE("MLGMRESSolver::update()");
+
+    const int ncomp = Lp.getNComp();
+
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion())
+    {
+        AMREX_ASSERT(dots == nullptr);
+        for (MFIter mfi(w); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            auto const& wa = w.array(mfi);
+            for (int iv = 0; iv < nv; ++iv) {
+                auto const& va = basis[iv]->const_array(mfi);
+                const Real hv = h[iv];
+                amrex::ParallelFor(bx, ncomp,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+                {
+                    wa(i,j,k,n) -= hv * va(i,j,k,n);
+                });
+            }
+            if (scale != Real(1.0)) {
+                amrex::ParallelFor(bx, ncomp,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+                {
+                    wa(i,j,k,n) *= scale;
+                });
+            }
+        }
+        return;
+    }
+#endif
+
+    if (dots) std::fill(dots, dots+nv+1, Real(0.0));
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<Real> priv(nv+1, 0.0);
+        Vector<Array4<Real const> > va(nv+1);
+        for (MFIter mfi(w); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            auto const& wa = w.array(mfi);
+            for (int iv = 0; iv < nv; ++iv) {
+                va[iv] = basis[iv]->const_array(mfi);
+            }
+            va[nv] = w.const_array(mfi);
+
+            axpy_blocks(bx, ncomp, wa, va.data(), nv, h);
+
+            if (scale != Real(1.0)) {
+                amrex::LoopConcurrentOnCpu(bx, ncomp, [=] (int i, int j, int k, int n) noexcept
+                {
+                    wa(i,j,k,n) *= scale;
+                });
+            }
+
+            if (dots && dot_mask) {
+                dot_blocks<true>(bx, ncomp, va[nv], dot_mask->const_array(mfi),
+                                 va.data(), nv+1, priv.data());
+            } else if (dots) {
+                dot_blocks<false>(bx, ncomp, va[nv], Array4<Real const>(),
+                                  va.data(), nv+1, priv.data());
+            }
+        }
+        if (dots) {
+#ifdef _OPENMP
+#pragma omp critical (mlgmres_update)
+#endif
+            for (int iv = 0; iv <= nv; ++iv) {
+                dots[iv] += priv[iv];
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,341 @@
+
+#include <AMReX_MLLaplacian4.H>
+#include <AMReX_MLLaplacian4_K.H>
+
+namespace amrex {
+
+MLLaplacian4::MLLaplacian4 (const Vector<Geometry>& a_geom,
+                            const Vector<BoxArray>& a_grids,
+                            const Vector<DistributionMapping>& a_dmap,
+                            const LPInfo& a_info,
+                            const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                            const int a_ncomp)
+{
+    define(a_geom, a_grids, a_dmap, a_info, a_factory, a_ncomp);
+}
+
+MLLaplacian4::~MLLaplacian4 () {}
+
+void
+MLLaplacian4::define (const Vector<Geometry>& a_geom,
+                      const Vector<BoxArray>& a_grids,
+                      const Vector<DistributionMapping>& a_dmap,
+                      const LPInfo& a_info,
+                      const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                      const int a_ncomp)
+{
+    BL_PROFILE("MLLaplacian4::define()");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(a_geom.size() == 1,
+                                     "MLLaplacian4: only single-level solves are supported");
+
+    MLABecLaplacian::define(a_geom, a_grids, a_dmap, a_info, a_factory, a_ncomp);
+
+    setACoeffs(0, 1.0);
+    setBCoeffs(0, 1.0);
+
+    m_phi4.define(m_grids[0][0], m_dmap[0][0], getNComp(), 2, MFInfo(), *m_factory[0][0]);
+}
+
+void
+MLLaplacian4::prepareForSolve ()
+{
+    BL_PROFILE("MLLaplacian4::prepareForSolve()");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_has_metric_term,
+                                     "MLLaplacian4: only Cartesian coordinates are supported");
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_domain_bloc_lo[idim] == 0. && m_domain_bloc_hi[idim] == 0.,
+                                         "MLLaplacian4: boundary values must be on the domain faces");
+    }
+    // The boundary conditions use four cells inside a grid.
+    const BoxArray& ba = m_grids[0][0];
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ba[i].shortside() >= 4,
+                                         "MLLaplacian4: grids must have at least 4 cells in each direction");
+    }
+
+    MLABecLaplacian::prepareForSolve();
+
+    // The smoother's coefficients of the first interior cells in the ghost
+    // cells set by applyBC at Dirichlet and coarse/fine boundaries
+    const int ncomp = getNComp();
+    const auto& maskvals = m_maskvals[0][0];
+    const auto& bcondloc = *m_bcondloc[0][0];
+    BndryRegister& undrrelxr = m_undrrelxr[0][0];
+    const int outside_domain = BndryData::outside_domain;
+    const int not_covered = BndryData::not_covered;
+    const Real coef0_dir = mllap4_dc_dirichlet_coef0;
+    const Real coef0_cf = mllap4_dc_crsefine_coef0;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(m_phi4); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        const auto& bdcv = bcondloc.bndryConds(mfi);
+        for (OrientationIter oitr; oitr; ++oitr)
+        {
+            const Orientation ori = oitr();
+            const int idim = ori.coordDir();
+            const int s = ori.isLow() ? 1 : -1;
+            const int di = (idim == 0) ? s : 0;
+            const int dj = (idim == 1) ? s : 0;
+            const int dk = (idim == 2) ? s : 0;
+            const Box& bx = amrex::adjCell(vbx, ori);
+            Array4<int const> const& mask = maskvals[ori].array(mfi);
+            Array4<Real> const& f = undrrelxr[ori].array(mfi);
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                const bool dirichlet = bdcv[icomp][ori] == AMREX_LO_DIRICHLET;
+                AMREX_HOST_DEVICE_PARALLEL_FOR_3D (bx, i, j, k,
+                {
+                    if (mask(i,j,k) == outside_domain && dirichlet) {
+                        f(i+di,j+dj,k+dk,icomp) = coef0_dir;
+                    } else if (mask(i,j,k) == not_covered) {
+                        f(i+di,j+dj,k+dk,icomp) = coef0_cf;
+                    }
+                });
+            }
+        }
+    }
+}
+
+void
+MLLaplacian4::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode, StateMode s_mode,
+                       const MLMGBndry* bndry, bool skip_fillboundary) const
+{
+    MLABecLaplacian::applyBC(amrlev, mglev, in, bc_mode, s_mode, bndry, skip_fillboundary);
+
+    if (mglev > 0 || bc_mode == BCMode::Inhomogeneous) return;
+
+    const int ncomp = getNComp();
+    const auto& maskvals = m_maskvals[0][0];
+    const auto& bcondloc = *m_bcondloc[0][0];
+    const int outside_domain = BndryData::outside_domain;
+    const int not_covered = BndryData::not_covered;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(in); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        Array4<Real> const& phi = in.array(mfi);
+        const auto& bdcv = bcondloc.bndryConds(mfi);
+        for (OrientationIter oitr; oitr; ++oitr)
+        {
+            const Orientation ori = oitr();
+            const int idim = ori.coordDir();
+            const int s = ori.isLow() ? 1 : -1;
+            const int di = (idim == 0) ? s : 0;
+            const int dj = (idim == 1) ? s : 0;
+            const int dk = (idim == 2) ? s : 0;
+            const Box& bx = amrex::adjCell(vbx, ori);
+            Array4<int const> const& mask = maskvals[ori].array(mfi);
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                const bool dirichlet = bdcv[icomp][ori] == AMREX_LO_DIRICHLET;
+                AMREX_HOST_DEVICE_PARALLEL_FOR_3D (bx, i, j, k,
+                {
+                    if (mask(i,j,k) == outside_domain && dirichlet) {
+                        mllap4_dc_dirichlet(i, j, k, icomp, phi, di, dj, dk);
+                    } else if (mask(i,j,k) == not_covered) {
+                        mllap4_dc_crsefine(i, j, k, icomp, phi, di, dj, dk);
+                    }
+                });
+            }
+        }
+    }
+}
+
+void
+MLLaplacian4::fillGhost4 (const MultiFab& in, BCMode bc_mode, const MLMGBndry* bndry) const
+{
+    BL_PROFILE("MLLaplacian4::fillGhost4()");
+
+    const int ncomp = getNComp();
+    const Geometry& geom = m_geom[0][0];
+
+    MultiFab::Copy(m_phi4, in, 0, 0, ncomp, 0);
+    m_phi4.FillBoundary(0, ncomp, geom.periodicity(), true);
+
+    const bool inhomog = (bc_mode == BCMode::Inhomogeneous);
+    if (m_needs_coarse_data_for_bc && inhomog) {
+        AMREX_ALWAYS_ASSERT(bndry != nullptr && bndry->hasCrseData4());
+        bndry->fillCrseFine4(m_phi4, ncomp);
+    }
+
+    const auto& maskvals = m_maskvals[0][0];
+    const auto& bcondloc = *m_bcondloc[0][0];
+    const int outside_domain = BndryData::outside_domain;
+    const int not_covered = BndryData::not_covered;
+
+    FArrayBox foofab(Box::TheUnitBox(),ncomp);
+    const auto& foo = foofab.const_array();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(m_phi4); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        Array4<Real> const& phi = m_phi4.array(mfi);
+        const auto& bdcv = bcondloc.bndryConds(mfi);
+
+        for (OrientationIter oitr; oitr; ++oitr)
+        {
+            const Orientation ori = oitr();
+            const int idim = ori.coordDir();
+            const int s = ori.isLow() ? 1 : -1;
+            const int di = (idim == 0) ? s : 0;
+            const int dj = (idim == 1) ? s : 0;
+            const int dk = (idim == 2) ? s : 0;
+            const Box& bx = amrex::adjCell(vbx, ori);
+            Array4<int const> const& mask = maskvals[ori].array(mfi);
+            Array4<Real const> const& bcval = (inhomog && bndry != nullptr)
+                ? bndry->bndryValues(ori).const_array(mfi) : foo;
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                const int bct = bdcv[icomp][ori];
+                AMREX_HOST_DEVICE_PARALLEL_FOR_3D (bx, i, j, k,
+                {
+                    if (mask(i,j,k) == outside_domain) {
+                        mllap4_bc(i, j, k, icomp, phi, di, dj, dk, bct,
+                                  inhomog ? bcval(i,j,k,icomp) : 0.0);
+                    } else if (mask(i,j,k) == not_covered && !inhomog) {
+                        phi(i,j,k,icomp) = 0.0;
+                        phi(i-di,j-dj,k-dk,icomp) = 0.0;
+                    }
+                });
+            }
+        }
+    }
+}
+
+void
+MLLaplacian4::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc_mode,
+                     StateMode s_mode, const MLMGBndry* bndry) const
+{
+    if (mglev > 0 || s_mode == StateMode::Correction)
+    {
+        // The second-order operator of the defect correction
+        MLABecLaplacian::apply(amrlev, mglev, out, in, bc_mode, s_mode, bndry);
+        return;
+    }
+
+    BL_PROFILE("MLLaplacian4::apply()");
+
+    fillGhost4(in, bc_mode, bndry);
+
+    const int ncomp = getNComp();
+    const Real alpha = m_a_scalar;
+    const Real* dxinv = m_geom[0][0].InvCellSize();
+    AMREX_D_TERM(const Real dhx = m_b_scalar*dxinv[0]*dxinv[0]*(1.0/12.0);,
+                 const Real dhy = m_b_scalar*dxinv[1]*dxinv[1]*(1.0/12.0);,
+                 const Real dhz = m_b_scalar*dxinv[2]*dxinv[2]*(1.0/12.0););
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(out, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<Real const> const& x = m_phi4.const_array(mfi);
+        Array4<Real> const& y = out.array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D (bx, ncomp, i, j, k, n,
+        {
+            mllap4_adotx(i, j, k, n, y, x, alpha, AMREX_D_DECL(dhx,dhy,dhz));
+        });
+    }
+}
+
+void
+MLLaplacian4::compFlux (int amrlev, const Array<MultiFab*,AMREX_SPACEDIM>& fluxes,
+                        MultiFab& sol, Location /*loc*/) const
+{
+    BL_PROFILE("MLLaplacian4::compFlux()");
+
+    fillGhost4(sol, BCMode::Inhomogeneous, m_bndry_sol[amrlev].get());
+
+    const int ncomp = getNComp();
+    const Real* dxinv = m_geom[0][0].InvCellSize();
+    AMREX_D_TERM(const Real facx = -m_b_scalar*dxinv[0]*(1.0/12.0);,
+                 const Real facy = -m_b_scalar*dxinv[1]*(1.0/12.0);,
+                 const Real facz = -m_b_scalar*dxinv[2]*(1.0/12.0););
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(m_phi4, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        Array4<Real const> const& x = m_phi4.const_array(mfi);
+        AMREX_D_TERM(const Box& xbx = mfi.nodaltilebox(0);,
+                     const Box& ybx = mfi.nodaltilebox(1);,
+                     const Box& zbx = mfi.nodaltilebox(2););
+        AMREX_D_TERM(Array4<Real> const& fx = fluxes[0]->array(mfi);,
+                     Array4<Real> const& fy = fluxes[1]->array(mfi);,
+                     Array4<Real> const& fz = fluxes[2]->array(mfi););
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D (xbx, ncomp, i, j, k, n,
+        {
+            mllap4_flux_x(i, j, k, n, fx, x, facx);
+        });
+#if (AMREX_SPACEDIM >= 2)
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D (ybx, ncomp, i, j, k, n,
+        {
+            mllap4_flux_y(i, j, k, n, fy, x, facy);
+        });
+#endif
+#if (AMREX_SPACEDIM == 3)
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D (zbx, ncomp, i, j, k, n,
+        {
+            mllap4_flux_z(i, j, k, n, fz, x, facz);
+        });
+#endif
+    }
+}
+
+void
+MLLaplacian4::compGrad (int amrlev, const Array<MultiFab*,AMREX_SPACEDIM>& grad,
+                        MultiFab& sol, Location /*loc*/) const
+{
+    BL_PROFILE("MLLaplacian4::compGrad()");
+
+    fillGhost4(sol, BCMode::Inhomogeneous, m_bndry_sol[amrlev].get());
+
+    const int ncomp = getNComp();
+    const Real* dxinv = m_geom[0][0].InvCellSize();
+    AMREX_D_TERM(const Real facx = dxinv[0]*(1.0/12.0);,
+                 const Real facy = dxinv[1]*(1.0/12.0);,
+                 const Real facz = dxinv[2]*(1.0/12.0););
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(m_phi4, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        Array4<Real const> const& x = m_phi4.const_array(mfi);
+        AMREX_D_TERM(const Box& xbx = mfi.nodaltilebox(0);,
+                     const Box& ybx = mfi.nodaltilebox(1);,
+                     const Box& zbx = mfi.nodaltilebox(2););
+        AMREX_D_TERM(Array4<Real> const& gx = grad[0]->array(mfi);,
+                     Array4<Real> const& gy = grad[1]->array(mfi);,
+                     Array4<Real> const& gz = grad[2]->array(mfi););
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D (xbx, ncomp, i, j, k, n,
+        {
+            mllap4_flux_x(i, j, k, n, gx, x, facx);
+        });
+#if (AMREX_SPACEDIM >= 2)
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D (ybx, ncomp, i, j, k, n,
+        {
+            mllap4_flux_y(i, j, k, n, gy, x, facy);
+        });
+#endif
+#if (AMREX_SPACEDIM == 3)
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D (zbx, ncomp, i, j, k, n,
+        {
+            mllap4_flux_z(i, j, k, n, gz, x, facz);
+        });
+#endif
+    }
+}
+
+}
@@ -3,6 +3,9 @@
 #include <algorithm>
 #include <unordered_map>
 #include <set>
+#include <list>
+#include <map>
+#include <numeric>
 #include <AMReX_Utility.H>
 #include <AMReX_MLLinOp.H>
 #include <AMReX_MLCellLinOp.H>
@@ -27,6 +30,77 @@ constexpr int MLLinOp::mg_box_min_width;
 constexpr int MLLinOp::mg_domain_min_width;
 #endif
 
+#ifdef AMREX_USE_EB
+Real MLLinOp::eb_cell_cost = 2.5;
+Real MLLinOp::eb_cut_cell_cost = 4.0;
+#endif
+
+// What MLLinOp::defineGrids builds from the AMR grids, and the grid
+// dependent data of derived classes.
+struct MLLinOpHierarchy
+{
+    // The input
+    Vector<Geometry> geom;
+    Vector<BoxArray> grids;
+    Vector<DistributionMapping> dmap;
+    LPInfo info;
+    MPI_Comm comm = MPI_COMM_NULL;
+
+    Vector<int> amr_ref_ratio;
+    Vector<int> num_mg_levels;
+    Vector<Vector<Geometry> > mg_geom;
+    Vector<Vector<BoxArray> > mg_grids;
+    Vector<Vector<DistributionMapping> > mg_dmap;
+    Vector<int> domain_covered;
+    Vector<IntVect> coarsen_ratio_vec;
+    bool agglomeration = false;
+    bool consolidation = false;
+    bool cost_balanced = false;
+    // EB2::IndexSpace the box costs came from, or -1
+    int eb_id = -1;
+    MPI_Comm bottom_comm = MPI_COMM_NULL;
+    std::unique_ptr<MLLinOp::CommContainer> raii_comm;
+
+    std::map<std::string, std::shared_ptr<void> > shared;
+
+    bool matches (const Vector<Geometry>& a_geom, const Vector<BoxArray>& a_grids,
+                  const Vector<DistributionMapping>& a_dmap, const LPInfo& a_info,
+                  MPI_Comm a_comm, bool a_cost_balanced, int a_eb_id) const
+    {
+        if (a_comm != comm || a_geom.size() != geom.size()) return false;
+        // The cost balanced levels depend on the EB geometry, because boxes
+        // without cost are dropped.
+        if (a_cost_balanced != cost_balanced || a_eb_id != eb_id) return false;
+        if (a_info.do_agglomeration != info.do_agglomeration ||
+            a_info.do_consolidation != info.do_consolidation ||
+            a_info.do_semicoarsening != info.do_semicoarsening ||
+            a_info.semicoarsening_anisotropic != info.semicoarsening_anisotropic ||
+            a_info.agg_grid_size != info.agg_grid_size ||
+            a_info.con_grid_size != info.con_grid_size ||
+            a_info.has_metric_term != info.has_metric_term ||
+            a_info.max_coarsening_level != info.max_coarsening_level ||
+            a_info.max_semicoarsening_level != info.max_semicoarsening_level) {
+            return false;
+        }
+        for (int lev = 0, N = geom.size(); lev < N; ++lev) {
+            const Geometry& g = geom[lev];
+            const Geometry& ag = a_geom[lev];
+            if (ag.Domain() != g.Domain() || ag.Coord() != g.Coord() ||
+                ag.isPeriodic() != g.isPeriodic()) {
+                return false;
+            }
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                if (ag.ProbLo(idim) != g.ProbLo(idim) || ag.ProbHi(idim) != g.ProbHi(idim)) {
+                    return false;
+                }
+            }
+            // BoxArray and DistributionMapping compare their ids first.
+            if (a_grids[lev] != grids[lev] || !(a_dmap[lev] == dmap[lev])) return false;
+        }
+        return true;
+    }
+};
+
 namespace {
     // experimental features
     bool initialized = false; // track initialization of static state
@@ -38,6 +112,25 @@ namespace {
     int flag_comm_cache = 0;
     int flag_use_mota = 0;
     int remap_nbh_lb = 1;
+    int flag_cost_balance = 1;
+
+    // Number of MG hierarchies kept for reuse, most recently used first
+    int cache_hierarchy = 0;
+    std::list<std::shared_ptr<MLLinOpHierarchy> > hierarchy_cache;
+
+    // Id of the EB geometry the MG level box costs are computed from
+    int cost_eb_id (bool cost_balanced)
+    {
+#ifdef AMREX_USE_EB
+        if (cost_balanced) {
+            const EB2::IndexSpace* ebis = EB2::TopIndexSpaceIfPresent();
+            if (ebis) return ebis->id();
+        }
+#else
+        amrex::ignore_unused(cost_balanced);
+#endif
+        return -1;
+    }
 
 #ifdef BL_USE_MPI
     class CommCache
@@ -100,6 +193,12 @@ void MLLinOp::Initialize ()
     pp.query("comm_cache", flag_comm_cache);
     pp.query("mota", flag_use_mota);
     pp.query("remap_nbh_lb", remap_nbh_lb);
+    pp.query("cache_hierarchy", cache_hierarchy);
+    pp.query("cost_balance", flag_cost_balance);
+#ifdef AMREX_USE_EB
+    pp.query("eb_cell_cost", eb_cell_cost);
+    pp.query("eb_cut_cell_cost", eb_cut_cell_cost);
+#endif
 
 #ifdef BL_USE_MPI
     comm_cache.reset(new CommCache());
@@ -112,6 +211,7 @@ void MLLinOp::Initialize ()
 void MLLinOp::Finalize ()
 {
     initialized = false;
+    hierarchy_cache.clear();
 #ifdef BL_USE_MPI
     comm_cache.reset();
 #endif
@@ -120,6 +220,12 @@ void MLLinOp::Finalize ()
 #endif
 }
 
+// static member function
+void MLLinOp::clearHierarchyCache ()
+{
+    hierarchy_cache.clear();
+}
+
 MLLinOp::MLLinOp () {}
 
 MLLinOp::~MLLinOp () {}
@@ -178,19 +284,136 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
 
     m_num_amr_levels = a_geom.size();
 
+    m_default_comm = ParallelContext::CommunicatorSub();
+
+    m_hierarchy.reset();
+    const bool cost_balanced = flag_cost_balance && hasMGLevelBoxCosts();
+    const int eb_id = cost_eb_id(cost_balanced);
+    for (auto it = hierarchy_cache.begin(); it != hierarchy_cache.end(); ++it)
+    {
+        if ((*it)->matches(a_geom, a_grids, a_dmap, info, m_default_comm,
+                           cost_balanced, eb_id)) {
+            m_hierarchy = *it;
+            hierarchy_cache.splice(hierarchy_cache.begin(), hierarchy_cache, it);
+            break;
+        }
+    }
+
+    if (m_hierarchy)
+    {
+        if (flag_verbose_linop) {
+            Print() << "MLLinOp::defineGrids(): reusing cached MG hierarchy" << std::endl;
+        }
+        const MLLinOpHierarchy& h = *m_hierarchy;
+        m_amr_ref_ratio = h.amr_ref_ratio;
+        m_num_mg_levels = h.num_mg_levels;
+        m_geom = h.mg_geom;
+        m_grids = h.mg_grids;
+        m_dmap = h.mg_dmap;
+        m_domain_covered = h.domain_covered;
+        mg_coarsen_ratio_vec = h.coarsen_ratio_vec;
+        m_do_agglomeration = h.agglomeration;
+        m_do_consolidation = h.consolidation;
+        m_bottom_comm = h.bottom_comm;
+    }
+    else
+    {
+        buildHierarchy(a_geom, a_grids, a_dmap);
+    }
+
+    m_do_semicoarsening = false;
+    for (const auto& r : mg_coarsen_ratio_vec) {
+        if (r != IntVect(mg_coarsen_ratio)) m_do_semicoarsening = true;
+    }
+
+    m_factory.clear();
+    m_factory.resize(m_num_amr_levels);
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        if (amrlev < a_factory.size()) {
+            m_factory[amrlev].emplace_back(a_factory[amrlev]->clone());
+        } else {
+            m_factory[amrlev].emplace_back(new FArrayBoxFactory());
+        }
+        for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; ++mglev)
+        {
+            m_factory[amrlev].emplace_back(makeFactory(amrlev,mglev));
+        }
+    }
+
+    for (int amrlev = 1; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        AMREX_ASSERT_WITH_MESSAGE(m_grids[amrlev][0].coarsenable(m_amr_ref_ratio[amrlev-1]),
+                                  "MLLinOp: grids not coarsenable between AMR levels");
+    }
+}
+
+namespace {
+
+// Ratio from the MG level whose ratio to the original grids is crr to the
+// next coarser one, IntVect(1) if there is none.  coarsenable(rr) tests
+// the original grids.  Without semicoarsening all directions are coarsened
+// together.  With it, the directions that can still be coarsened are, or,
+// with semicoarsening_anisotropic, only those among them whose cell size
+// is within a factor of 1.5 of the largest, i.e., the weakly coupled ones.
+template <class F>
+IntVect
+next_mg_coarsen_ratio (const IntVect& crr, const Real* dx, const LPInfo& info, int ratio,
+                       int& num_semicoarsening_level, F const& coarsenable)
+{
+    if (!info.do_semicoarsening) {
+        return coarsenable(crr*ratio) ? IntVect(ratio) : IntVect(1);
+    }
+
+    IntVect r(1);
+    Real hmax = 0.0;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        IntVect rr = crr;
+        rr[idim] *= ratio;
+        if (coarsenable(rr)) {
+            r[idim] = ratio;
+            hmax = std::max(hmax, dx[idim]*crr[idim]);
+        }
+    }
+    if (info.semicoarsening_anisotropic) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (1.5*dx[idim]*crr[idim] < hmax) r[idim] = 1;
+        }
+    }
+
+    if (r != IntVect(1) and r != IntVect(ratio)) {
+        if (++num_semicoarsening_level > info.max_semicoarsening_level) r = IntVect(1);
+    }
+    return r;
+}
+
+}
+
+void
+MLLinOp::buildHierarchy (const Vector<Geometry>& a_geom,
+                         const Vector<BoxArray>& a_grids,
+                         const Vector<DistributionMapping>& a_dmap)
+{
+    BL_PROFILE("MLLinOp::buildHierarchy()");
+
+    m_amr_ref_ratio.clear();
+    m_num_mg_levels.clear();
+    m_geom.clear();
+    m_grids.clear();
+    m_dmap.clear();
+    mg_coarsen_ratio_vec.clear();
+
     m_amr_ref_ratio.resize(m_num_amr_levels);
     m_num_mg_levels.resize(m_num_amr_levels);
 
     m_geom.resize(m_num_amr_levels);
     m_grids.resize(m_num_amr_levels);
     m_dmap.resize(m_num_amr_levels);
-    m_factory.resize(m_num_amr_levels);
-
-    m_default_comm = ParallelContext::CommunicatorSub();
 
     const RealBox& rb = a_geom[0].ProbDomain();
     const int coord = a_geom[0].Coord();
     const Array<int,AMREX_SPACEDIM>& is_per = a_geom[0].isPeriodic();
+    const Real* dx0 = a_geom[0].CellSize();
 
     // fine amr levels
     for (int amrlev = m_num_amr_levels-1; amrlev > 0; --amrlev)
@@ -199,11 +422,6 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
         m_geom[amrlev].push_back(a_geom[amrlev]);
         m_grids[amrlev].push_back(a_grids[amrlev]);
         m_dmap[amrlev].push_back(a_dmap[amrlev]);
-        if (amrlev < a_factory.size()) {
-            m_factory[amrlev].emplace_back(a_factory[amrlev]->clone());
-        } else {
-            m_factory[amrlev].emplace_back(new FArrayBoxFactory());
-        }
 
         int rr = mg_coarsen_ratio;
         const Box& dom = a_geom[amrlev].Domain();
@@ -235,12 +453,8 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
     m_geom[0].push_back(a_geom[0]);
     m_grids[0].push_back(a_grids[0]);
     m_dmap[0].push_back(a_dmap[0]);
-    if (a_factory.size() > 0) {
-        m_factory[0].emplace_back(a_factory[0]->clone());
-    } else {
-        m_factory[0].emplace_back(new FArrayBoxFactory());
-    }
 
+    m_domain_covered.clear();
     m_domain_covered.resize(m_num_amr_levels, false);
     auto npts0 = m_grids[0][0].numPts();
     m_domain_covered[0] = (npts0 == m_geom[0][0].Domain().numPts());
@@ -286,89 +500,35 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
         boundboxes.push_back(bbx);
         agg_flag.push_back(false); 
 
-#if (AMREX_SPACEDIM > 1)
-        if (info.do_semicoarsening) 
-	{   
-	    int num_semicoarsening_level = 0;
-            IntVect rr_0(AMREX_D_DECL(mg_coarsen_ratio,1,1));
-            bool is_coarsenable_x = ( dbx.coarsenable(rr_0, mg_domain_min_width) and
-                                      bbx.coarsenable(rr_0, mg_box_min_width));
-            IntVect rr_1(AMREX_D_DECL(1,mg_coarsen_ratio,1));
-            bool is_coarsenable_y = ( dbx.coarsenable(rr_1, mg_domain_min_width) and
-                                      bbx.coarsenable(rr_1, mg_box_min_width));
-#if (AMREX_SPACEDIM == 3)
-            IntVect rr_2(AMREX_D_DECL(1,1,mg_coarsen_ratio));
-            bool is_coarsenable_z = ( dbx.coarsenable(rr_2, mg_domain_min_width) and
-                                      bbx.coarsenable(rr_2, mg_box_min_width));
-#endif
-	    IntVect rr_vec(mg_coarsen_ratio);
-#if (AMREX_SPACEDIM == 2)
-            while ( is_coarsenable_x or is_coarsenable_y )
-#endif
-#if (AMREX_SPACEDIM == 3)
-            while ( is_coarsenable_x or is_coarsenable_y or is_coarsenable_z )
-#endif
-	    {
-#if (AMREX_SPACEDIM >= 2)
-                int r0 = (is_coarsenable_x) ? mg_coarsen_ratio : 1;
-                int r1 = (is_coarsenable_y) ? mg_coarsen_ratio : 1;
-                rr_vec[0] = r0;
-                rr_vec[1] = r1;
-#if (AMREX_SPACEDIM == 3)
-                int r2 = (is_coarsenable_z) ? mg_coarsen_ratio : 1;
-                rr_vec[2] = r2;
-#endif
-#endif
-                dbx.coarsen(rr_vec);
-                domainboxes.push_back(dbx);
-                bbx.coarsen(rr_vec);
-                boundboxes.push_back(bbx);
-                bool to_agg = (bbx.d_numPts() / nbxs) < 0.999*threshold_npts;
-                agg_flag.push_back(to_agg);
-
-                is_coarsenable_x = ( dbx.coarsenable(rr_0, mg_domain_min_width) and
-                                     bbx.coarsenable(rr_0, mg_box_min_width));
-#if (AMREX_SPACEDIM >= 2)
-                is_coarsenable_y = ( dbx.coarsenable(rr_1, mg_domain_min_width) and
-                                     bbx.coarsenable(rr_1, mg_box_min_width));
-#if (AMREX_SPACEDIM == 3)
-                is_coarsenable_z = ( dbx.coarsenable(rr_2, mg_domain_min_width) and
-                                     bbx.coarsenable(rr_2, mg_box_min_width));
-#endif
-#endif
-#if (AMREX_SPACEDIM == 2)
-		if (!(is_coarsenable_x and is_coarsenable_y))
-#endif
-#if (AMREX_SPACEDIM == 3)
-                if (!(is_coarsenable_x and is_coarsenable_y and is_coarsenable_z))
-#endif
-		{
-		    num_semicoarsening_level++;    
-		    if (num_semicoarsening_level > info.max_semicoarsening_level) break;
-		}
-	    }
-
+        const Box dom0 = dbx;
+        const Box bbx0 = bbx;
+        auto coarsenable = [&] (const IntVect& rr) -> bool {
+            return dom0.coarsenable(rr, mg_domain_min_width)
+                and bbx0.coarsenable(rr, mg_box_min_width);
+        };
+
+        // Ratio of each MG level to the original grids
+        Vector<IntVect> crse_ratio{IntVect(1)};
+        int num_semicoarsening_level = 0;
+        while (true)
+        {
+            const IntVect& r = next_mg_coarsen_ratio(crse_ratio.back(), dx0, info,
+                                                     mg_coarsen_ratio,
+                                                     num_semicoarsening_level, coarsenable);
+            if (r == IntVect(1)) break;
+            crse_ratio.push_back(crse_ratio.back()*r);
+            dbx.coarsen(r);
+            domainboxes.push_back(dbx);
+            bbx.coarsen(r);
+            boundboxes.push_back(bbx);
+            bool to_agg = (bbx.d_numPts() / nbxs) < 0.999*threshold_npts;
+            agg_flag.push_back(to_agg);
         }
-	else 
-#endif
-	{
-            while (    dbx.coarsenable(mg_coarsen_ratio,mg_domain_min_width)
-                   and bbx.coarsenable(mg_coarsen_ratio,mg_box_min_width))
-            {
-                dbx.coarsen(mg_coarsen_ratio);
-                domainboxes.push_back(dbx);
-                bbx.coarsen(mg_coarsen_ratio);
-                boundboxes.push_back(bbx);
-                bool to_agg = (bbx.d_numPts() / nbxs) < 0.999*threshold_npts;
-                agg_flag.push_back(to_agg);
-            }
-	}
 
         int first_agglev = std::distance(agg_flag.begin(),
                                          std::find(agg_flag.begin(),agg_flag.end(),1));
         int nmaxlev = std::min(static_cast<int>(domainboxes.size()),
                                info.max_coarsening_level + 1);
-        int rr = mg_coarsen_ratio;
 
         // We may have to agglomerate earlier because the original
         // BoxArray has to be coarsenable to the first agglomerated
@@ -376,9 +536,11 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
         // fine BoxArray needs to be coarsenable (unless we make
         // average_down more general).
         int last_coarsenableto_lev = 0;
-        for (int lev = std::min(nmaxlev,first_agglev); lev >= 1; --lev) {
-            int ratio = static_cast<int>(std::pow(rr,lev));
-            if (a_grids[0].coarsenable(ratio, mg_box_min_width)) {
+        // The grids cannot be coarser than the coarsest domain.
+        const int lev_max = std::min({nmaxlev, first_agglev,
+                                      static_cast<int>(crse_ratio.size())-1});
+        for (int lev = lev_max; lev >= 1; --lev) {
+            if (a_grids[0].coarsenable(crse_ratio[lev], mg_box_min_width)) {
                 last_coarsenableto_lev = lev;
                 break;
             }
@@ -398,14 +560,12 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
 
             for (int lev = 1; lev < last_coarsenableto_lev; ++lev)
             {
-                m_geom[0].emplace_back(amrex::coarsen(a_geom[0].Domain(),rr),rb,coord,is_per);
+                m_geom[0].emplace_back(domainboxes[lev],rb,coord,is_per);
                 
                 m_grids[0].push_back(a_grids[0]);
-                m_grids[0].back().coarsen(rr);
+                m_grids[0].back().coarsen(crse_ratio[lev]);
             
                 m_dmap[0].push_back(a_dmap[0]);
-                
-                rr *= mg_coarsen_ratio;
             }
 
             for (int lev = last_coarsenableto_lev; lev < nmaxlev; ++lev)
@@ -425,7 +585,6 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
     }
     else
     {
-        int rr = mg_coarsen_ratio;
         Real avg_npts = 0.0;
         if (info.do_consolidation) {
             avg_npts = static_cast<Real>(a_grids[0].d_numPts()) / static_cast<Real>(ParallelContext::NProcsSub());
@@ -436,11 +595,21 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
             }
         }
 
-        // Regular coarsening
-        while (m_num_mg_levels[0] < info.max_coarsening_level + 1
-               and a_geom[0].Domain().coarsenable(rr, mg_domain_min_width)
-               and a_grids[0].coarsenable(rr, mg_box_min_width))
+        auto coarsenable = [&] (const IntVect& rr) -> bool {
+            return a_geom[0].Domain().coarsenable(rr, mg_domain_min_width)
+                and a_grids[0].coarsenable(rr, mg_box_min_width);
+        };
+
+        // Ratio of the MG level to the original grids
+        IntVect rr(1);
+        int num_semicoarsening_level = 0;
+        while (m_num_mg_levels[0] < info.max_coarsening_level + 1)
         {
+            const IntVect& r = next_mg_coarsen_ratio(rr, dx0, info, mg_coarsen_ratio,
+                                                     num_semicoarsening_level, coarsenable);
+            if (r == IntVect(1)) break;
+            rr *= r;
+
             m_geom[0].emplace_back(amrex::coarsen(a_geom[0].Domain(),rr),rb,coord,is_per);
 
             m_grids[0].push_back(a_grids[0]);
@@ -448,7 +617,7 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
 
             if (info.do_consolidation)
             {
-                if (avg_npts/(AMREX_D_TERM(rr,*rr,*rr)) < 0.999*consolidation_threshold)
+                if (avg_npts/(AMREX_D_TERM(rr[0],*rr[1],*rr[2])) < 0.999*consolidation_threshold)
                 {
                     coned = true;
                     con_lev = m_dmap[0].size();
@@ -465,97 +634,6 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
             }
             
             ++(m_num_mg_levels[0]);
-            rr *= mg_coarsen_ratio;
-        }
-
-        if (info.do_semicoarsening)
-        {
-            int num_semicoarsening_level = 1;
-            // Semi-coarsening  -- by the time we get here we know we can't coarsen isotropically any more
-            IntVect rr_0(AMREX_D_DECL(rr,1,1));
-            bool is_coarsenable_x = ( a_geom[0].Domain().coarsenable(rr_0, mg_domain_min_width) and
-                                      a_grids[0].coarsenable(rr_0, mg_box_min_width));
-#if (AMREX_SPACEDIM >= 2)
-            IntVect rr_1(AMREX_D_DECL(1,rr,1));
-            bool is_coarsenable_y = ( a_geom[0].Domain().coarsenable(rr_1, mg_domain_min_width) and
-                                      a_grids[0].coarsenable(rr_1, mg_box_min_width));
-#endif
-#if (AMREX_SPACEDIM == 3)
-            IntVect rr_2(AMREX_D_DECL(1,1,rr));
-            bool is_coarsenable_z = ( a_geom[0].Domain().coarsenable(rr_2, mg_domain_min_width) and
-                                      a_grids[0].coarsenable(rr_2, mg_box_min_width));
-#endif
-
-#if (AMREX_SPACEDIM == 2)
-            if (is_coarsenable_x or is_coarsenable_y)
-#endif
-#if (AMREX_SPACEDIM == 3)
-            if (is_coarsenable_x or is_coarsenable_y or is_coarsenable_z)
-#endif
-            {
-                IntVect rr_vec(rr/mg_coarsen_ratio);
-#if (AMREX_SPACEDIM == 2)
-                while ( (num_semicoarsening_level < info.max_semicoarsening_level + 1) and
-			(m_num_mg_levels[0] < info.max_coarsening_level + 1) and
-                        (is_coarsenable_x or is_coarsenable_y ) )
-#endif
-#if (AMREX_SPACEDIM == 3)
-                while ( (num_semicoarsening_level < info.max_semicoarsening_level + 1) and
-		        (m_num_mg_levels[0] < info.max_coarsening_level + 1) and
-                        (is_coarsenable_x or is_coarsenable_y or is_coarsenable_z) )
-#endif
-                {
-                    int r0 = (is_coarsenable_x) ? rr_vec[0]*mg_coarsen_ratio : rr_vec[0];
-#if (AMREX_SPACEDIM >= 2)
-                    int r1 = (is_coarsenable_y) ? rr_vec[1]*mg_coarsen_ratio : rr_vec[1];
-                    rr_vec[0] = r0;
-                    rr_vec[1] = r1;
-#if (AMREX_SPACEDIM == 3)
-                    int r2 = (is_coarsenable_z) ? rr_vec[2]*mg_coarsen_ratio : rr_vec[2];
-                    rr_vec[2] = r2;
-#endif
-#endif
-                    m_geom[0].emplace_back(amrex::coarsen(a_geom[0].Domain(),rr_vec),rb,coord,is_per);
-                    m_grids[0].push_back(a_grids[0]);
-                    m_grids[0].back().coarsen(rr_vec);
-
-                    if (info.do_consolidation)
-                    {
-                        if (avg_npts/(AMREX_D_TERM(rr,*rr,*rr)) < 0.999*consolidation_threshold)
-                        {
-                            coned = true;
-                            con_lev = m_dmap[0].size();
-                            m_dmap[0].push_back(DistributionMapping());
-                        }
-                        else
-                        {
-                            m_dmap[0].push_back(m_dmap[0].back());
-                        }
-                    }
-                    else
-                    {
-                        m_dmap[0].push_back(a_dmap[0]);
-                    }
-                    ++(m_num_mg_levels[0]);
-                    ++num_semicoarsening_level;
-
-                    IntVect rrr_0(AMREX_D_DECL(rr_vec[0]*mg_coarsen_ratio, 1, 1));
-                    is_coarsenable_x = ( a_geom[0].Domain().coarsenable(rrr_0, mg_domain_min_width) and
-                                         a_grids[0].coarsenable(rrr_0, mg_box_min_width));
-#if (AMREX_SPACEDIM >= 2)
-                    IntVect rrr_1(AMREX_D_DECL(1, rr_vec[1]*mg_coarsen_ratio, 1));
-                    is_coarsenable_y = ( a_geom[0].Domain().coarsenable(rrr_1, mg_domain_min_width) and
-                                         a_grids[0].coarsenable(rrr_1, mg_box_min_width));
-
-#if (AMREX_SPACEDIM == 3)
-                    IntVect rrr_2(AMREX_D_DECL(1,1,rr_vec[2]*mg_coarsen_ratio));
-                    is_coarsenable_z = ( a_geom[0].Domain().coarsenable(rrr_2, mg_domain_min_width) and
-                                         a_grids[0].coarsenable(rrr_2, mg_box_min_width));
-#endif
-#endif
-
-                }
-            }
         }
     }
 
@@ -565,6 +643,11 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
         mg_coarsen_ratio_vec.push_back(fine_domain.length()/crse_domain.length());
     }
 
+    Vector<int> new_dmap_levs;
+    for (int mglev = 0; mglev < m_num_mg_levels[0]; ++mglev) {
+        if (m_dmap[0][mglev].empty()) new_dmap_levs.push_back(mglev);
+    }
+
     if (agged)
     {
         makeAgglomeratedDMap(m_grids[0], m_dmap[0]);
@@ -574,6 +657,12 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
         makeConsolidatedDMap(m_grids[0], m_dmap[0], consolidation_ratio, consolidation_strategy);
     }
 
+    const bool cost_balanced = flag_cost_balance && hasMGLevelBoxCosts();
+    if (cost_balanced)
+    {
+        balanceMGLevels(new_dmap_levs);
+    }
+
     if (flag_use_mota && (agged || coned))
     {
         remapNeighborhoods(m_dmap[0]);
@@ -604,19 +693,41 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
         }
     }
 
-    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
-    {
-        for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; ++mglev)
-        {
-            m_factory[amrlev].emplace_back(makeFactory(amrlev,mglev));
+    m_hierarchy = std::make_shared<MLLinOpHierarchy>();
+    MLLinOpHierarchy& h = *m_hierarchy;
+    h.geom = a_geom;
+    h.grids = a_grids;
+    h.dmap = a_dmap;
+    h.info = info;
+    h.comm = m_default_comm;
+    h.amr_ref_ratio = m_amr_ref_ratio;
+    h.num_mg_levels = m_num_mg_levels;
+    h.mg_geom = m_geom;
+    h.mg_grids = m_grids;
+    h.mg_dmap = m_dmap;
+    h.domain_covered = m_domain_covered;
+    h.coarsen_ratio_vec = mg_coarsen_ratio_vec;
+    h.agglomeration = m_do_agglomeration;
+    h.consolidation = m_do_consolidation;
+    h.cost_balanced = cost_balanced;
+    h.eb_id = cost_eb_id(cost_balanced);
+    h.bottom_comm = m_bottom_comm;
+    // The sub-communicator now lives as long as the hierarchy.
+    h.raii_comm = std::move(m_raii_comm);
+
+    if (cache_hierarchy > 0) {
+        hierarchy_cache.push_front(m_hierarchy);
+        if (hierarchy_cache.size() > static_cast<std::size_t>(cache_hierarchy)) {
+            hierarchy_cache.pop_back();
         }
     }
+}
 
-    for (int amrlev = 1; amrlev < m_num_amr_levels; ++amrlev)
-    {
-        AMREX_ASSERT_WITH_MESSAGE(m_grids[amrlev][0].coarsenable(m_amr_ref_ratio[amrlev-1]),
-                                  "MLLinOp: grids not coarsenable between AMR levels");
-    }
+std::shared_ptr<void>&
+MLLinOp::sharedData (std::string const& name)
+{
+    AMREX_ASSERT(m_hierarchy);
+    return m_hierarchy->shared[name];
 }
 
 void
@@ -887,6 +998,81 @@ MLLinOp::makeConsolidatedDMap (const Vector<BoxArray>& ba, Vector<DistributionMa
     }
 }
 
+void
+MLLinOp::balanceMGLevels (const Vector<int>& mglevs)
+{
+    BL_PROFILE("MLLinOp::balanceMGLevels()");
+
+    for (int mglev : mglevs)
+    {
+        const Vector<Real>& cost = getMGLevelBoxCosts(mglev);
+        const BoxArray& ba = m_grids[0][mglev];
+        const DistributionMapping& dm = m_dmap[0][mglev];
+        AMREX_ALWAYS_ASSERT(cost.size() == ba.size());
+
+        // The boxes stay on the processes of the distribution by number of
+        // cells, so that consolidated levels remain on fewer processes.
+        Vector<int> ranks(dm.ProcessorMap());
+        std::sort(ranks.begin(), ranks.end());
+        ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+        const int nranks = ranks.size();
+
+        // mean over max of the cost per process
+        auto efficiency = [&] (const Vector<int>& pmap, const Vector<Real>& c) -> Real
+        {
+            Vector<Real> rank_cost(nranks, 0.0);
+            for (int i = 0, N = c.size(); i < N; ++i) {
+                auto it = std::lower_bound(ranks.begin(), ranks.end(), pmap[i]);
+                rank_cost[it-ranks.begin()] += c[i];
+            }
+            const Real cmax = *std::max_element(rank_cost.begin(), rank_cost.end());
+            const Real csum = std::accumulate(rank_cost.begin(), rank_cost.end(), Real(0.0));
+            return (cmax > 0.0) ? csum/(nranks*cmax) : Real(1.0);
+        };
+        const Real eff_count = efficiency(dm.ProcessorMap(), cost);
+
+        BoxList bl;
+        Vector<Real> new_cost;
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            if (cost[i] > 0.0) {
+                bl.push_back(ba[i]);
+                new_cost.push_back(cost[i]);
+            }
+        }
+        if (new_cost.empty()) { // keep the level if nothing has a cost
+            bl = ba.boxList();
+            new_cost = cost;
+        }
+        const int ndropped = ba.size() - new_cost.size();
+        if (ndropped > 0) {
+            m_grids[0][mglev] = BoxArray(std::move(bl));
+        }
+        const BoxArray& new_ba = m_grids[0][mglev];
+
+        std::vector<Long> wgts(new_cost.size());
+        for (int i = 0, N = wgts.size(); i < N; ++i) {
+            wgts[i] = static_cast<Long>(new_cost[i]) + 1L;
+        }
+        const std::vector< std::vector<int> >& sfc = DistributionMapping::makeSFC(new_ba, wgts, nranks);
+        Vector<int> pmap(new_ba.size());
+        for (int irank = 0; irank < nranks; ++irank) {
+            for (int ibox : sfc[irank]) {
+                pmap[ibox] = ranks[irank];
+            }
+        }
+        const Real eff_cost = efficiency(pmap, new_cost);
+        m_dmap[0][mglev] = DistributionMapping(std::move(pmap));
+
+        if (flag_verbose_linop) {
+            Print() << "MLLinOp::balanceMGLevels(): MG level " << mglev << ": "
+                    << new_ba.size() << " boxes (" << ndropped << " of zero cost dropped)"
+                    << " on " << nranks << " processes, efficiency "
+                    << eff_count << " by number of cells, " << eff_cost << " by cost"
+                    << std::endl;
+        }
+    }
+}
+
 void
 MLLinOp::remapNeighborhoods (Vector<DistributionMapping> & dms)
 {
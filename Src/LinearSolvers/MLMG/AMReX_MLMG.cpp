@@ -5,6 +5,8 @@
 #include <AMReX_MLMG_K.H>
 #include <AMReX_MLABecLaplacian.H>
 
+#include <algorithm>
+
 #ifdef AMREX_USE_PETSC
 #include <petscksp.h>
 #include <AMReX_PETSc.H>
@@ -82,35 +84,71 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
     int ncomp = linop.getNComp();
 
+    // The norms whose convergence is tested: one per component, or the
+    // maximum over all components.
+    auto conv_norms = [&] (Vector<Real>&& v) -> Vector<Real> {
+        if (convergence_per_comp) {
+            return std::move(v);
+        } else {
+            return Vector<Real>{*std::max_element(v.begin(), v.end())};
+        }
+    };
+
     bool local = true;
-    Real resnorm0 = MLResNormInf(finest_amr_lev, local); 
-    Real rhsnorm0 = MLRhsNormInf(local); 
+    Vector<Real> resnorm0 = conv_norms(MLResNormInfComp(finest_amr_lev, local));
+    Vector<Real> rhsnorm0 = conv_norms(MLRhsNormInfComp(local));
+    const int nconv = resnorm0.size();
     if (!is_nsolve) {
-        ParallelAllReduce::Max<Real>({resnorm0, rhsnorm0}, ParallelContext::CommunicatorSub());
-
-        if (verbose >= 1)
-        {
-            amrex::Print() << "MLMG: Initial rhs               = " << rhsnorm0 << "\n"
-                           << "MLMG: Initial residual (resid0) = " << resnorm0 << "\n";
-        }
+        Vector<Real> norms = resnorm0;
+        norms.insert(norms.end(), rhsnorm0.begin(), rhsnorm0.end());
+        ParallelAllReduce::Max<Real>(norms.data(), norms.size(), ParallelContext::CommunicatorSub());
+        std::copy(norms.begin(), norms.begin()+nconv, resnorm0.begin());
+        std::copy(norms.begin()+nconv, norms.end(), rhsnorm0.begin());
     }
 
-    m_init_resnorm0 = resnorm0;
-    m_rhsnorm0 = rhsnorm0;
+    m_init_resnorm0 = *std::max_element(resnorm0.begin(), resnorm0.end());
+    m_rhsnorm0 = *std::max_element(rhsnorm0.begin(), rhsnorm0.end());
 
-    Real max_norm;
-    std::string norm_name;
-    if (always_use_bnorm or rhsnorm0 >= resnorm0) {
-        norm_name = "bnorm";
-        max_norm = rhsnorm0;
-    } else {
-        norm_name = "resid0";
-        max_norm = resnorm0;
+    if (!is_nsolve && verbose >= 1)
+    {
+        amrex::Print() << "MLMG: Initial rhs               = " << m_rhsnorm0 << "\n"
+                       << "MLMG: Initial residual (resid0) = " << m_init_resnorm0 << "\n";
     }
-    const Real res_target = std::max(a_tol_abs, std::max(a_tol_rel,Real(1.e-16))*max_norm);
 
-    if (!is_nsolve && resnorm0 <= res_target) {
-        composite_norminf = resnorm0;
+    Vector<Real> max_norm(nconv);
+    Vector<Real> res_target(nconv);
+    int n_bnorm = 0;
+    for (int n = 0; n < nconv; ++n) {
+        if (always_use_bnorm or rhsnorm0[n] >= resnorm0[n]) {
+            ++n_bnorm;
+            max_norm[n] = rhsnorm0[n];
+        } else {
+            max_norm[n] = resnorm0[n];
+        }
+        res_target[n] = std::max(a_tol_abs, std::max(a_tol_rel,Real(1.e-16))*max_norm[n]);
+    }
+    const std::string norm_name = (n_bnorm == nconv) ? "bnorm"
+        : ((n_bnorm == 0) ? "resid0" : "max(bnorm,resid0)");
+
+    auto is_converged = [&] (Vector<Real> const& norm) -> bool {
+        for (int n = 0; n < nconv; ++n) {
+            if (norm[n] > res_target[n]) return false;
+        }
+        return true;
+    };
+    auto max_of = [] (Vector<Real> const& norm) -> Real {
+        return *std::max_element(norm.begin(), norm.end());
+    };
+    auto max_rel = [&] (Vector<Real> const& norm) -> Real {
+        Real r = 0.0;
+        for (int n = 0; n < nconv; ++n) {
+            r = std::max(r, (max_norm[n] > 0.0) ? norm[n]/max_norm[n] : norm[n]);
+        }
+        return r;
+    };
+
+    if (!is_nsolve && is_converged(resnorm0)) {
+        composite_norminf = m_init_resnorm0;
         if (verbose >= 1) {
             amrex::Print() << "MLMG: No iterations needed\n";
         }
@@ -119,6 +157,7 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
         bool converged = false;
 
         const int niters = do_fixed_number_of_iters ? do_fixed_number_of_iters : max_iters;
+        Vector<Real> composite;
         for (int iter = 0; iter < niters; ++iter)
         {
             oneIter(iter);
@@ -130,48 +169,51 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
             if (is_nsolve) continue;
 
-            Real fine_norminf = ResNormInf(finest_amr_lev);
-            m_iter_fine_resnorm0.push_back(fine_norminf);
-            composite_norminf = fine_norminf;
+            Vector<Real> fine_norminf = conv_norms(ResNormInfComp(finest_amr_lev));
+            m_iter_fine_resnorm0.push_back(max_of(fine_norminf));
+            composite = fine_norminf;
             if (verbose >= 2) {
                 amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1 << " Fine resid/"
-                               << norm_name << " = " << fine_norminf/max_norm << "\n";
+                               << norm_name << " = " << max_rel(fine_norminf) << "\n";
             }
-            bool fine_converged = (fine_norminf <= res_target);
+            bool fine_converged = is_converged(fine_norminf);
 
             if (namrlevs == 1 and fine_converged) {
                 converged = true;
             } else if (fine_converged) {
                 // finest level is converged, but we still need to test the coarse levels
                 computeMLResidual(finest_amr_lev-1);
-                Real crse_norminf = MLResNormInf(finest_amr_lev-1);
+                Vector<Real> crse_norminf = conv_norms(MLResNormInfComp(finest_amr_lev-1));
                 if (verbose >= 2) {
                     amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1
                                    << " Crse resid/" << norm_name << " = "
-                                   << crse_norminf/max_norm << "\n";
+                                   << max_rel(crse_norminf) << "\n";
+                }
+                converged = is_converged(crse_norminf);
+                for (int n = 0; n < nconv; ++n) {
+                    composite[n] = std::max(fine_norminf[n], crse_norminf[n]);
                 }
-                converged = (crse_norminf <= res_target);
-                composite_norminf = std::max(fine_norminf, crse_norminf);
             } else {
                 converged = false;
             }
+            composite_norminf = max_of(composite);
 
             if (converged) {
                 if (verbose >= 1) {
                     amrex::Print() << "MLMG: Final Iter. " << iter+1
                                    << " resid, resid/" << norm_name << " = "
                                    << composite_norminf << ", "
-                                   << composite_norminf/max_norm << "\n";
+                                   << max_rel(composite) << "\n";
                 }
                 break;
             } else {
-              if (composite_norminf > 1.e20*max_norm) 
+              if (max_rel(composite) > 1.e20)
               {
                   if (verbose > 0) {
                       amrex::Print() << "MLMG: Failing to converge after " << iter+1 << " iterations."
                                      << " resid, resid/" << norm_name << " = "
                                      << composite_norminf << ", "
-                                     << composite_norminf/max_norm << "\n";
+                                     << max_rel(composite) << "\n";
                       amrex::Abort("MLMG failing so lets stop here");
                   }
               }
@@ -183,7 +225,7 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
                 amrex::Print() << "MLMG: Failed to converge after " << max_iters << " iterations."
                                << " resid, resid/" << norm_name << " = "
                                << composite_norminf << ", "
-                               << composite_norminf/max_norm << "\n";
+                               << max_rel(composite) << "\n";
             }
             amrex::Abort("MLMG failed");
         }
@@ -533,7 +575,6 @@ MLMG::mgFcycle ()
     BL_PROFILE("MLMG::mgFcycle()");
 
     const int amrlev = 0;
-    const int ratio = 2;
     const int mg_bottom_lev = linop.NMGLevels(amrlev) - 1;
     const int ncomp = linop.getNComp();
     int nghost = 0;
@@ -541,6 +582,7 @@ MLMG::mgFcycle ()
 
     for (int mglev = 1; mglev <= mg_bottom_lev; ++mglev)
     {
+        const IntVect& ratio = linop.mg_coarsen_ratio_vec[mglev-1];
 #ifdef AMREX_USE_EB
         amrex::EB_average_down(res[amrlev][mglev-1], res[amrlev][mglev], 0, ncomp, ratio);
 #else
@@ -943,11 +985,20 @@ MLMG::actualBottomSolve ()
         {
             bottomSolveWithPETSc(x, *bottom_b);
         }
+        else if (bottom_solver == BottomSolver::direct &&
+                 bottomSolveWithDirect(x, *bottom_b) == 0)
+        {
+            // x is the exact solution, no smoothing needed
+        }
         else
         {
+            // If the bottom problem is too large to be factorized, fall
+            // back to BiCGStab for this solve only.
+            const BottomSolver bottom = (bottom_solver == BottomSolver::direct)
+                ? BottomSolver::bicgstab : bottom_solver;
             MLCGSolver::Type cg_type;
-            if (bottom_solver == BottomSolver::cg ||
-                bottom_solver == BottomSolver::cgbicg) {
+            if (bottom == BottomSolver::cg ||
+                bottom == BottomSolver::cgbicg) {
                 cg_type = MLCGSolver::Type::CG;
             } else {
                 cg_type = MLCGSolver::Type::BiCGStab;
@@ -956,9 +1007,9 @@ MLMG::actualBottomSolve ()
             // If the MLMG solve failed then set the correction to zero 
             if (ret != 0) {
                 cor[amrlev][mglev]->setVal(0.0);
-                if (bottom_solver == BottomSolver::cgbicg ||
-                    bottom_solver == BottomSolver::bicgcg) {
-                    if (bottom_solver == BottomSolver::cgbicg) {
+                if (bottom == BottomSolver::cgbicg ||
+                    bottom == BottomSolver::bicgcg) {
+                    if (bottom == BottomSolver::cgbicg) {
                         cg_type = MLCGSolver::Type::BiCGStab; // switch to bicg
                     } else {
                         cg_type = MLCGSolver::Type::CG; // switch to cg
@@ -1007,11 +1058,35 @@ MLMG::bottomSolveWithCG (MultiFab& x, const MultiFab& b, MLCGSolver::Type type)
 // Compute single-level masked inf-norm of Residual (res).
 Real
 MLMG::ResNormInf (int alev, bool local)
+{
+    Vector<Real> norm = ResNormInfComp(alev, local);
+    return *std::max_element(norm.begin(), norm.end());
+}
+
+// Computes multi-level masked inf-norm of Residual (res).
+Real
+MLMG::MLResNormInf (int alevmax, bool local)
+{
+    Vector<Real> norm = MLResNormInfComp(alevmax, local);
+    return *std::max_element(norm.begin(), norm.end());
+}
+
+// Compute multi-level masked inf-norm of RHS (rhs).
+Real
+MLMG::MLRhsNormInf (bool local)
+{
+    Vector<Real> norm = MLRhsNormInfComp(local);
+    return *std::max_element(norm.begin(), norm.end());
+}
+
+// Compute single-level masked inf-norm of each component of Residual (res).
+Vector<Real>
+MLMG::ResNormInfComp (int alev, bool local)
 {
     BL_PROFILE("MLMG::ResNormInf()");
     const int ncomp = linop.getNComp();
     const int mglev = 0;
-    Real norm = 0.0;
+    Vector<Real> norm(ncomp, 0.0);
     MultiFab* pmf = &(res[alev][mglev]);
 #ifdef AMREX_USE_EB
     if (linop.isCellCentered() && scratch[alev]) {
@@ -1030,39 +1105,41 @@ MLMG::ResNormInf (int alev, bool local)
 #endif
     for (int n = 0; n < ncomp; n++)
     {
-	Real newnorm = 0.0;
 	if (fine_mask[alev]) {
-            newnorm = pmf->norm0(*fine_mask[alev],n,0,true);
+            norm[n] = pmf->norm0(*fine_mask[alev],n,0,true);
 	} else {
-            newnorm = pmf->norm0(n,0,true);
+            norm[n] = pmf->norm0(n,0,true);
 	}
-        norm = std::max(norm, newnorm);
     }
-    if (!local) ParallelAllReduce::Max(norm, ParallelContext::CommunicatorSub());
+    if (!local) ParallelAllReduce::Max(norm.data(), ncomp, ParallelContext::CommunicatorSub());
     return norm;
 }
 
-// Computes multi-level masked inf-norm of Residual (res).
-Real
-MLMG::MLResNormInf (int alevmax, bool local)
+// Computes multi-level masked inf-norm of each component of Residual (res).
+Vector<Real>
+MLMG::MLResNormInfComp (int alevmax, bool local)
 {
     BL_PROFILE("MLMG::MLResNormInf()");
-    Real r = 0.0;
+    const int ncomp = linop.getNComp();
+    Vector<Real> r(ncomp, 0.0);
     for (int alev = 0; alev <= alevmax; ++alev)
     {
-        r = std::max(r, ResNormInf(alev,true));
+        Vector<Real> norm = ResNormInfComp(alev,true);
+        for (int n = 0; n < ncomp; ++n) {
+            r[n] = std::max(r[n], norm[n]);
+        }
     }
-    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
+    if (!local) ParallelAllReduce::Max(r.data(), ncomp, ParallelContext::CommunicatorSub());
     return r;
 }
 
-// Compute multi-level masked inf-norm of RHS (rhs).
-Real
-MLMG::MLRhsNormInf (bool local)
+// Compute multi-level masked inf-norm of each component of RHS (rhs).
+Vector<Real>
+MLMG::MLRhsNormInfComp (bool local)
 {
     BL_PROFILE("MLMG::MLRhsNormInf()");
     const int ncomp = linop.getNComp();
-    Real r = 0.0;
+    Vector<Real> r(ncomp, 0.0);
     for (int alev = 0; alev <= finest_amr_lev; ++alev)
     {
         MultiFab* pmf = &(rhs[alev]);
@@ -1084,13 +1161,13 @@ MLMG::MLRhsNormInf (bool local)
         for (int n=0; n<ncomp; ++n)
         {
             if (alev < finest_amr_lev) {
-                r = std::max(r, pmf->norm0(*fine_mask[alev],n,0,true));
+                r[n] = std::max(r[n], pmf->norm0(*fine_mask[alev],n,0,true));
             } else {
-                r = std::max(r, pmf->norm0(n,0,true));
+                r[n] = std::max(r[n], pmf->norm0(n,0,true));
             }
         }
     }
-    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
+    if (!local) ParallelAllReduce::Max(r.data(), ncomp, ParallelContext::CommunicatorSub());
     return r;
 }
 
@@ -1139,6 +1216,8 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     } else if (linop.needsUpdate()) {
         linop.update();
 
+        direct_solver.reset();
+
 #ifdef AMREX_USE_HYPRE
         hypre_solver.reset();
         hypre_bndry.reset();
@@ -1660,7 +1739,7 @@ MLMG::computeVolInv ()
             if (factory)
             {
                 const MultiFab& vfrac = factory->getVolFrac();
-                volinv[amrlev][mglev] = vfrac.sum(0,true);
+                volinv[amrlev][mglev] = vfrac.sum(0,!system::reproducible_sum);
             }
             else
 #endif
@@ -1679,8 +1758,10 @@ MLMG::computeVolInv ()
         Real temp1, temp2;
         if (rhs[0].hasEBFabFactory())
         {
-            ParallelAllReduce::Sum<Real>({volinv[0][0], volinv[0][mgbottom]},
-                                         ParallelContext::CommunicatorSub());
+            if (!system::reproducible_sum) {
+                ParallelAllReduce::Sum<Real>({volinv[0][0], volinv[0][mgbottom]},
+                                             ParallelContext::CommunicatorSub());
+            }
             temp1 = 1.0/volinv[0][0];
             temp2 = 1.0/volinv[0][mgbottom];
         }
@@ -1703,23 +1784,27 @@ MLMG::makeSolvable ()
     if (linop.isCellCentered())
     {
         Vector<Real> offset(ncomp);
+        // The sum of local sums is not reproducible (amrex.reproducible_sum).
+        const bool local = !system::reproducible_sum;
 #ifdef AMREX_USE_EB
         auto factory = dynamic_cast<EBFArrayBoxFactory const*>(linop.Factory(0));
         if (factory)
         {
             const MultiFab& vfrac = factory->getVolFrac();
             for (int c = 0; c < ncomp; ++c) {
-                offset[c] = MultiFab::Dot(rhs[0], c, vfrac, 0, 1, 0, true) * volinv[0][0];
+                offset[c] = MultiFab::Dot(rhs[0], c, vfrac, 0, 1, 0, local) * volinv[0][0];
             }            
         }
         else
 #endif
         {
             for (int c = 0; c < ncomp; ++c) {
-                offset[c] = rhs[0].sum(c,true) * volinv[0][0];
+                offset[c] = rhs[0].sum(c,local) * volinv[0][0];
             }
         }
-        ParallelAllReduce::Sum(offset.data(), ncomp, ParallelContext::CommunicatorSub());
+        if (local) {
+            ParallelAllReduce::Sum(offset.data(), ncomp, ParallelContext::CommunicatorSub());
+        }
         if (verbose >= 4) {
             for (int c = 0; c < ncomp; ++c) {
                 amrex::Print() << "MLMG: Subtracting " << offset[c] 
@@ -1759,24 +1844,27 @@ MLMG::makeSolvable (int amrlev, int mglev, MultiFab& mf)
     if (linop.isCellCentered())
     {
         Vector<Real> offset(ncomp);
+        const bool local = !system::reproducible_sum;
 #ifdef AMREX_USE_EB
         auto factory = dynamic_cast<EBFArrayBoxFactory const*>(linop.Factory(amrlev,mglev));
         if (factory)
         {
             const MultiFab& vfrac = factory->getVolFrac();
             for (int c = 0; c < ncomp; ++c) {
-                offset[c] = MultiFab::Dot(mf, c, vfrac, 0, 1, 0, true) * volinv[amrlev][mglev];
+                offset[c] = MultiFab::Dot(mf, c, vfrac, 0, 1, 0, local) * volinv[amrlev][mglev];
             }            
         }
         else
 #endif
         {
             for (int c = 0; c < ncomp; ++c) {
-                offset[c] = mf.sum(c,true) * volinv[amrlev][mglev];
+                offset[c] = mf.sum(c,local) * volinv[amrlev][mglev];
             }
         }
 
-        ParallelAllReduce::Sum(offset.data(), ncomp, ParallelContext::CommunicatorSub());
+        if (local) {
+            ParallelAllReduce::Sum(offset.data(), ncomp, ParallelContext::CommunicatorSub());
+        }
 
         if (verbose >= 4) {
             for (int c = 0; c < ncomp; ++c) {
@@ -1812,10 +1900,13 @@ MLMG::getNodalSum (int amrlev, int mglev, MultiFab& mf) const
 {
     MultiFab one(mf.boxArray(), mf.DistributionMap(), 1, 0, MFInfo(), mf.Factory());
     one.setVal(1.0);
-    const bool local = true;
+    // The sum of local sums is not reproducible (amrex.reproducible_sum).
+    const bool local = !system::reproducible_sum;
     Real s1 = linop.xdoty(amrlev, mglev, mf, one, local);
     Real s2 = linop.xdoty(amrlev, mglev, one, one, local);
-    ParallelAllReduce::Sum<Real>({s1,s2}, ParallelContext::CommunicatorSub());
+    if (local) {
+        ParallelAllReduce::Sum<Real>({s1,s2}, ParallelContext::CommunicatorSub());
+    }
     return s1/s2;
 }
 
@@ -1879,6 +1970,39 @@ MLMG::bottomSolveWithHypre (MultiFab& x, const MultiFab& b)
 #endif
 }
 
+int
+MLMG::bottomSolveWithDirect (MultiFab& x, const MultiFab& b)
+{
+    const int amrlev = 0;
+    const int mglev  = linop.NMGLevels(amrlev) - 1;
+
+    if (direct_solver == nullptr)  // The factorization is reused
+    {
+        direct_solver.reset(new MLDirectSolver(linop));
+        direct_solver->setVerbose(bottom_verbose);
+        direct_solver->setMaxSize(bottom_direct_max_size);
+    }
+
+    int ret = direct_solver->solve(x, b);
+    if (ret != 0) {
+        if (verbose > 0) {
+            amrex::Print() << "MLMG: Bottom problem is too large for the direct solver, "
+                           << "using bicgstab\n";
+        }
+        direct_solver.reset();
+        return ret;
+    }
+
+    // For singular problems the solution is only determined up to a
+    // constant.  As for hypre, we make the average of the correction 0.
+    if (linop.isSingular(amrlev))
+    {
+        makeSolvable(amrlev, mglev, x);
+    }
+
+    return 0;
+}
+
 void
 MLMG::bottomSolveWithPETSc (MultiFab& x, const MultiFab& b)
 {
@@ -3,6 +3,86 @@
 
 namespace amrex {
 
+namespace {
+
+// Weights for the average over [m/ratio,(m+1)/ratio] of the polynomial of
+// degree four with given averages over the cells [s,s+1], ..., [s+4,s+5].
+// The primitive of the polynomial interpolates the partial sums of the
+// averages at the nodes s, ..., s+5.
+void crse_fine4_weights (int s, int m, int ratio, Real* w)
+{
+    Real x[6];
+    for (int k = 0; k < 6; ++k) {
+        x[k] = s + k;
+    }
+    auto lagrange = [&x] (int k, Real xx) -> Real
+    {
+        Real r = 1.0;
+        for (int l = 0; l < 6; ++l) {
+            if (l != k) r *= (xx-x[l])/(x[k]-x[l]);
+        }
+        return r;
+    };
+    const Real xlo = Real(m)/ratio;
+    const Real xhi = Real(m+1)/ratio;
+    for (int j = 0; j < 5; ++j) {
+        w[j] = 0.0;
+        for (int k = j+1; k < 6; ++k) {
+            w[j] += lagrange(k,xhi) - lagrange(k,xlo);
+        }
+        w[j] *= ratio;
+    }
+}
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real crse_fine4_interp (IntVect const& iv, int n, Array4<Real const> const& crse, int ratio,
+                        MLMGBndry::CrseFine4Weights const& wt,
+                        Dim3 const& cdlo, Dim3 const& cdhi,
+                        GpuArray<int,AMREX_SPACEDIM> const& is_periodic) noexcept
+{
+    const int clo[3] = {cdlo.x, cdlo.y, cdlo.z};
+    const int chi[3] = {cdhi.x, cdhi.y, cdhi.z};
+    IntVect ic = amrex::coarsen(iv, ratio);
+    Real const* w[AMREX_SPACEDIM];
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        const int m = iv[d] - ic[d]*ratio;
+        int s = -2;
+        if (!is_periodic[d]) {
+            s = amrex::max(s, clo[d]-ic[d]);
+            s = amrex::min(s, chi[d]-4-ic[d]);
+        }
+        ic[d] += s;
+        w[d] = wt.w[s+4][m];
+    }
+    Real r = 0.0;
+#if (AMREX_SPACEDIM == 1)
+    for (int a = 0; a < 5; ++a) {
+        r += w[0][a]*crse(ic[0]+a,0,0,n);
+    }
+#elif (AMREX_SPACEDIM == 2)
+    for (int b = 0; b < 5; ++b) {
+        Real rb = 0.0;
+        for (int a = 0; a < 5; ++a) {
+            rb += w[0][a]*crse(ic[0]+a,ic[1]+b,0,n);
+        }
+        r += w[1][b]*rb;
+    }
+#else
+    for (int c = 0; c < 5; ++c) {
+        for (int b = 0; b < 5; ++b) {
+            Real rb = 0.0;
+            for (int a = 0; a < 5; ++a) {
+                rb += w[0][a]*crse(ic[0]+a,ic[1]+b,ic[2]+c,n);
+            }
+            r += w[1][b]*w[2][c]*rb;
+        }
+    }
+#endif
+    return r;
+}
+
+}
+
 MLMGBndry::MLMGBndry (const BoxArray& _grids,
                       const DistributionMapping& _dmap,
                       int             _ncomp,
@@ -10,6 +90,14 @@ MLMGBndry::MLMGBndry (const BoxArray& _grids,
     : InterpBndryData(_grids,_dmap,_ncomp,_geom)
 {}
 
+MLMGBndry::MLMGBndry (const BoxArray& _grids,
+                      const DistributionMapping& _dmap,
+                      int             _ncomp,
+                      const Geometry& _geom,
+                      const Vector<MultiMask>& _masks)
+    : InterpBndryData(_grids,_dmap,_ncomp,_geom,_masks)
+{}
+
 MLMGBndry::~MLMGBndry () {}
 
 void
@@ -87,4 +175,91 @@ MLMGBndry::setBoxBC (RealTuple& bloc, BCTuple& bctag, const Box& bx, const Box&
     }
 }
 
+void
+MLMGBndry::setCrseData4 (const MultiFab* crse, int ratio, int ncomp)
+{
+    BL_PROFILE("MLMGBndry::setCrseData4()");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ratio >= 2 && ratio <= 4 && boxes().coarsenable(ratio),
+                                     "MLMGBndry::setCrseData4: unsupported refinement ratio");
+
+    // Coarse cells up to two away from the ones next to the fine grids,
+    // and more near the domain boundaries, where the stencils are shifted
+    const int ngrow = 4;
+    const Box& cdomain = amrex::coarsen(geom.Domain(), ratio);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(geom.isPeriodic(idim) || cdomain.length(idim) >= 5,
+                                         "MLMGBndry::setCrseData4: coarse domain too small");
+    }
+
+    if (m_crse4_ratio != ratio || m_crse4.nComp() != ncomp)
+    {
+        BoxArray cba = boxes();
+        cba.coarsen(ratio);
+        m_crse4.define(cba, DistributionMap(), ncomp, ngrow);
+        m_crse4_ratio = ratio;
+        for (int s = -4; s <= 0; ++s) {
+            for (int m = 0; m < ratio; ++m) {
+                crse_fine4_weights(s, m, ratio, m_crse4_weights.w[s+4][m]);
+            }
+        }
+    }
+
+    m_crse4.setVal(0.0);
+    if (crse != nullptr)
+    {
+        const BoxArray& crse_ba = crse->boxArray();
+        const BoxArray& cba = m_crse4.boxArray();
+        for (int i = 0, N = cba.size(); i < N; ++i) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(crse_ba.contains(amrex::grow(cba[i],ngrow-1) & cdomain),
+                                             "MLMGBndry::setCrseData4: coarse data do not cover the stencil");
+        }
+        m_crse4.ParallelCopy(*crse, 0, 0, ncomp, 0, ngrow, geom.periodicity(cdomain));
+    }
+}
+
+void
+MLMGBndry::fillCrseFine4 (MultiFab& fine, int ncomp) const
+{
+    BL_PROFILE("MLMGBndry::fillCrseFine4()");
+
+    AMREX_ALWAYS_ASSERT(hasCrseData4() && fine.nGrow() >= 2);
+
+    const int ratio = m_crse4_ratio;
+    const Box& cdomain = amrex::coarsen(geom.Domain(), ratio);
+    const Dim3 cdlo = amrex::lbound(cdomain);
+    const Dim3 cdhi = amrex::ubound(cdomain);
+    const GpuArray<int,AMREX_SPACEDIM> is_periodic = geom.isPeriodicArray();
+    const CrseFine4Weights wt = m_crse4_weights;
+    const int not_covered = BndryData::not_covered;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(fine); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        Array4<Real> const& phi = fine.array(mfi);
+        Array4<Real const> const& crse = m_crse4.const_array(mfi);
+        for (OrientationIter oitr; oitr; ++oitr)
+        {
+            const Orientation ori = oitr();
+            const int idim = ori.coordDir();
+            // The masks only have the first layer of ghost cells
+            const int imask = ori.isLow() ? vbx.smallEnd(idim)-1 : vbx.bigEnd(idim)+1;
+            const Box& gbx = amrex::adjCell(vbx, ori, 2);
+            Array4<int const> const& mask = masks[ori].array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D (gbx, ncomp, i, j, k, n,
+            {
+                IntVect iv(AMREX_D_DECL(i,j,k));
+                IntVect ivm = iv;
+                ivm[idim] = imask;
+                if (mask(ivm) == not_covered) {
+                    phi(i,j,k,n) = crse_fine4_interp(iv, n, crse, ratio, wt, cdlo, cdhi, is_periodic);
+                }
+            });
+        }
+    }
+}
+
 }
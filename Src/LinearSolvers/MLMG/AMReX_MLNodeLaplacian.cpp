@@ -839,10 +839,13 @@ void
 MLNodeLaplacian::buildStencil ()
 {
     m_stencil.resize(m_num_amr_levels);
+    m_csten.resize(m_num_amr_levels);
     m_s0_norm0.resize(m_num_amr_levels);
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
     {
         m_stencil[amrlev].resize(m_num_mg_levels[amrlev]);
+        m_csten[amrlev].clear();
+        m_csten[amrlev].resize(m_num_mg_levels[amrlev]);
         m_s0_norm0[amrlev].resize(m_num_mg_levels[amrlev],0.0);
     }
     
@@ -1053,6 +1056,51 @@ MLNodeLaplacian::buildStencil ()
         }
     }
 
+    if (m_single_precision_stencil)
+    {
+        const int ncomp_cs = (AMREX_SPACEDIM == 2) ? 3 : 7;
+        for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+        {
+            for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+            {
+                MultiFab& sten = *m_stencil[amrlev][mglev];
+                m_csten[amrlev][mglev].reset
+                    (new FabArray<BaseFab<float> >(sten.boxArray(), sten.DistributionMap(),
+                                                   ncomp_cs, sten.nGrowVect()));
+                auto& csten = *m_csten[amrlev][mglev];
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+                for (MFIter mfi(sten,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+                {
+                    const Box& bx = mfi.growntilebox();
+                    Array4<Real> const& starr = sten.array(mfi);
+                    Array4<float> const& csarr = csten.array(mfi);
+                    AMREX_HOST_DEVICE_PARALLEL_FOR_3D(bx, i, j, k,
+                    {
+                        mlndlap_set_csten(i,j,k,starr,csarr);
+                    });
+                }
+
+                // The diagonal of the rounded stencil
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+                for (MFIter mfi(sten,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+                {
+                    const Box& bx = mfi.tilebox();
+                    Array4<Real> const& starr = sten.array(mfi);
+                    AMREX_HOST_DEVICE_PARALLEL_FOR_3D(bx, i, j, k,
+                    {
+                        mlndlap_set_stencil_s0(i,j,k,starr);
+                    });
+                }
+
+                sten.FillBoundary(m_geom[amrlev][mglev].periodicity());
+            }
+        }
+    }
 
     // This is only needed at the bottom.
     m_s0_norm0[0].back() = m_stencil[0].back()->norm0(0,0) * m_normalization_threshold;
@@ -1352,6 +1400,7 @@ MLNodeLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
 
     const auto& sigma = m_sigma[amrlev][mglev];
     const auto& stencil = m_stencil[amrlev][mglev];
+    const auto& csten = m_csten[amrlev][mglev];
     const auto dxinvarr = m_geom[amrlev][mglev].InvCellSizeArray();
 #if (AMREX_SPACEDIM == 2)
     bool is_rz = m_is_rz;
@@ -1369,7 +1418,16 @@ MLNodeLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
         Array4<Real> const& yarr = out.array(mfi);
         Array4<int const> const& dmskarr = dmsk.const_array(mfi);
 
-        if (m_coarsening_strategy == CoarseningStrategy::RAP)
+        if (m_coarsening_strategy == CoarseningStrategy::RAP && csten)
+        {
+            Array4<Real const> const& stenarr = stencil->const_array(mfi);
+            Array4<float const> const& cstarr = csten->const_array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_3D ( bx, i, j, k,
+            {
+                mlndlap_adotx_csten(i,j,k,yarr,xarr,stenarr,cstarr,dmskarr);
+            });
+        }
+        else if (m_coarsening_strategy == CoarseningStrategy::RAP)
         {
             Array4<Real const> const& stenarr = stencil->const_array(mfi);
             AMREX_HOST_DEVICE_PARALLEL_FOR_3D ( bx, i, j, k,
@@ -1421,6 +1479,7 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
 
     const auto& sigma = m_sigma[amrlev][mglev];
     const auto& stencil = m_stencil[amrlev][mglev];
+    const auto& csten = m_csten[amrlev][mglev];
     const auto dxinvarr = m_geom[amrlev][mglev].InvCellSizeArray();
 #if (AMREX_SPACEDIM == 2)
     bool is_rz = m_is_rz;
@@ -1434,7 +1493,31 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
         constexpr int nsweeps = 4;
         MultiFab Ax(sol.boxArray(), sol.DistributionMap(), 1, 0);
 
-        if (m_coarsening_strategy == CoarseningStrategy::RAP)
+        if (m_coarsening_strategy == CoarseningStrategy::RAP && csten)
+        {
+            for (MFIter mfi(sol); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.validbox();
+                Array4<Real> const& solarr = sol.array(mfi);
+                Array4<Real const> const& rhsarr = rhs.const_array(mfi);
+                Array4<Real const> const& starr = stencil->const_array(mfi);
+                Array4<float const> const& cstarr = csten->const_array(mfi);
+                Array4<int const> const& dmskarr = dmsk.const_array(mfi);
+                Array4<Real> const& Axarr = Ax.array(mfi);
+
+                for (int ns = 0; ns < nsweeps; ++ns) {
+                    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                    {
+                        mlndlap_adotx_csten(i,j,k,Axarr,solarr,starr,cstarr,dmskarr);
+                    });
+                    AMREX_LAUNCH_DEVICE_LAMBDA ( bx, tbx,
+                    {
+                        mlndlap_jacobi_sten(tbx,solarr,Axarr,rhsarr,starr,dmskarr);
+                    });
+                }
+            }
+        }
+        else if (m_coarsening_strategy == CoarseningStrategy::RAP)
         {
             for (MFIter mfi(sol); mfi.isValid(); ++mfi)
             {
@@ -1543,8 +1626,11 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                     Array4<Real const> const& starr = stencil->const_array(mfi);
                     Array4<int const> const& dmskarr = dmsk.const_array(mfi);
 
-                    for (int ns = 0; ns < nsweeps; ++ns) {
-                        mlndlap_gauss_seidel_sten(bx,solarr,rhsarr,starr,dmskarr);
+                    if (csten) {
+                        Array4<float const> const& cstarr = csten->const_array(mfi);
+                        mlndlap_gauss_seidel_csten(bx,solarr,rhsarr,starr,cstarr,dmskarr,nsweeps);
+                    } else {
+                        mlndlap_gauss_seidel_sten(bx,solarr,rhsarr,starr,dmskarr,nsweeps);
                     }
                 }
             }
@@ -2547,7 +2633,10 @@ MLNodeLaplacian::buildIntegral ()
 #else
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
     {
-        amrex::algoim::compute_integrals(*m_integral[amrlev]);
+        auto factory = dynamic_cast<EBFArrayBoxFactory const*>(m_factory[amrlev][0].get());
+        if (factory) {
+            amrex::algoim::compute_integrals(*m_integral[amrlev]);
+        }
     }
 #endif
 }
@@ -28,8 +28,25 @@ MLNodeLinOp::define (const Vector<Geometry>& a_geom,
 #else
     bool eb_limit_coarsening = false;
 #endif
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!a_info.semicoarsening_anisotropic,
+                                     "MLNodeLinOp: semicoarsening_anisotropic not supported");
     MLLinOp::define(a_geom, a_grids, a_dmap, a_info, a_factory, eb_limit_coarsening);
 
+    using OwnerMasks = Vector<Vector<std::unique_ptr<iMultiFab> > >;
+    std::shared_ptr<void>& shared_owner_mask = sharedData("MLNodeLinOp::owner_mask");
+    if (!shared_owner_mask) {
+        auto owner_mask = std::make_shared<OwnerMasks>(m_num_amr_levels);
+        for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev) {
+            for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev) {
+                (*owner_mask)[amrlev].push_back(makeOwnerMask(m_grids[amrlev][mglev],
+                                                              m_dmap[amrlev][mglev],
+                                                              m_geom[amrlev][mglev]));
+            }
+        }
+        shared_owner_mask = owner_mask;
+    }
+    const auto& owner_mask = *std::static_pointer_cast<OwnerMasks>(shared_owner_mask);
+
     m_owner_mask.resize(m_num_amr_levels);
     m_dirichlet_mask.resize(m_num_amr_levels);
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev) {
@@ -37,9 +54,8 @@ MLNodeLinOp::define (const Vector<Geometry>& a_geom,
         m_dirichlet_mask[amrlev].resize(m_num_mg_levels[amrlev]);
         for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
         {
-            m_owner_mask[amrlev][mglev] = makeOwnerMask(m_grids[amrlev][mglev],
-                                                        m_dmap[amrlev][mglev],
-                                                        m_geom[amrlev][mglev]);
+            m_owner_mask[amrlev][mglev].reset(new iMultiFab(*owner_mask[amrlev][mglev],
+                                                            amrex::make_alias, 0, 1));
             m_dirichlet_mask[amrlev][mglev].reset
                 (new iMultiFab(amrex::convert(m_grids[amrlev][mglev],IntVect::TheNodeVector()),
                                m_dmap[amrlev][mglev], 1, 0));
@@ -151,11 +167,17 @@ MLNodeLinOp::xdoty (int amrlev, int mglev, const MultiFab& x, const MultiFab& y,
     for (int i = 0; i < ncomp; i++) {
         MultiFab::Multiply(tmp, mask, 0, i, 1, nghost);
     }
-    Real result = MultiFab::Dot(tmp,0,y,0,ncomp,nghost,true);
-    if (!local) {
-        ParallelAllReduce::Sum(result, ParallelContext::CommunicatorSub());
-    }
-    return result;
+    return MultiFab::Dot(tmp,0,y,0,ncomp,nghost,local);
+}
+
+bool
+MLNodeLinOp::getDotMask (int amrlev, int mglev, const MultiFab*& mask) const
+{
+    amrex::ignore_unused(amrlev);
+    AMREX_ASSERT(amrlev==0);
+    AMREX_ASSERT(mglev+1==m_num_mg_levels[0] || mglev==0);
+    mask = (mglev+1 == m_num_mg_levels[0]) ? &m_bottom_dot_mask : &m_coarse_dot_mask;
+    return true;
 }
 
 void
@@ -152,6 +152,18 @@ void
 MLPoisson::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, int redblack) const
 {
     BL_PROFILE("MLPoisson::Fsmooth()");
+#ifdef AMREX_TINY_PROFILING
+    {
+        // Estimate per cell and component: sol and rhs are read, half of sol
+        // is written and updated with about 2*dim+4 flops.
+        double npts = 0.0;
+        for (int i : sol.IndexArray()) {
+            npts += static_cast<double>(sol.box(i).numPts());
+        }
+        npts *= getNComp();
+        BL_PROFILE_WORK(npts*3*sizeof(Real), npts*(AMREX_SPACEDIM+2));
+    }
+#endif
 
     const auto& undrrelxr = m_undrrelxr[amrlev][mglev];
     const auto& maskvals  = m_maskvals [amrlev][mglev];
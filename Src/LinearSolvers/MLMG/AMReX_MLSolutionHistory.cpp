@@ -0,0 +1,445 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <AMReX_MLSolutionHistory.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_Reduce.H>
+
+namespace amrex {
+
+namespace {
+
+// Eigenvalues and eigenvectors of the symmetric n x n matrix a by cyclic
+// Jacobi rotations.  On return, the diagonal of a holds the eigenvalues
+// and the columns of v the eigenvectors.  Both are stored by rows.
+void
+jacobi_eigen (int n, Vector<Real>& a, Vector<Real>& v)
+{
+    v.assign(n*n, 0.0);
+    for (int i = 0; i < n; ++i) v[i*n+i] = 1.0;
+
+    for (int sweep = 0; sweep < 50; ++sweep)
+    {
+        Real off = 0.0, diag = 0.0;
+        for (int p = 0; p < n; ++p) {
+            diag += a[p*n+p]*a[p*n+p];
+            for (int q = p+1; q < n; ++q) off += a[p*n+q]*a[p*n+q];
+        }
+        if (off <= std::numeric_limits<Real>::epsilon()*std::numeric_limits<Real>::epsilon()*diag) {
+            break;
+        }
+
+        for (int p = 0; p < n-1; ++p) {
+            for (int q = p+1; q < n; ++q) {
+                const Real apq = a[p*n+q];
+                if (apq == 0.0) continue;
+                const Real theta = (a[q*n+q]-a[p*n+p]) / (2.0*apq);
+                const Real t = std::copysign(Real(1.0), theta)
+                    / (std::abs(theta) + std::sqrt(theta*theta+1.0));
+                const Real c = 1.0/std::sqrt(t*t+1.0);
+                const Real s = t*c;
+                for (int k = 0; k < n; ++k) {
+                    const Real akp = a[k*n+p], akq = a[k*n+q];
+                    a[k*n+p] = c*akp - s*akq;
+                    a[k*n+q] = s*akp + c*akq;
+                }
+                for (int k = 0; k < n; ++k) {
+                    const Real apk = a[p*n+k], aqk = a[q*n+k];
+                    a[p*n+k] = c*apk - s*aqk;
+                    a[q*n+k] = s*apk + c*aqk;
+                }
+                for (int k = 0; k < n; ++k) {
+                    const Real vkp = v[k*n+p], vkq = v[k*n+q];
+                    v[k*n+p] = c*vkp - s*vkq;
+                    v[k*n+q] = s*vkp + c*vkq;
+                }
+            }
+        }
+    }
+}
+
+template <class FX, class FY>
+Real
+dot_local (const FabArray<FX>& x, const FabArray<FY>& y, const MultiFab* mask)
+{
+    const int ncomp = x.nComp();
+    ReduceOps<ReduceOpSum> reduce_op;
+    ReduceData<Real> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(x, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        auto const& xa = x.const_array(mfi);
+        auto const& ya = y.const_array(mfi);
+        if (mask) {
+            auto const& ma = mask->const_array(mfi);
+            reduce_op.eval(bx, ncomp, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) -> ReduceTuple
+            {
+                return { Real(xa(i,j,k,n)) * Real(ya(i,j,k,n)) * ma(i,j,k) };
+            });
+        } else {
+            reduce_op.eval(bx, ncomp, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) -> ReduceTuple
+            {
+                return { Real(xa(i,j,k,n)) * Real(ya(i,j,k,n)) };
+            });
+        }
+    }
+    return amrex::get<0>(reduce_data.value(ParallelContext::CommunicatorSub()));
+}
+
+template <class FD, class FS>
+void
+copy_into (FabArray<FD>& dst, const FabArray<FS>& src)
+{
+    using T = typename FD::value_type;
+    const int ncomp = dst.nComp();
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dst, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        auto const& d = dst.array(mfi);
+        auto const& s = src.const_array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, ncomp, i, j, k, n,
+        {
+            d(i,j,k,n) = static_cast<T>(s(i,j,k,n));
+        });
+    }
+}
+
+template <class FX>
+void
+saxpy (MultiFab& y, Real a, const FabArray<FX>& x)
+{
+    const int ncomp = y.nComp();
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(y, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        auto const& ya = y.array(mfi);
+        auto const& xa = x.const_array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, ncomp, i, j, k, n,
+        {
+            ya(i,j,k,n) += a * Real(xa(i,j,k,n));
+        });
+    }
+}
+
+}
+
+MLSolutionHistory::MLSolutionHistory (MLMG& a_mlmg, int a_max_size, Precision a_precision)
+    : mlmg(a_mlmg),
+      Lp(a_mlmg.linop),
+      m_max_size(a_max_size),
+      m_precision(a_precision)
+{
+    AMREX_ALWAYS_ASSERT(m_max_size >= 1);
+}
+
+MLSolutionHistory::~MLSolutionHistory ()
+{}
+
+void
+MLSolutionHistory::clear ()
+{
+    m_size = 0;
+    m_next = 0;
+    m_guess_ratio = 1.0;
+    m_x.clear();
+    m_lx.clear();
+    m_gram.clear();
+    m_dot_mask.clear();
+    m_grids.clear();
+    m_dmap.clear();
+    m_zero.clear();
+    m_res0.clear();
+    m_res.clear();
+}
+
+Real
+MLSolutionHistory::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs,
+                          Real a_tol_rel, Real a_tol_abs)
+{
+    BL_PROFILE("MLSolutionHistory::solve()");
+
+    makeInitialGuess(a_sol, a_rhs);
+    const Real r = mlmg.solve(a_sol, a_rhs, a_tol_rel, a_tol_abs);
+    // The residual of a zero solution is still that of makeInitialGuess.
+    addWithZeroResidual(a_sol, a_rhs);
+    return r;
+}
+
+int
+MLSolutionHistory::makeInitialGuess (const Vector<MultiFab*>& a_sol,
+                                     const Vector<MultiFab const*>& a_rhs)
+{
+    BL_PROFILE("MLSolutionHistory::makeInitialGuess()");
+
+    checkLayout(a_sol);
+
+    makeZeroResidual(a_rhs);
+
+    m_guess_ratio = 1.0;
+    const int n = m_size;
+    if (n == 0) return 0;
+
+    const Real rr = dot(Vec(), m_res0);
+    if (rr == 0.0) return 0;
+
+    Vector<Real> q(n);
+    Vector<Real> g(n*n);
+    for (int i = 0; i < n; ++i) {
+        q[i] = dot(m_lx[i], m_res0);
+        for (int j = 0; j < n; ++j) {
+            g[i*n+j] = m_gram[i*m_max_size+j];
+        }
+    }
+
+    // Least squares via the eigenvectors of the Gram matrix.  Modes whose
+    // eigenvalues are lost in the round-off of the Gram matrix are dropped.
+    // Single precision storage does not need a larger threshold, because
+    // the Gram matrix is that of the rounded L(x_i) and therefore positive
+    // semidefinite up to double-precision round-off.
+    Vector<Real> v;
+    jacobi_eigen(n, g, v);
+    Real lmax = 0.0;
+    for (int m = 0; m < n; ++m) lmax = std::max(lmax, g[m*n+m]);
+    const Real tol = 1.e-12;
+
+    Vector<Real> c(n, 0.0);
+    int nmodes = 0;
+    for (int m = 0; m < n; ++m) {
+        const Real lm = g[m*n+m];
+        if (lm > tol*lmax) {
+            ++nmodes;
+            Real vq = 0.0;
+            for (int i = 0; i < n; ++i) vq += v[i*n+m]*q[i];
+            for (int i = 0; i < n; ++i) c[i] += v[i*n+m]*vq/lm;
+        }
+    }
+
+    // |res0 - sum_i c_i L(x_i)|^2
+    Real rg = rr;
+    for (int i = 0; i < n; ++i) {
+        rg -= 2.0*c[i]*q[i];
+        for (int j = 0; j < n; ++j) {
+            rg += c[i]*m_gram[i*m_max_size+j]*c[j];
+        }
+    }
+    m_guess_ratio = std::sqrt(std::max(rg,Real(0.0))/rr);
+
+    for (auto* mf : a_sol) {
+        mf->setVal(0.0);
+    }
+    for (int i = 0; i < n; ++i) {
+        addTo(a_sol, c[i], m_x[i]);
+    }
+
+    if (verbose >= 1) {
+        amrex::Print() << "MLSolutionHistory: initial guess from " << nmodes << " of " << n
+                       << " modes, 2-norm resid/resid(0) = " << m_guess_ratio << "\n";
+    }
+
+    return nmodes;
+}
+
+void
+MLSolutionHistory::add (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs)
+{
+    BL_PROFILE("MLSolutionHistory::add()");
+
+    checkLayout(a_sol);
+
+    makeZeroResidual(a_rhs);
+    addWithZeroResidual(a_sol, a_rhs);
+}
+
+// L(sol) with homogeneous boundary conditions is the residual of a zero
+// solution minus that of sol, both with the current boundary data.
+void
+MLSolutionHistory::addWithZeroResidual (const Vector<MultiFab*>& a_sol,
+                                        const Vector<MultiFab const*>& a_rhs)
+{
+    const int namrlevs = Lp.NAMRLevels();
+    const int ncomp = Lp.getNComp();
+
+    if (m_res.empty()) {
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            m_res.emplace_back(m_grids[alev], m_dmap[alev], ncomp, 0, MFInfo(),
+                               a_sol[alev]->Factory());
+        }
+    }
+    mlmg.compResidual(GetVecOfPtrs(m_res), a_sol, a_rhs);
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        MultiFab::Xpay(m_res[alev], Real(-1.0), m_res0[alev], 0, 0, ncomp, 0);
+    }
+
+    if (m_x.empty()) {
+        m_x.resize(m_max_size);
+        m_lx.resize(m_max_size);
+        m_gram.assign(m_max_size*m_max_size, 0.0);
+    }
+
+    const int slot = m_next;
+    if (m_x[slot].d.empty() && m_x[slot].f.empty()) {
+        define(m_x[slot]);
+        define(m_lx[slot]);
+    }
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        store(m_x[slot], alev, *a_sol[alev]);
+        store(m_lx[slot], alev, m_res[alev]);
+    }
+    m_size = std::min(m_size+1, m_max_size);
+    m_next = (m_next+1) % m_max_size;
+
+    // The Gram matrix is that of the stored vectors, so that the least
+    // squares problem is consistent in single precision.  The stored L(x_i)
+    // is the rounded L of the unrounded x_i, not L of the stored x_i.
+    for (int j = 0; j < m_size; ++j) {
+        const Real gij = dot(m_lx[slot], m_lx[j]);
+        m_gram[slot*m_max_size+j] = gij;
+        m_gram[j*m_max_size+slot] = gij;
+    }
+}
+
+void
+MLSolutionHistory::makeZeroResidual (const Vector<MultiFab const*>& a_rhs)
+{
+    const int namrlevs = Lp.NAMRLevels();
+    const int ncomp = Lp.getNComp();
+    if (m_zero.empty()) {
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            m_zero.emplace_back(m_grids[alev], m_dmap[alev], ncomp, 1, MFInfo(),
+                                a_rhs[alev]->Factory());
+            m_zero[alev].setVal(0.0);
+            m_res0.emplace_back(m_grids[alev], m_dmap[alev], ncomp, 0, MFInfo(),
+                                a_rhs[alev]->Factory());
+        }
+    }
+    mlmg.compResidual(GetVecOfPtrs(m_res0), GetVecOfPtrs(m_zero), a_rhs);
+}
+
+// Clears the history if the grids have changed.
+void
+MLSolutionHistory::checkLayout (const Vector<MultiFab*>& a_sol)
+{
+    const int namrlevs = Lp.NAMRLevels();
+    bool same = static_cast<int>(m_grids.size()) == namrlevs;
+    for (int alev = 0; alev < namrlevs && same; ++alev) {
+        same = a_sol[alev]->boxArray() == m_grids[alev]
+            && a_sol[alev]->DistributionMap() == m_dmap[alev];
+    }
+    if (!same) {
+        clear();
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            m_grids.push_back(a_sol[alev]->boxArray());
+            m_dmap.push_back(a_sol[alev]->DistributionMap());
+        }
+        buildDotMasks();
+    }
+}
+
+// Cells covered by finer levels are not counted.  Nodes shared by boxes
+// are counted once on the coarsest level only.
+void
+MLSolutionHistory::buildDotMasks ()
+{
+    const int namrlevs = Lp.NAMRLevels();
+    m_dot_mask.clear();
+    m_dot_mask.resize(namrlevs);
+    if (Lp.isCellCentered()) {
+        for (int alev = 0; alev < namrlevs-1; ++alev) {
+            m_dot_mask[alev].reset(new MultiFab(amrex::makeFineMask(m_grids[alev], m_dmap[alev],
+                                                                    m_grids[alev+1],
+                                                                    IntVect(Lp.AMRRefRatio(alev)),
+                                                                    1.0, 0.0)));
+        }
+    } else {
+        const MultiFab* mask = nullptr;
+        if (Lp.getDotMask(0, 0, mask) && mask) {
+            m_dot_mask[0].reset(new MultiFab(mask->boxArray(), mask->DistributionMap(), 1, 0));
+            MultiFab::Copy(*m_dot_mask[0], *mask, 0, 0, 1, 0);
+        }
+    }
+}
+
+void
+MLSolutionHistory::define (Vec& v) const
+{
+    const int namrlevs = Lp.NAMRLevels();
+    const int ncomp = Lp.getNComp();
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        if (m_precision == Precision::Single) {
+            v.f.emplace_back(new FabArray<BaseFab<float> >(m_grids[alev], m_dmap[alev], ncomp, 0));
+        } else {
+            v.d.emplace_back(new MultiFab(m_grids[alev], m_dmap[alev], ncomp, 0));
+        }
+    }
+}
+
+void
+MLSolutionHistory::store (Vec& v, int amrlev, const MultiFab& src) const
+{
+    if (m_precision == Precision::Single) {
+        copy_into(*v.f[amrlev], src);
+    } else {
+        MultiFab::Copy(*v.d[amrlev], src, 0, 0, src.nComp(), 0);
+    }
+}
+
+// v . w over all AMR levels.  An empty v stands for w.
+Real
+MLSolutionHistory::dot (const Vec& v, const Vector<MultiFab>& w) const
+{
+    Real r = 0.0;
+    for (int alev = 0; alev < static_cast<int>(w.size()); ++alev) {
+        const MultiFab* mask = m_dot_mask[alev].get();
+        if (!v.f.empty()) {
+            r += dot_local(*v.f[alev], w[alev], mask);
+        } else if (!v.d.empty()) {
+            r += dot_local(*v.d[alev], w[alev], mask);
+        } else {
+            r += dot_local(w[alev], w[alev], mask);
+        }
+    }
+    return r;
+}
+
+Real
+MLSolutionHistory::dot (const Vec& v, const Vec& w) const
+{
+    Real r = 0.0;
+    for (int alev = 0; alev < static_cast<int>(m_grids.size()); ++alev) {
+        const MultiFab* mask = m_dot_mask[alev].get();
+        if (m_precision == Precision::Single) {
+            r += dot_local(*v.f[alev], *w.f[alev], mask);
+        } else {
+            r += dot_local(*v.d[alev], *w.d[alev], mask);
+        }
+    }
+    return r;
+}
+
+void
+MLSolutionHistory::addTo (Vector<MultiFab*> const& y, Real a, const Vec& x) const
+{
+    for (int alev = 0; alev < static_cast<int>(y.size()); ++alev) {
+        if (m_precision == Precision::Single) {
+            saxpy(*y[alev], a, *x.f[alev]);
+        } else {
+            saxpy(*y[alev], a, *x.d[alev]);
+        }
+    }
+}
+
+}
@@ -204,16 +204,23 @@ MLTensorOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc
 #if (AMREX_SPACEDIM > 1)
     BL_PROFILE("MLTensorOp::apply()");
 
-    MLABecLaplacian::apply(amrlev, mglev, out, in, bc_mode, s_mode, bndry);
-
-    if (mglev >= m_kappa[amrlev].size()) return;
+    if (mglev >= m_kappa[amrlev].size()) {
+        MLABecLaplacian::apply(amrlev, mglev, out, in, bc_mode, s_mode, bndry);
+        return;
+    }
 
+    // The ABecLaplacian part and the cross terms are fused.  The fluxes of
+    // both are computed together in tile-local scratch space, and their
+    // divergence is the only pass over out.
+    applyBC(amrlev, mglev, in, bc_mode, s_mode, bndry);
     applyBCTensor(amrlev, mglev, in, bc_mode, s_mode, bndry );
 
     const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
 
+    MultiFab const& amf = m_a_coeffs[amrlev][mglev];
     Array<MultiFab,AMREX_SPACEDIM> const& etamf = m_b_coeffs[amrlev][mglev];
     Array<MultiFab,AMREX_SPACEDIM> const& kapmf = m_kappa[amrlev][mglev];
+    Real ascalar = m_a_scalar;
     Real bscalar = m_b_scalar;
 
 #ifdef _OPENMP
@@ -226,6 +233,7 @@ MLTensorOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc
             const Box& bx = mfi.tilebox();
             Array4<Real> const axfab = out.array(mfi);
             Array4<Real const> const vfab = in.const_array(mfi);
+            Array4<Real const> const afab = amf.const_array(mfi);
             AMREX_D_TERM(Array4<Real const> const etaxfab = etamf[0].const_array(mfi);,
                          Array4<Real const> const etayfab = etamf[1].const_array(mfi);,
                          Array4<Real const> const etazfab = etamf[2].const_array(mfi););
@@ -248,15 +256,15 @@ MLTensorOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc
             AMREX_LAUNCH_HOST_DEVICE_LAMBDA_DIM
             ( xbx, txbx,
               {
-                  mltensor_cross_terms_fx(txbx,fxfab,vfab,etaxfab,kapxfab,dxinv);
+                  mltensor_fused_fx(txbx,fxfab,vfab,etaxfab,kapxfab,dxinv);
               }
             , ybx, tybx,
               {
-                  mltensor_cross_terms_fy(tybx,fyfab,vfab,etayfab,kapyfab,dxinv);
+                  mltensor_fused_fy(tybx,fyfab,vfab,etayfab,kapyfab,dxinv);
               }
             , zbx, tzbx,
               {
-                  mltensor_cross_terms_fz(tzbx,fzfab,vfab,etazfab,kapzfab,dxinv);
+                  mltensor_fused_fz(tzbx,fzfab,vfab,etazfab,kapzfab,dxinv);
               }
             );
 
@@ -264,14 +272,14 @@ MLTensorOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc
                 const auto& osm = m_overset_mask[amrlev][mglev]->array(mfi);
                 AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
                 {
-                    mltensor_cross_terms_os(tbx, axfab, AMREX_D_DECL(fxfab,fyfab,fzfab),
-                                            osm, dxinv, bscalar);
+                    mltensor_fused_adotx_os(tbx, axfab, vfab, afab, AMREX_D_DECL(fxfab,fyfab,fzfab),
+                                            osm, dxinv, ascalar, bscalar);
                 });
             } else {
                 AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
                 {
-                    mltensor_cross_terms(tbx, axfab, AMREX_D_DECL(fxfab,fyfab,fzfab),
-                                         dxinv, bscalar);
+                    mltensor_fused_adotx(tbx, axfab, vfab, afab, AMREX_D_DECL(fxfab,fyfab,fzfab),
+                                         dxinv, ascalar, bscalar);
                 });
             }
         }
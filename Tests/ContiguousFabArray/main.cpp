@@ -0,0 +1,204 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Utility.H>
+
+#include <cmath>
+#include <iomanip>
+#include <string>
+#include <utility>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, std::string const& what)
+{
+    amrex::Print() << "  " << std::left << std::setw(60) << what
+                   << (ok ? "passed" : "FAILED") << "\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ok, what.c_str());
+}
+
+void fill (MultiFab& mf, Real shift)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.fabbox(), mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = std::sin(Real(0.1)*(AMREX_D_TERM(i,+2*j,+3*k)) + n + shift);
+        });
+    }
+}
+
+bool equal (MultiFab const& a, MultiFab const& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), a.nGrowVect());
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), a.nGrowVect());
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), a.nGrowVect());
+    return d.norm0(0, d.nGrow()) == 0.;
+}
+
+// The contiguous MultiFabs must give the same results as the default ones.
+void check_ops (BoxArray const& ba, DistributionMapping const& dm, int ncomp, int nghost)
+{
+    const MFInfo contig = MFInfo().SetContiguous(true);
+    MultiFab x(ba, dm, ncomp, nghost), y(ba, dm, ncomp, nghost), z(ba, dm, ncomp, nghost);
+    MultiFab xc(ba, dm, ncomp, nghost, contig), yc(ba, dm, ncomp, nghost, contig);
+    MultiFab zc(ba, dm, ncomp, nghost, contig);
+
+    check(xc.isContiguous() && !x.isContiguous(), "slab allocation");
+    bool ok = true;
+    for (MFIter mfi(xc); mfi.isValid(); ++mfi) {
+        const int li = mfi.LocalIndex();
+        ok = ok && xc[mfi].dataPtr() == xc.slabData() + xc.slabOffset(li)
+                && xc[mfi].size() == ((li+1 < xc.local_size()) ? xc.slabOffset(li+1)
+                                                                : xc.slabSize())
+                                     - xc.slabOffset(li);
+    }
+    check(ok, "offset table");
+
+    fill(x, 0.);  fill(xc, 0.);
+    fill(y, 1.);  fill(yc, 1.);
+    check(equal(x,xc) && equal(y,yc), "filling through MFIter");
+
+    z.setVal(3.);  zc.setVal(3.);
+    check(equal(z,zc), "setVal");
+
+    MultiFab::Copy(z, x, 0, 0, ncomp, nghost);
+    MultiFab::Copy(zc, xc, 0, 0, ncomp, nghost);
+    check(equal(z,zc), "Copy");
+
+    MultiFab::Add(z, y, 0, 0, ncomp, nghost);
+    MultiFab::Add(zc, yc, 0, 0, ncomp, nghost);
+    check(equal(z,zc), "Add");
+
+    MultiFab::Saxpy(z, 0.5, y, 0, 0, ncomp, nghost);
+    MultiFab::Saxpy(zc, 0.5, yc, 0, 0, ncomp, nghost);
+    check(equal(z,zc), "Saxpy");
+
+    MultiFab::Xpay(z, 0.25, x, 0, 0, ncomp, nghost);
+    MultiFab::Xpay(zc, 0.25, xc, 0, 0, ncomp, nghost);
+    check(equal(z,zc), "Xpay");
+
+    MultiFab::LinComb(z, 2., x, 0, -1., z, 0, 0, ncomp, nghost);
+    MultiFab::LinComb(zc, 2., xc, 0, -1., zc, 0, 0, ncomp, nghost);
+    check(equal(z,zc), "LinComb with aliased arguments");
+
+    const Real d = MultiFab::Dot(x, 0, y, 0, ncomp, nghost);
+    const Real dc = MultiFab::Dot(xc, 0, yc, 0, ncomp, nghost);
+    const Real n = MultiFab::Dot(x, 0, ncomp, nghost);
+    const Real nc = MultiFab::Dot(xc, 0, ncomp, nghost);
+    check(std::abs(d-dc) <= 1.e-12*std::abs(d) && std::abs(n-nc) <= 1.e-12*n, "Dot");
+
+    // Only some of the components or ghost cells, which do not use the slabs
+    if (nghost > 0) {
+        z.setVal(0.);  zc.setVal(0.);
+        MultiFab::LinComb(z, 2., x, 0, -1., y, 0, 0, ncomp, nghost-1);
+        MultiFab::LinComb(zc, 2., xc, 0, -1., yc, 0, 0, ncomp, nghost-1);
+        check(equal(z,zc), "LinComb on fewer ghost cells");
+    }
+
+    // Moving the slab
+    MultiFab tmp(std::move(zc));
+    std::swap(tmp, xc);
+    check(xc.isContiguous() && !zc.isContiguous() && equal(xc,z), "move and swap");
+}
+
+// Time per call of f in microseconds
+template <class F>
+Real timeit (int nsteps, F&& f)
+{
+    f();
+    Real t = amrex::second();
+    for (int step = 0; step < nsteps; ++step) {
+        f();
+    }
+    t = amrex::second() - t;
+    ParallelDescriptor::ReduceRealMax(t);
+    return t/nsteps*1.e6;
+}
+
+void benchmark (Box const& domain, int max_grid_size, int ncomp, int nghost, int nsteps)
+{
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    amrex::Print() << "\n" << ba.size() << " boxes of size " << max_grid_size << "\n"
+                   << "  " << std::left << std::setw(24) << "microseconds per call"
+                   << std::right << std::setw(14) << "default"
+                   << std::setw(14) << "contiguous" << std::setw(10) << "speedup" << "\n";
+
+    const MFInfo infos[2] = {MFInfo(), MFInfo().SetContiguous(true)};
+    const std::string names[] = {"define", "setVal", "Copy", "LinComb", "Dot", "FillBoundary"};
+    Real t[6][2];
+
+    for (int m = 0; m < 2; ++m)
+    {
+        MFInfo const& info = infos[m];
+        t[0][m] = timeit(nsteps, [&] () {
+            MultiFab mf(ba, dm, ncomp, nghost, info);
+        });
+
+        MultiFab x(ba, dm, ncomp, nghost, info), y(ba, dm, ncomp, nghost, info);
+        MultiFab z(ba, dm, ncomp, nghost, info);
+        fill(x, 0.);
+        fill(y, 1.);
+        t[1][m] = timeit(nsteps, [&] () { z.setVal(1.); });
+        t[2][m] = timeit(nsteps, [&] () { MultiFab::Copy(z, x, 0, 0, ncomp, nghost); });
+        t[3][m] = timeit(nsteps, [&] () {
+            MultiFab::LinComb(z, 2., x, 0, 3., y, 0, 0, ncomp, nghost);
+        });
+        Real sum = 0.;
+        t[4][m] = timeit(nsteps, [&] () { sum += MultiFab::Dot(x, 0, y, 0, ncomp, nghost); });
+        t[5][m] = timeit(nsteps, [&] () { z.FillBoundary(); });
+        amrex::ignore_unused(sum);
+    }
+
+    for (int i = 0; i < 6; ++i) {
+        amrex::Print() << "  " << std::left << std::setw(24) << names[i] << std::right
+                       << std::fixed << std::setprecision(1)
+                       << std::setw(14) << t[i][0] << std::setw(14) << t[i][1]
+                       << std::setprecision(2) << std::setw(10) << t[i][0]/t[i][1]
+                       << std::defaultfloat << "\n";
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 128;
+        Vector<int> box_sizes{8, 16};
+        int ncomp = 1;
+        int nghost = 1;
+        int nsteps = 20;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.queryarr("box_sizes", box_sizes);
+            pp.query("ncomp", ncomp);
+            pp.query("nghost", nghost);
+            pp.query("nsteps", nsteps);
+        }
+
+        Box domain(IntVect(0), IntVect(n_cell-1));
+
+        amrex::Print() << "Checking the contiguous MultiFab operations\n";
+        {
+            BoxArray ba(Box(IntVect(0), IntVect(31)));
+            ba.maxSize(8);
+            DistributionMapping dm(ba);
+            check_ops(ba, dm, 2, 2);
+        }
+
+        for (int max_grid_size : box_sizes) {
+            benchmark(domain, max_grid_size, ncomp, nghost, nsteps);
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,188 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF_Sphere.H>
+
+#include <cstring>
+
+using namespace amrex;
+
+namespace {
+
+// Compare all the EB data of two IndexSpaces on the levels from geom
+// down max_coarsening_level times.  Returns the number of mismatches.
+int compare (EB2::IndexSpace const& a, EB2::IndexSpace const& b,
+             Geometry const& geom, int max_coarsening_level, int max_grid_size)
+{
+    int nerrors = 0;
+    for (int ilev = 0; ilev <= max_coarsening_level; ++ilev)
+    {
+        Geometry lgeom(amrex::coarsen(geom.Domain(),1<<ilev), geom.ProbDomain(),
+                       geom.Coord(), geom.isPeriodic());
+        EB2::Level const& la = a.getLevel(lgeom);
+        EB2::Level const& lb = b.getLevel(lgeom);
+
+        BoxArray ba(lgeom.Domain());
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const int ng = 1;
+        FabArray<EBCellFlagFab> fa(ba, dm, 1, ng), fb(ba, dm, 1, ng);
+        la.fillEBCellFlag(fa, lgeom);
+        lb.fillEBCellFlag(fb, lgeom);
+        for (MFIter mfi(fa); mfi.isValid(); ++mfi) {
+            auto const& x = fa.const_array(mfi);
+            auto const& y = fb.const_array(mfi);
+            const Box& bx = mfi.growntilebox() & lgeom.Domain();
+            amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+            {
+                if (x(i,j,k).getValue() != y(i,j,k).getValue()) ++nerrors;
+            });
+            if (fa[mfi].getType() != fb[mfi].getType()) ++nerrors;
+        }
+
+        // Bitwise comparison, because some of the data are never set
+        // (e.g., centroids of regular boxes) and must be copied verbatim.
+        auto comp = [&] (MultiFab const& x, MultiFab const& y) {
+            for (MFIter mfi(x); mfi.isValid(); ++mfi) {
+                if (std::memcmp(x[mfi].dataPtr(), y[mfi].dataPtr(), x[mfi].nBytes()) != 0) {
+                    ++nerrors;
+                }
+            }
+        };
+
+        MultiFab va(ba, dm, 1, ng), vb(ba, dm, 1, ng);
+        la.fillVolFrac(va, lgeom);
+        lb.fillVolFrac(vb, lgeom);
+        comp(va, vb);
+
+        MultiFab ca(ba, dm, AMREX_SPACEDIM, ng), cb(ba, dm, AMREX_SPACEDIM, ng);
+        la.fillCentroid(ca, lgeom);
+        lb.fillCentroid(cb, lgeom);
+        comp(ca, cb);
+
+        la.fillBndryCent(ca, lgeom);
+        lb.fillBndryCent(cb, lgeom);
+        comp(ca, cb);
+
+        la.fillBndryNorm(ca, lgeom);
+        lb.fillBndryNorm(cb, lgeom);
+        comp(ca, cb);
+
+        la.fillBndryArea(va, lgeom);
+        lb.fillBndryArea(vb, lgeom);
+        comp(va, vb);
+
+        Array<MultiFab,AMREX_SPACEDIM> afa, afb, fca, fcb;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const BoxArray& fba = amrex::convert(ba, IntVect::TheDimensionVector(idim));
+            afa[idim].define(fba, dm, 1, ng);
+            afb[idim].define(fba, dm, 1, ng);
+            fca[idim].define(fba, dm, AMREX_SPACEDIM-1, ng);
+            fcb[idim].define(fba, dm, AMREX_SPACEDIM-1, ng);
+        }
+        la.fillAreaFrac(amrex::GetArrOfPtrs(afa), lgeom);
+        lb.fillAreaFrac(amrex::GetArrOfPtrs(afb), lgeom);
+        la.fillFaceCent(amrex::GetArrOfPtrs(fca), lgeom);
+        lb.fillFaceCent(amrex::GetArrOfPtrs(fcb), lgeom);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            comp(afa[idim], afb[idim]);
+            comp(fca[idim], fcb[idim]);
+        }
+
+        MultiFab lsa(amrex::convert(ba,IntVect::TheNodeVector()), dm, 1, ng);
+        MultiFab lsb(amrex::convert(ba,IntVect::TheNodeVector()), dm, 1, ng);
+        la.fillLevelSet(lsa, lgeom);
+        lb.fillLevelSet(lsb, lgeom);
+        comp(lsa, lsb);
+    }
+    ParallelDescriptor::ReduceIntSum(nerrors);
+    return nerrors;
+}
+
+bool is_chkpt_file (EB2::IndexSpace const& is)
+{
+    return dynamic_cast<EB2::IndexSpaceChkptFile const*>(&is) != nullptr;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int max_coarsening_level = 2;
+        Real radius = 0.3;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("max_coarsening_level", max_coarsening_level);
+            pp.query("sphere_radius", radius);
+        }
+
+        const std::string& chkpt_file = EB2::ChkptFile();
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!chkpt_file.empty(), "eb2.chkpt_file must be set");
+        if (ParallelDescriptor::IOProcessor() && FileSystem::Exists(chkpt_file)) {
+            FileSystem::RemoveAll(chkpt_file);
+        }
+        ParallelDescriptor::Barrier();
+
+        Geometry geom(Box(IntVect(0),IntVect(n_cell-1)),
+                      RealBox({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)}),
+                      0, {AMREX_D_DECL(0,0,0)});
+
+        auto make_gshop = [&] (Real r) {
+            EB2::SphereIF sphere(r, {AMREX_D_DECL(0.5,0.5,0.5)}, false);
+            return EB2::makeShop(sphere);
+        };
+
+        // The directory does not exist: the data are built and written.
+        // They stay on the stack as the reference for the data read back.
+        auto gshop = make_gshop(radius);
+        EB2::Build(gshop, geom, max_coarsening_level, max_coarsening_level);
+        EB2::IndexSpace const* ref = &EB2::IndexSpace::top();
+        AMREX_ALWAYS_ASSERT(!is_chkpt_file(*ref));
+        const std::string hash = EB2::ChkptFileHash(chkpt_file);
+        AMREX_ALWAYS_ASSERT(!hash.empty());
+
+        // Round trip: the data read back must match exactly.
+        EB2::BuildFromChkptFile(chkpt_file, geom);
+        int nerrors = compare(*ref, EB2::IndexSpace::top(), geom,
+                              max_coarsening_level, max_grid_size);
+        amrex::Print() << "Round trip mismatches: " << nerrors << "\n";
+        AMREX_ALWAYS_ASSERT(nerrors == 0);
+        EB2::IndexSpace::pop();
+
+        // Same geometry and parameters: the hash matches and the data are read.
+        EB2::Build(gshop, geom, max_coarsening_level, max_coarsening_level);
+        AMREX_ALWAYS_ASSERT(is_chkpt_file(EB2::IndexSpace::top()));
+        nerrors = compare(*ref, EB2::IndexSpace::top(), geom,
+                          max_coarsening_level, max_grid_size);
+        amrex::Print() << "Hash match mismatches: " << nerrors << "\n";
+        AMREX_ALWAYS_ASSERT(nerrors == 0);
+        EB2::IndexSpace::pop();
+
+        // Different geometry: the hash does not match, so the data are
+        // rebuilt and the directory is rewritten.
+        auto gshop2 = make_gshop(0.9*radius);
+        EB2::Build(gshop2, geom, max_coarsening_level, max_coarsening_level);
+        AMREX_ALWAYS_ASSERT(!is_chkpt_file(EB2::IndexSpace::top()));
+        const std::string hash2 = EB2::ChkptFileHash(chkpt_file);
+        AMREX_ALWAYS_ASSERT(!hash2.empty() && hash2 != hash);
+        EB2::IndexSpace::pop();
+
+        // Different parameter: the hash does not match either.
+        EB2::Build(gshop2, geom, max_coarsening_level-1, max_coarsening_level-1);
+        AMREX_ALWAYS_ASSERT(!is_chkpt_file(EB2::IndexSpace::top()));
+        AMREX_ALWAYS_ASSERT(EB2::ChkptFileHash(chkpt_file) != hash2);
+
+        amrex::Print() << "EB2 checkpoint file tests passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,201 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+
+#include <cstring>
+#include <limits>
+#include <memory>
+
+using namespace amrex;
+
+static_assert(AMREX_SPACEDIM == 3, "3d only");
+
+namespace {
+
+// Implicit function without bound(), which forces GeometryShop to
+// evaluate the wrapped function at every node.
+template <class F>
+struct PointwiseIF
+{
+    explicit PointwiseIF (F const& a_f) : f(a_f) {}
+    Real operator() (const RealArray& p) const noexcept { return f(p); }
+    F f;
+};
+
+// Transformations only have bounds if the functions they wrap have.
+using Pointwise = PointwiseIF<EB2::SphereIF>;
+static_assert(EB2::HasBound<EB2::SphereIF>::value, "");
+static_assert(!EB2::HasBound<Pointwise>::value, "");
+static_assert(EB2::HasBound<EB2::RotationIF<EB2::SphereIF> >::value, "");
+static_assert(!EB2::HasBound<EB2::RotationIF<Pointwise> >::value, "");
+static_assert(EB2::HasBound<EB2::ScaleIF<EB2::SphereIF> >::value, "");
+static_assert(!EB2::HasBound<EB2::ScaleIF<Pointwise> >::value, "");
+static_assert(!EB2::HasBound<EB2::TranslationIF<Pointwise> >::value, "");
+static_assert(!EB2::HasBound<EB2::ComplementIF<Pointwise> >::value, "");
+static_assert(!EB2::HasBound<EB2::ExtrusionIF<Pointwise> >::value, "");
+static_assert(!EB2::HasBound<EB2::LatheIF<Pointwise> >::value, "");
+static_assert(!EB2::HasBound<EB2::UnionIF<Pointwise,Pointwise> >::value, "");
+static_assert(EB2::HasBound<EB2::UnionIF<Pointwise,EB2::SphereIF> >::value, "");
+static_assert(!EB2::HasBound<EB2::IntersectionIF<Pointwise,Pointwise> >::value, "");
+static_assert(EB2::HasBound<EB2::DifferenceIF<EB2::SphereIF,Pointwise> >::value, "");
+
+bool valid (EB2::IFBound const& b)
+{
+    return b.lo <= b.hi;  // false for NaN
+}
+
+// Interval arithmetic on unbounded and overflowing bounds must not produce
+// NaN, e.g., from inf*0.  Run with amrex.fpe_trap_invalid = 1.
+int test_unbounded ()
+{
+    namespace D = EB2::IFBound_detail;
+    const Real big = std::numeric_limits<Real>::max();
+    const EB2::IFBound unbounded;
+    const EB2::IFBound inf{-std::numeric_limits<Real>::infinity(),
+                            std::numeric_limits<Real>::infinity()};
+
+    int nerrors = 0;
+    for (auto const& x : {unbounded, inf}) {
+        nerrors += !valid(D::scale(x, 0.0));
+        nerrors += !valid(D::scale(x, -2.0));
+        nerrors += !valid(D::multiply(x, EB2::IFBound{0.0, 0.0}));
+        nerrors += !valid(D::multiply(x, EB2::IFBound{0.0, 1.0}));
+        nerrors += !valid(D::multiply(x, x));
+        nerrors += !valid(D::square(x.lo, x.hi));
+        nerrors += !valid(D::power(x.lo, x.hi, 3));
+    }
+
+    // Bounds far away from the origin overflow.
+    const RealArray lo{-big, -big, -big};
+    const RealArray hi{ big,  big,  big};
+    EB2::SphereIF sphere(0.5, {0.,0.,0.}, false);
+    nerrors += !valid(sphere.bound(lo, hi));
+    nerrors += !valid(EB2::makeComplement(sphere).bound(lo, hi));
+    EB2::PlaneIF plane({0.,0.,0.}, {1.,0.,-1.});
+    nerrors += !valid(plane.bound(lo, hi));
+    Vector<EB2::PolyTerm> poly;
+    poly.push_back(EB2::PolyTerm{ 1.0, IntVect(3,1,0)});
+    poly.push_back(EB2::PolyTerm{ 0.0, IntVect(2,0,0)});
+    poly.push_back(EB2::PolyTerm{-1.0, IntVect(0,2,1)});
+    nerrors += !valid(EB2::PolynomialIF(poly, false).bound(lo, hi));
+    EB2::TorusIF torus(0.5, 0.1, {0.,0.,0.}, false);
+    nerrors += !valid(torus.bound(lo, hi));
+
+    amrex::Print() << "  unbounded arithmetic: " << nerrors << " invalid bounds\n";
+    return nerrors;
+}
+
+// Compare the box classification with and without the bounds of f, both
+// box by box and for the cell flags and volume fractions of a full build.
+// Returns the number of mismatches.
+template <class F>
+int test (std::string const& name, F const& f, Geometry const& geom)
+{
+    static_assert(EB2::HasBound<F>::value, "");
+
+    auto gshop_bound = EB2::makeShop(f);
+    auto gshop_point = EB2::makeShop(PointwiseIF<F>(f));
+
+    int nerrors = 0;
+    int nmixed = 0;
+    for (int max_size : {4, 8, 16, 32, 64}) {
+        BoxArray ba(geom.Domain());
+        ba.maxSize(max_size);
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            const Box& bx = amrex::surroundingNodes(amrex::grow(ba[i],2));
+            int t1 = gshop_bound.getBoxType(bx, geom, RunOn::Cpu);
+            int t2 = gshop_point.getBoxType(bx, geom, RunOn::Cpu);
+            if (t1 != t2) ++nerrors;
+            if (t2 == EB2::GeometryShop<F>::mixedcells) ++nmixed;
+        }
+    }
+    AMREX_ALWAYS_ASSERT(nmixed > 0);
+
+    std::unique_ptr<EB2::IndexSpace> is_bound
+        (new EB2::IndexSpaceImp<decltype(gshop_bound)>(gshop_bound, geom, 0, 0, 4, true,
+                                                       EB2::ExtendDomainFace()));
+    std::unique_ptr<EB2::IndexSpace> is_point
+        (new EB2::IndexSpaceImp<decltype(gshop_point)>(gshop_point, geom, 0, 0, 4, true,
+                                                       EB2::ExtendDomainFace()));
+    EB2::Level const& lb = is_bound->getLevel(geom);
+    EB2::Level const& lp = is_point->getLevel(geom);
+
+    BoxArray ba(geom.Domain());
+    ba.maxSize(32);
+    DistributionMapping dm(ba);
+    FabArray<EBCellFlagFab> fb(ba, dm, 1, 0), fp(ba, dm, 1, 0);
+    lb.fillEBCellFlag(fb, geom);
+    lp.fillEBCellFlag(fp, geom);
+    MultiFab vb(ba, dm, 1, 0), vp(ba, dm, 1, 0);
+    lb.fillVolFrac(vb, geom);
+    lp.fillVolFrac(vp, geom);
+    for (MFIter mfi(fb); mfi.isValid(); ++mfi) {
+        if (fb[mfi].getType() != fp[mfi].getType() ||
+            std::memcmp(fb[mfi].dataPtr(), fp[mfi].dataPtr(), fb[mfi].nBytes()) != 0 ||
+            std::memcmp(vb[mfi].dataPtr(), vp[mfi].dataPtr(), vb[mfi].nBytes()) != 0)
+        {
+            ++nerrors;
+        }
+    }
+
+    ParallelDescriptor::ReduceIntSum(nerrors);
+    amrex::Print() << "  " << name << ": " << nerrors << " mismatches\n";
+    return nerrors;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+        }
+
+        Geometry geom(Box(IntVect(0),IntVect(n_cell-1)),
+                      RealBox({-1.,-1.,-1.}, {1.,1.,1.}), 0, {0,0,0});
+
+        int nerrors = test_unbounded();
+
+        EB2::SphereIF sphere(0.5, {0.1,-0.05,0.02}, false);
+        nerrors += test("sphere", sphere, geom);
+
+        EB2::BoxIF box({-0.4,-0.3,-0.2}, {0.35,0.3,0.45}, false);
+        nerrors += test("rotated box",
+                        EB2::translate(EB2::rotate(box, 0.4, 1), {0.1,0.05,-0.1}), geom);
+
+        EB2::CylinderIF cylinder(0.2, 1.2, 2, {0.,0.,0.}, false);
+        EB2::EllipsoidIF ellipsoid({0.6,0.3,0.2}, {0.,0.,0.1}, false);
+        nerrors += test("scaled union",
+                        EB2::scale(EB2::makeUnion(cylinder, ellipsoid), {1.2,0.9,1.1}), geom);
+
+        nerrors += test("difference", EB2::makeDifference(box, sphere), geom);
+
+        EB2::PlaneIF plane({0.,0.,0.13}, {0.,0.,1.});
+        EB2::SphereIF big_sphere(0.8, {0.,0.,0.}, false);
+        nerrors += test("complement of intersection",
+                        EB2::makeComplement(EB2::makeIntersection(plane, big_sphere)), geom);
+
+        Vector<EB2::PolyTerm> poly;
+        poly.push_back(EB2::PolyTerm{ 1.0, IntVect(2,0,0)});
+        poly.push_back(EB2::PolyTerm{ 2.0, IntVect(0,2,0)});
+        poly.push_back(EB2::PolyTerm{-1.0, IntVect(0,0,1)});
+        poly.push_back(EB2::PolyTerm{-0.3, IntVect(0,0,0)});
+        nerrors += test("polynomial", EB2::PolynomialIF(poly, false), geom);
+
+        nerrors += test("extrusion", EB2::extrude(sphere, 2), geom);
+
+        EB2::SphereIF circle(0.2, {0.5,0.,0.}, false);
+        nerrors += test("lathe", EB2::lathe(circle), geom);
+
+        AMREX_ALWAYS_ASSERT(nerrors == 0);
+        amrex::Print() << "Bounded and pointwise classifications agree\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,193 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF_STL.H>
+#include <AMReX_OpenMP.H>
+
+#include <fstream>
+#include <map>
+#include <random>
+
+using namespace amrex;
+
+static_assert(AMREX_SPACEDIM == 3, "3d only");
+
+namespace {
+
+// Icosphere with 20*4^nrefine triangles
+Vector<EB2::TriangleBVH::Triangle> make_sphere (int nrefine, Real radius)
+{
+    const Real t = (1.0+std::sqrt(5.0))/2.0;
+    Vector<RealArray> v{{-1, t, 0}, { 1, t, 0}, {-1,-t, 0}, { 1,-t, 0},
+                        { 0,-1, t}, { 0, 1, t}, { 0,-1,-t}, { 0, 1,-t},
+                        { t, 0,-1}, { t, 0, 1}, {-t, 0,-1}, {-t, 0, 1}};
+    Vector<std::array<int,3> > f{{0,11,5}, {0,5,1}, {0,1,7}, {0,7,10}, {0,10,11},
+                                 {1,5,9}, {5,11,4}, {11,10,2}, {10,7,6}, {7,1,8},
+                                 {3,9,4}, {3,4,2}, {3,2,6}, {3,6,8}, {3,8,9},
+                                 {4,9,5}, {2,4,11}, {6,2,10}, {8,6,7}, {9,8,1}};
+    auto normalize = [] (RealArray& x) {
+        Real r = std::sqrt(x[0]*x[0]+x[1]*x[1]+x[2]*x[2]);
+        for (auto& c : x) c /= r;
+    };
+    for (auto& x : v) normalize(x);
+
+    for (int ir = 0; ir < nrefine; ++ir) {
+        std::map<std::pair<int,int>,int> midpoint;
+        auto getmid = [&] (int a, int b) -> int {
+            auto key = std::make_pair(std::min(a,b), std::max(a,b));
+            auto it = midpoint.find(key);
+            if (it != midpoint.end()) return it->second;
+            RealArray m{0.5*(v[a][0]+v[b][0]), 0.5*(v[a][1]+v[b][1]), 0.5*(v[a][2]+v[b][2])};
+            normalize(m);
+            v.push_back(m);
+            midpoint[key] = v.size()-1;
+            return v.size()-1;
+        };
+        Vector<std::array<int,3> > f2;
+        f2.reserve(4*f.size());
+        for (auto const& tri : f) {
+            int a = getmid(tri[0],tri[1]);
+            int b = getmid(tri[1],tri[2]);
+            int c = getmid(tri[2],tri[0]);
+            f2.push_back({tri[0],a,c});
+            f2.push_back({tri[1],b,a});
+            f2.push_back({tri[2],c,b});
+            f2.push_back({a,b,c});
+        }
+        std::swap(f,f2);
+    }
+
+    Vector<EB2::TriangleBVH::Triangle> r;
+    r.reserve(f.size());
+    for (auto const& tri : f) {
+        EB2::TriangleBVH::Triangle tr;
+        for (int idim = 0; idim < 3; ++idim) {
+            tr.v0[idim] = radius*v[tri[0]][idim] + 0.5;
+            tr.v1[idim] = radius*v[tri[1]][idim] + 0.5;
+            tr.v2[idim] = radius*v[tri[2]][idim] + 0.5;
+        }
+        r.push_back(tr);
+    }
+    return r;
+}
+
+void write_binary_stl (const std::string& filename, Vector<EB2::TriangleBVH::Triangle> const& tri)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    char header[80] = {};
+    ofs.write(header, 80);
+    std::uint32_t ntri = tri.size();
+    ofs.write(reinterpret_cast<char const*>(&ntri), sizeof(ntri));
+    for (auto const& t : tri) {
+        float buf[12] = {0.f, 0.f, 0.f,
+                         float(t.v0[0]), float(t.v0[1]), float(t.v0[2]),
+                         float(t.v1[0]), float(t.v1[1]), float(t.v1[2]),
+                         float(t.v2[0]), float(t.v2[1]), float(t.v2[2])};
+        ofs.write(reinterpret_cast<char const*>(buf), sizeof(buf));
+        std::uint16_t attr = 0;
+        ofs.write(reinterpret_cast<char const*>(&attr), sizeof(attr));
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        std::string stl_file;
+        int nrefine = 7;
+        Real sphere_radius = 0.3;
+        Long nqueries = 1000000;
+        Real max_distance = 0.05;
+        int n_cell = 128;
+        {
+            ParmParse pp;
+            pp.query("stl_file", stl_file);
+            pp.query("nrefine", nrefine);
+            pp.query("sphere_radius", sphere_radius);
+            pp.query("nqueries", nqueries);
+            pp.query("max_distance", max_distance);
+            pp.query("n_cell", n_cell);
+        }
+
+        const bool is_sphere = stl_file.empty();
+        if (is_sphere) {
+            stl_file = "sphere.stl";
+            if (ParallelDescriptor::IOProcessor()) {
+                write_binary_stl(stl_file, make_sphere(nrefine, sphere_radius));
+            }
+            ParallelDescriptor::Barrier();
+        }
+
+        Real t0 = amrex::second();
+        auto tri = EB2::STLIF::readSTL(stl_file, 1.0, RealArray{0.,0.,0.});
+        Real t1 = amrex::second();
+        EB2::STLIF stl(std::move(tri), false, max_distance);
+        Real t2 = amrex::second();
+
+        auto const& bvh = stl.getBVH();
+        amrex::Print() << "STL file " << stl_file << ": " << bvh.numTriangles()
+                       << " triangles, " << bvh.numNodes() << " BVH nodes\n"
+                       << "  read time " << t1-t0 << ", BVH build time " << t2-t1
+                       << " (" << bvh.numTriangles()/(t2-t1) << " triangles/s)\n";
+
+        // Random queries in the bounding box enlarged by 20%
+        RealArray lo = bvh.boxLo(), hi = bvh.boxHi();
+        for (int idim = 0; idim < 3; ++idim) {
+            Real w = hi[idim]-lo[idim];
+            lo[idim] -= 0.2*w;
+            hi[idim] += 0.2*w;
+        }
+
+        Real errmax = 0.0;
+        Long ninside = 0;
+        Real t3 = amrex::second();
+#ifdef _OPENMP
+#pragma omp parallel reduction(max:errmax) reduction(+:ninside)
+#endif
+        {
+            std::mt19937 gen(42+OpenMP::get_thread_num());
+            std::uniform_real_distribution<Real> u(0.0,1.0);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (Long i = 0; i < nqueries; ++i) {
+                RealArray p{lo[0]+u(gen)*(hi[0]-lo[0]),
+                            lo[1]+u(gen)*(hi[1]-lo[1]),
+                            lo[2]+u(gen)*(hi[2]-lo[2])};
+                Real d = stl(p);
+                if (d > 0.0) ++ninside;
+                if (is_sphere) {
+                    Real r = std::sqrt((p[0]-0.5)*(p[0]-0.5) + (p[1]-0.5)*(p[1]-0.5)
+                                       + (p[2]-0.5)*(p[2]-0.5));
+                    Real dexact = amrex::min(sphere_radius-r, max_distance);
+                    dexact = amrex::max(dexact, -max_distance);
+                    errmax = amrex::max(errmax, std::abs(d-dexact));
+                }
+            }
+        }
+        Real t4 = amrex::second();
+        amrex::Print() << "  " << nqueries << " signed distance queries: " << t4-t3
+                       << " (" << nqueries/(t4-t3) << " queries/s), "
+                       << ninside << " inside\n";
+        if (is_sphere) {
+            // The error is bounded by the distance between the sphere and
+            // the triangles, plus the single precision of the file.
+            Real h = sphere_radius * 4.0/std::pow(2.0,nrefine);
+            amrex::Print() << "  max error vs. sphere " << errmax << "\n";
+            AMREX_ALWAYS_ASSERT(errmax < h*h/sphere_radius + 1.e-6);
+        }
+
+        // EB2 index space with the STL geometry
+        Geometry geom(Box(IntVect(0),IntVect(n_cell-1)),
+                      RealBox({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)}),
+                      0, {AMREX_D_DECL(0,0,0)});
+        Real t5 = amrex::second();
+        EB2::Build(EB2::makeShop(stl), geom, 0, 0);
+        Real t6 = amrex::second();
+        amrex::Print() << "  EB2::Build on " << n_cell << "^3: " << t6-t5 << "\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,299 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_FPC.H>
+#include <AMReX_Vector.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+using namespace amrex;
+
+namespace {
+
+// The IEEE type of the other precision
+using Other = std::conditional<sizeof(Real) == 8, float, double>::type;
+
+const RealDescriptor& native_other ()
+{
+    return (sizeof(Real) == 8) ? FPC::Native32RealDescriptor() : FPC::Native64RealDescriptor();
+}
+
+// rd with its bytes reversed
+RealDescriptor reversed (const RealDescriptor& rd)
+{
+    const int nb = rd.numBytes();
+    Vector<int> ord(nb);
+    for (int i = 0; i < nb; ++i) {
+        ord[i] = rd.order()[nb-1-i];
+    }
+    return RealDescriptor(rd.format(), ord.data(), nb);
+}
+
+// rd with its bytes swapped in pairs, which only the generic path handles
+RealDescriptor pair_swapped (const RealDescriptor& rd)
+{
+    const int nb = rd.numBytes();
+    Vector<int> ord(nb);
+    for (int i = 0; i < nb; ++i) {
+        ord[i] = rd.order()[i^1];
+    }
+    return RealDescriptor(rd.format(), ord.data(), nb);
+}
+
+// Rearranges the bytes of n items from the order of id to that of od
+Vector<char> permute (const Vector<char>& in, const RealDescriptor& od, const RealDescriptor& id)
+{
+    const int nb = od.numBytes();
+    AMREX_ALWAYS_ASSERT(id.numBytes() == nb);
+    Vector<int> src(nb);
+    for (int i = 0; i < nb; ++i) {
+        for (int j = 0; j < nb; ++j) {
+            if (id.order()[j] == od.order()[i]) src[i] = j;
+        }
+    }
+    Vector<char> out(in.size());
+    for (Long m = 0; m < static_cast<Long>(in.size()); m += nb) {
+        for (int i = 0; i < nb; ++i) {
+            out[m+i] = in[m+src[i]];
+        }
+    }
+    return out;
+}
+
+// Values of type T from bytes in the format of rd
+template <typename T>
+Vector<T> decode (const Vector<char>& buf, const RealDescriptor& rd, const RealDescriptor& native)
+{
+    Vector<char> b = permute(buf, native, rd);
+    Vector<T> v(b.size()/sizeof(T));
+    std::memcpy(v.data(), b.data(), b.size());
+    return v;
+}
+
+// Bytes in the format of rd from values of type T
+template <typename T>
+Vector<char> encode (const Vector<T>& v, const RealDescriptor& rd, const RealDescriptor& native)
+{
+    Vector<char> b(v.size()*sizeof(T));
+    std::memcpy(b.data(), v.data(), b.size());
+    return permute(b, rd, native);
+}
+
+// Random normal numbers that fit in either precision
+template <typename T>
+Vector<T> random_values (Long n)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> mant(1., 2.);
+    std::uniform_int_distribution<int> expo(-60, 60);
+    Vector<T> v(n);
+    for (auto& x : v) {
+        x = static_cast<T>(std::ldexp(mant(gen), expo(gen)) * ((gen() & 1) ? -1. : 1.));
+    }
+    return v;
+}
+
+void check (bool ok, std::string const& what)
+{
+    amrex::Print() << "  " << std::left << std::setw(60) << what
+                   << (ok ? "passed" : "FAILED") << "\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ok, what.c_str());
+}
+
+// Native Reals to the format of od.  The result must agree with the
+// generic path, except that narrowing now rounds instead of truncating.
+void check_write (const RealDescriptor& od, const RealDescriptor& onative, std::string const& name)
+{
+    const Long n = 100003;
+    Vector<Real> src = random_values<Real>(n);
+
+    Vector<char> fast(n*od.numBytes());
+    RealDescriptor::convertFromNativeFormat(fast.data(), n, src.data(), od);
+
+    const RealDescriptor gd = pair_swapped(od);
+    Vector<char> generic(n*od.numBytes());
+    RealDescriptor::convertFromNativeFormat(generic.data(), n, src.data(), gd);
+    generic = permute(generic, od, gd);
+
+    bool ok = true;
+    if (od.numBytes() == int(sizeof(Real))) {
+        ok = (fast == generic);
+    } else {
+        Vector<Other> f = decode<Other>(fast, od, onative);
+        Vector<Other> g = decode<Other>(generic, od, onative);
+        for (Long i = 0; i < n; ++i) {
+            const Other ulp = std::nextafter(std::abs(g[i]), std::numeric_limits<Other>::max())
+                - std::abs(g[i]);
+            ok = ok && (f[i] == static_cast<Other>(src[i]))
+                    && (std::abs(f[i]-g[i]) <= ulp);
+        }
+    }
+    check(ok, "write " + name);
+}
+
+// The format of id to native Reals
+template <typename T>
+void check_read (const RealDescriptor& id, const RealDescriptor& inative, std::string const& name)
+{
+    const Long n = 100003;
+    Vector<char> buf = encode(random_values<T>(n), id, inative);
+
+    Vector<Real> fast(n);
+    RealDescriptor::convertToNativeFormat(fast.data(), n, buf.data(), id);
+
+    const RealDescriptor gd = pair_swapped(id);
+    Vector<char> gbuf = permute(buf, gd, id);
+    Vector<Real> generic(n);
+    RealDescriptor::convertToNativeFormat(generic.data(), n, gbuf.data(), gd);
+
+    check(fast == generic, "read " + name);
+}
+
+// Zeros, denormals, infinities and NaNs in a change of precision
+void check_special (const RealDescriptor& od, const RealDescriptor& onative, std::string const& name)
+{
+    const Real inf = std::numeric_limits<Real>::infinity();
+    Vector<Real> src{0., -1.e-40, std::numeric_limits<Real>::denorm_min(), inf, -inf,
+                     std::numeric_limits<Real>::quiet_NaN(), 1.5};
+    const Long n = src.size();
+
+    Vector<char> buf(n*od.numBytes());
+    RealDescriptor::convertFromNativeFormat(buf.data(), n, src.data(), od);
+    Vector<Other> out = decode<Other>(buf, od, onative);
+
+    Vector<Real> back(n);
+    RealDescriptor::convertToNativeFormat(back.data(), n, buf.data(), od);
+
+    bool ok = true;
+    for (Long i = 0; i < 3; ++i) {
+        ok = ok && (out[i] == 0 && !std::signbit(out[i]) && back[i] == 0);
+    }
+    ok = ok && out[3] == std::numeric_limits<Other>::infinity() && back[3] == inf;
+    ok = ok && out[4] == -std::numeric_limits<Other>::infinity() && back[4] == -inf;
+    ok = ok && std::isnan(out[5]) && std::isnan(back[5]);
+    ok = ok && out[6] == 1.5 && back[6] == 1.5;
+    check(ok, "special values " + name);
+}
+
+// Through a stream, in more items than fit in the read and write buffers
+void check_stream (const RealDescriptor& rd, std::string const& name)
+{
+    const Long n = 300007;
+    Vector<Real> src = random_values<Real>(n);
+
+    std::stringstream ss;
+    RealDescriptor::convertFromNativeFormat(ss, n, src.data(), rd);
+    Vector<Real> back(n);
+    RealDescriptor::convertToNativeFormat(back.data(), n, ss, rd);
+
+    bool ok = true;
+    for (Long i = 0; i < n; ++i) {
+        const Real expected = (rd.numBytes() == int(sizeof(Real)))
+            ? src[i] : static_cast<Real>(static_cast<Other>(src[i]));
+        ok = ok && (back[i] == expected);
+    }
+    check(ok, "stream round trip " + name);
+}
+
+// GB/s read plus written
+Real bandwidth (Long nitems, int nsteps, int nbytes, bool write,
+                const RealDescriptor& rd, Vector<Real>& native, Vector<char>& buf)
+{
+    if (write) {
+        RealDescriptor::convertFromNativeFormat(buf.data(), nitems, native.data(), rd);
+    } else {
+        RealDescriptor::convertToNativeFormat(native.data(), nitems, buf.data(), rd);
+    }
+
+    Real t = amrex::second();
+    for (int step = 0; step < nsteps; ++step) {
+        if (write) {
+            RealDescriptor::convertFromNativeFormat(buf.data(), nitems, native.data(), rd);
+        } else {
+            RealDescriptor::convertToNativeFormat(native.data(), nitems, buf.data(), rd);
+        }
+    }
+    t = amrex::second() - t;
+    ParallelDescriptor::ReduceRealMax(t);
+
+    return Real(nsteps) * nitems * (sizeof(Real) + nbytes) / t * 1.e-9;
+}
+
+void benchmark ()
+{
+    Long nitems = 16777216;
+    int nsteps = 10;
+    {
+        ParmParse pp;
+        pp.query("nitems", nitems);
+        pp.query("nsteps", nsteps);
+    }
+
+    struct Conversion {
+        std::string name;
+        RealDescriptor rd;
+        bool write;
+    };
+
+    const RealDescriptor& native = FPC::NativeRealDescriptor();
+    const RealDescriptor& other = native_other();
+    Vector<Conversion> conversions{
+        {"native to byte-reversed",             reversed(native), true},
+        {"byte-reversed to native",             reversed(native), false},
+        {"native to other precision",           other,            true},
+        {"other precision to native",           other,            false},
+        {"native to byte-reversed other prec.", reversed(other),  true},
+        {"byte-reversed other prec. to native", reversed(other),  false}};
+
+    Vector<Real> vals = random_values<Real>(nitems);
+    Vector<char> buf(nitems*sizeof(Real));
+
+    amrex::Print() << "  " << std::left << std::setw(38) << "conversion"
+                   << std::right << std::setw(14) << "fast GB/s"
+                   << std::setw(14) << "generic GB/s" << "\n";
+    for (auto const& c : conversions) {
+        const int nb = c.rd.numBytes();
+        const Real fast = bandwidth(nitems, nsteps, nb, c.write, c.rd, vals, buf);
+        const Real generic = bandwidth(nitems, 1, nb, c.write, pair_swapped(c.rd), vals, buf);
+        amrex::Print() << "  " << std::left << std::setw(38) << c.name << std::right
+                       << std::fixed << std::setprecision(3)
+                       << std::setw(14) << fast << std::setw(14) << generic
+                       << std::defaultfloat << "\n";
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        const RealDescriptor& native = FPC::NativeRealDescriptor();
+        const RealDescriptor& other = native_other();
+
+        amrex::Print() << "Checking the conversions\n";
+        check_write(reversed(native), native, "native to byte-reversed");
+        check_write(other, other, "native to other precision");
+        check_write(reversed(other), other, "native to byte-reversed other precision");
+        check_read<Real>(reversed(native), native, "byte-reversed to native");
+        check_read<Other>(other, other, "other precision to native");
+        check_read<Other>(reversed(other), other, "byte-reversed other precision to native");
+        check_special(other, other, "in other precision");
+        check_special(reversed(other), other, "in byte-reversed other precision");
+        check_stream(reversed(native), "byte-reversed");
+        check_stream(reversed(other), "byte-reversed other precision");
+
+        amrex::Print() << "\nConversion bandwidth\n";
+        benchmark();
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,231 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_PhysBCFunct.H>
+#include <AMReX_Utility.H>
+
+#include <cmath>
+#include <iomanip>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, std::string const& what)
+{
+    amrex::Print() << "  " << std::left << std::setw(60) << what
+                   << (ok ? "passed" : "FAILED") << "\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ok, what.c_str());
+}
+
+void fill (MultiFab& mf, Real shift)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = std::sin(Real(0.1)*(AMREX_D_TERM(i,+2*j,+3*k)) + n + shift);
+        });
+    }
+}
+
+// Do a and b agree in the valid cells of components [acomp,acomp+ncomp)
+// and [bcomp,bcomp+ncomp)?
+bool equal (MultiFab const& a, int acomp, MultiFab const& b, int bcomp, int ncomp)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), ncomp, 0);
+    MultiFab::Copy(d, a, acomp, 0, ncomp, 0);
+    MultiFab::Subtract(d, b, bcomp, 0, ncomp, 0);
+    return d.norm0(0) == 0.;
+}
+
+// The same boxes as on the old grids are on the same processes.
+DistributionMapping keep_owners (BoxArray const& ba, BoxArray const& oba,
+                                 DistributionMapping const& odm)
+{
+    const int nprocs = ParallelDescriptor::NProcs();
+    Vector<int> pmap(ba.size());
+    int next = 0;
+    for (int i = 0; i < ba.size(); ++i) {
+        pmap[i] = -1;
+        for (const auto& is : oba.intersections(ba[i])) {
+            if (oba[is.first] == ba[i]) pmap[i] = odm[is.first];
+        }
+        if (pmap[i] < 0) pmap[i] = (next++) % nprocs;
+    }
+    return DistributionMapping(std::move(pmap));
+}
+
+struct Setup
+{
+    Geometry cgeom, fgeom;
+    MultiFab crse;
+    BoxArray oba, ba;
+    DistributionMapping odm, dm;
+    Vector<BCRec> bcs;
+    PhysBCFunctNoOp bcf;
+    int ncomp;
+
+    Setup (int n_cell, int max_grid_size, int shift, int nc)
+        : ncomp(nc)
+    {
+        RealBox rb(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.));
+        Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,1,1)};
+        const Box cdomain(IntVect(0), IntVect(n_cell-1));
+        cgeom.define(cdomain, rb, 0, is_per);
+        fgeom.define(amrex::refine(cdomain,2), rb, 0, is_per);
+
+        BoxArray cba(cdomain);
+        cba.maxSize(max_grid_size);
+        crse.define(cba, DistributionMapping(cba), ncomp, 0);
+        fill(crse, 0.);
+
+        // The fine level covers the middle half of the domain and
+        // moves by shift fine cells in the first direction.
+        const Box region(IntVect(n_cell/2), IntVect(3*n_cell/2-1));
+        oba = BoxArray(region);
+        oba.maxSize(max_grid_size);
+        odm.define(oba);
+        ba = BoxArray(amrex::shift(region, 0, shift));
+        ba.maxSize(max_grid_size);
+        dm = keep_owners(ba, oba, odm);
+
+        bcs.resize(ncomp);
+        for (auto& bc : bcs) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                bc.setLo(idim, BCType::int_dir);
+                bc.setHi(idim, BCType::int_dir);
+            }
+        }
+    }
+
+    // Data on the old grids that differ from the interpolated coarse data
+    void makeOld (MultiFab& old)
+    {
+        old.define(oba, odm, ncomp, 1);
+        fill(old, 0.5);
+    }
+
+    void fillPatch (MultiFab& mf, MultiFab& old, int scomp, int dcomp, int nc)
+    {
+        FillPatchTwoLevels(mf, 0.0, {&crse}, {0.0}, {&old}, {0.0}, scomp, dcomp, nc,
+                           cgeom, fgeom, bcf, 0, bcf, 0, IntVect(2),
+                           &cell_cons_interp, bcs, 0);
+    }
+
+    void fillPatchRegrid (MultiFab& mf, MultiFab& old, int scomp, int dcomp, int nc)
+    {
+        amrex::FillPatchRegrid(mf, old, 0.0, {&crse}, {0.0}, scomp, dcomp, nc,
+                               cgeom, fgeom, bcf, 0, bcf, 0, IntVect(2),
+                               &cell_cons_interp, bcs, 0);
+    }
+};
+
+void check_regrid (Setup& s)
+{
+    MultiFab old, ref(s.ba, s.dm, s.ncomp, 1);
+    s.makeOld(old);
+    s.fillPatch(ref, old, 0, 0, s.ncomp);
+
+    // Remember which FABs of old can be taken over
+    Vector<Real const*> old_ptr(s.ba.size(), nullptr);
+    int nkept = 0;
+    for (MFIter mfi(old); mfi.isValid(); ++mfi) {
+        for (int i = 0; i < s.ba.size(); ++i) {
+            if (s.ba[i] == mfi.validbox() && s.dm[i] == ParallelDescriptor::MyProc()) {
+                old_ptr[i] = old[mfi].dataPtr();
+                ++nkept;
+            }
+        }
+    }
+    ParallelDescriptor::ReduceIntSum(nkept);
+
+    MultiFab mf(s.ba, s.dm, s.ncomp, 1);
+    s.fillPatchRegrid(mf, old, 0, 0, s.ncomp);
+    check(nkept > 0 && nkept < s.ba.size(), "some boxes are unchanged");
+    check(equal(mf, 0, ref, 0, s.ncomp), "all components");
+
+    bool ok = true;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const Real* p = old_ptr[mfi.index()];
+        ok = ok && (p == nullptr || mf[mfi].dataPtr() == p);
+    }
+    check(ok, "unchanged FABs are taken over");
+
+    // Only some of the components, which are copied
+    MultiFab old2, mf2(s.ba, s.dm, s.ncomp, 1);
+    s.makeOld(old2);
+    mf2.setVal(-1.);
+    s.fillPatchRegrid(mf2, old2, 1, 0, s.ncomp-1);
+    check(equal(mf2, 0, ref, 1, s.ncomp-1), "some components");
+    MultiFab m(s.ba, s.dm, 1, 0);
+    MultiFab::Copy(m, mf2, s.ncomp-1, 0, 1, 0);
+    check(m.min(0) == -1. && m.max(0) == -1., "other components untouched");
+}
+
+void benchmark (Setup& s, int nsteps)
+{
+    Real t[2] = {0., 0.};
+    for (int step = 0; step < nsteps; ++step) {
+        for (int m = 0; m < 2; ++m) {
+            MultiFab old, mf(s.ba, s.dm, s.ncomp, 1);
+            s.makeOld(old);
+            ParallelDescriptor::Barrier();
+            Real t0 = amrex::second();
+            if (m == 0) {
+                s.fillPatch(mf, old, 0, 0, s.ncomp);
+            } else {
+                s.fillPatchRegrid(mf, old, 0, 0, s.ncomp);
+            }
+            t[m] += amrex::second() - t0;
+        }
+    }
+    ParallelDescriptor::ReduceRealMax(t, 2);
+
+    amrex::Print() << "  " << std::left << std::setw(24) << "milliseconds per call"
+                   << std::right << std::setw(14) << "FillPatch"
+                   << std::setw(14) << "regrid" << std::setw(10) << "speedup" << "\n"
+                   << "  " << std::setw(24) << " "
+                   << std::fixed << std::setprecision(3)
+                   << std::setw(14) << t[0]/nsteps*1.e3 << std::setw(14) << t[1]/nsteps*1.e3
+                   << std::setprecision(2) << std::setw(10) << t[0]/t[1]
+                   << std::defaultfloat << "\n";
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int shift = 32;
+        int ncomp = 4;
+        int nsteps = 5;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("shift", shift);
+            pp.query("ncomp", ncomp);
+            pp.query("nsteps", nsteps);
+        }
+
+        amrex::Print() << "Checking FillPatchRegrid against FillPatchTwoLevels\n";
+        {
+            Setup s(16, 8, 8, 2);
+            check_regrid(s);
+        }
+
+        amrex::Print() << "\nFilling the new grids after the fine level moved by "
+                       << shift << " cells\n";
+        Setup s(n_cell, max_grid_size, shift, ncomp);
+        benchmark(s, nsteps);
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,347 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_PhysBCFunct.H>
+
+#include <cmath>
+#include <iomanip>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+// Boxes of the fine region in the checks, including some that are not
+// aligned with the coarse cells and some with negative indices.
+Vector<Box> fine_regions ()
+{
+    return { Box(IntVect(AMREX_D_DECL(-8,-4,0)), IntVect(AMREX_D_DECL(15,11,7))),
+             Box(IntVect(AMREX_D_DECL(-3,1,2)), IntVect(AMREX_D_DECL(14,9,12))),
+             Box(IntVect(AMREX_D_DECL(5,-7,-1)), IntVect(AMREX_D_DECL(5,-6,1))),
+             Box(IntVect(AMREX_D_DECL(1,2,3)), IntVect(AMREX_D_DECL(2,3,4))) };
+}
+
+// Geometries in which the coarse cell i spans [i*h,(i+1)*h]
+void make_geoms (int r, Real h, Geometry& cgeom, Geometry& fgeom)
+{
+    Box cdomain(IntVect(0), IntVect(63));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(64*h,64*h,64*h)});
+    cgeom.define(cdomain, &rb, CoordSys::cartesian);
+    fgeom.define(amrex::refine(cdomain,r), &rb, CoordSys::cartesian);
+}
+
+// Average of p(x) = c[0] + c[1]*x + ... + c[4]*x^4 over [a,b]
+Real quartic_avg (Real const* c, Real a, Real b)
+{
+    Real s = 0.;
+    Real an = 1., bn = 1.;
+    for (int k = 0; k <= 4; ++k) {
+        an *= a;
+        bn *= b;
+        s += c[k]*(bn-an)/(k+1);
+    }
+    return s/(b-a);
+}
+
+// Cell averages of a product of quartics in each direction, with cell size h
+void fill_quartic (FArrayBox& fab, Real h)
+{
+    const Real c[3][5] = {{ 1.0,  0.5, -0.25,  0.1,  0.05},
+                          { 0.5, -1.0,  0.3,  -0.2,  0.04},
+                          {-2.0,  0.2,  0.1,   0.3, -0.03}};
+    auto const& a = fab.array();
+    amrex::LoopOnCpu(fab.box(), fab.nComp(), [&] (int i, int j, int k, int n) noexcept
+    {
+        IntVect iv(AMREX_D_DECL(i,j,k));
+        Real v = 1. + n;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            v *= quartic_avg(c[idim], iv[idim]*h, (iv[idim]+1)*h);
+        }
+        a(i,j,k,n) = v;
+    });
+}
+
+// The value at the cell center of a linear function, which is also its average
+void fill_linear (FArrayBox& fab, Real h)
+{
+    auto const& a = fab.array();
+    amrex::LoopOnCpu(fab.box(), fab.nComp(), [&] (int i, int j, int k, int n) noexcept
+    {
+        IntVect iv(AMREX_D_DECL(i,j,k));
+        Real v = 1. + n;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            v += (0.3 - 0.2*idim)*(iv[idim]+0.5)*h;
+        }
+        a(i,j,k,n) = v;
+    });
+}
+
+void fill_random (FArrayBox& fab, Real lo, Real hi)
+{
+    auto const& a = fab.array();
+    amrex::LoopOnCpu(fab.box(), fab.nComp(), [&] (int i, int j, int k, int n) noexcept
+    {
+        a(i,j,k,n) = lo + (hi-lo)*amrex::Random();
+    });
+}
+
+Real max_diff (FArrayBox const& f1, FArrayBox const& f2, Box const& bx, int ncomp)
+{
+    Real m = 0.;
+    auto const& a = f1.const_array();
+    auto const& b = f2.const_array();
+    amrex::LoopOnCpu(bx, ncomp, [&] (int i, int j, int k, int n) noexcept
+    {
+        m = std::max(m, std::abs(a(i,j,k,n)-b(i,j,k,n)));
+    });
+    return m;
+}
+
+// Maximum difference between the coarse values and the averages of the fine
+// values over the coarse cells, for the coarse cells covered by fine_region.
+Real max_cons_error (FArrayBox const& crse, FArrayBox const& fine, Box const& fine_region,
+                     int r, int ncomp)
+{
+    const Box cbx = amrex::coarsen(fine_region, r);
+    FArrayBox avg(cbx, ncomp);
+    avg.setVal<RunOn::Host>(0.0);
+    auto const& a = avg.array();
+    auto const& f = fine.const_array();
+    amrex::LoopOnCpu(fine_region, ncomp, [&] (int i, int j, int k, int n) noexcept
+    {
+        IntVect iv(AMREX_D_DECL(i,j,k));
+        iv.coarsen(r);
+        a(iv,n) += f(i,j,k,n) / (AMREX_D_TERM(r,*r,*r));
+    });
+    return max_diff(crse, avg, cbx, ncomp);
+}
+
+void check (bool ok, std::string const& what, Real err)
+{
+    amrex::Print() << "  " << std::left << std::setw(60) << what
+                   << (ok ? "passed" : "FAILED") << "  (error " << err << ")\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ok, what.c_str());
+}
+
+void test_bilinear ()
+{
+    const int ncomp = 2;
+    Vector<BCRec> bcr(ncomp);
+    for (int r : {2, 3, 4}) {
+        const Real h = 0.25;
+        Geometry cgeom, fgeom;
+        make_geoms(r, h, cgeom, fgeom);
+        Real err = 0.;
+        for (Box const& fine_region : fine_regions()) {
+            FArrayBox crse(cell_bilinear_interp.CoarseBox(fine_region, r), ncomp);
+            FArrayBox fine(fine_region, ncomp), exact(fine_region, ncomp);
+            fill_linear(crse, h);
+            fill_linear(exact, h/r);
+            cell_bilinear_interp.interp(crse, 0, fine, 0, ncomp, fine_region, IntVect(r),
+                                        cgeom, fgeom, bcr, 0, 0, RunOn::Cpu);
+            err = std::max(err, max_diff(fine, exact, fine_region, ncomp));
+        }
+        check(err < 1.e-12, "CellBilinear is exact for linear, ratio "+std::to_string(r), err);
+    }
+}
+
+void test_quadratic ()
+{
+#if (AMREX_SPACEDIM == 2)
+    const int ncomp = 2;
+    Vector<BCRec> bcr(ncomp);
+    for (int r : {2, 3, 4}) {
+        const Real h = 0.25;
+        Geometry cgeom, fgeom;
+        make_geoms(r, h, cgeom, fgeom);
+        Real err = 0.;
+        for (Box const& fine_region : fine_regions()) {
+            FArrayBox crse(quadratic_interp.CoarseBox(fine_region, r), ncomp);
+            FArrayBox fine(fine_region, ncomp), exact(fine_region, ncomp);
+            fill_linear(crse, h);
+            fill_linear(exact, h/r);
+            quadratic_interp.interp(crse, 0, fine, 0, ncomp, fine_region, IntVect(r),
+                                    cgeom, fgeom, bcr, 0, 0, RunOn::Cpu);
+            err = std::max(err, max_diff(fine, exact, fine_region, ncomp));
+        }
+        check(err < 1.e-12, "CellQuadratic is exact for linear, ratio "+std::to_string(r), err);
+    }
+#endif
+}
+
+void test_quartic ()
+{
+    const int ncomp = 2;
+    Vector<BCRec> bcr(ncomp);
+    for (int r : {2, 4}) {
+        const Real h = 0.25;
+        Geometry cgeom, fgeom;
+        make_geoms(r, h, cgeom, fgeom);
+        Real err = 0., cons = 0.;
+        for (Box const& fine_region : fine_regions()) {
+            FArrayBox crse(quartic_interp.CoarseBox(fine_region, r), ncomp);
+            FArrayBox fine(fine_region, ncomp), exact(fine_region, ncomp);
+            fill_quartic(crse, h);
+            fill_quartic(exact, h/r);
+            quartic_interp.interp(crse, 0, fine, 0, ncomp, fine_region, IntVect(r),
+                                  cgeom, fgeom, bcr, 0, 0, RunOn::Cpu);
+            err = std::max(err, max_diff(fine, exact, fine_region, ncomp));
+
+            const Box aligned = amrex::refine(amrex::coarsen(fine_region,r),r);
+            FArrayBox fine2(aligned, ncomp);
+            fill_random(crse, -1., 1.);
+            quartic_interp.interp(crse, 0, fine2, 0, ncomp, aligned, IntVect(r),
+                                  cgeom, fgeom, bcr, 0, 0, RunOn::Cpu);
+            cons = std::max(cons, max_cons_error(crse, fine2, aligned, r, ncomp));
+        }
+        check(err < 1.e-12, "CellConservativeQuartic is exact for quartics, ratio "
+              +std::to_string(r), err);
+        check(cons < 1.e-13, "CellConservativeQuartic conserves, ratio "+std::to_string(r), cons);
+    }
+}
+
+void test_protect ()
+{
+#if (AMREX_SPACEDIM > 1)
+    // Component 0 is the sum of components 1 to nvar-2.
+    const int nvar = 5;
+    Vector<BCRec> bcr(nvar);
+    for (int r : {2, 3, 4}) {
+        Geometry cgeom, fgeom;
+        make_geoms(r, 1.0, cgeom, fgeom);
+        Real cons = 0., sum = 0.;
+        for (Box const& region : fine_regions()) {
+            const Box fine_region = amrex::refine(amrex::coarsen(region,r),r);
+            FArrayBox crse(protected_interp.CoarseBox(fine_region, r), nvar);
+            FArrayBox fine(fine_region, nvar), state(fine_region, nvar), fine0(fine_region, nvar);
+            crse.setVal<RunOn::Host>(0.0);
+            fill_random(fine, -1., 0.5);
+            fill_random(state, -0.3, 1.);
+            fine0.copy<RunOn::Host>(fine);
+            protected_interp.protect(crse, 0, fine, 0, state, 0, nvar, fine_region, IntVect(r),
+                                     cgeom, fgeom, bcr, RunOn::Cpu);
+
+            // The corrections of components 1 to nvar-2 sum to the same in each coarse cell.
+            FArrayBox avg0(amrex::coarsen(fine_region,r), nvar);
+            avg0.setVal<RunOn::Host>(0.0);
+            auto const& a0 = avg0.array();
+            auto const& f0 = fine0.const_array();
+            amrex::LoopOnCpu(fine_region, nvar, [&] (int i, int j, int k, int n) noexcept
+            {
+                IntVect iv(AMREX_D_DECL(i,j,k));
+                iv.coarsen(r);
+                a0(iv,n) += f0(i,j,k,n) / (AMREX_D_TERM(r,*r,*r));
+            });
+            FArrayBox avg(amrex::coarsen(fine_region,r), nvar-2);
+            avg.copy<RunOn::Host>(avg0, 1, 0, nvar-2);
+            FArrayBox fine1(fine_region, nvar-2);
+            fine1.copy<RunOn::Host>(fine, 1, 0, nvar-2);
+            cons = std::max(cons, max_cons_error(avg, fine1, fine_region, r, nvar-2));
+
+            auto const& f = fine.const_array();
+            amrex::LoopOnCpu(fine_region, [&] (int i, int j, int k) noexcept
+            {
+                Real s = 0.;
+                for (int n = 1; n < nvar-1; ++n) s += f(i,j,k,n);
+                sum = std::max(sum, std::abs(s - f(i,j,k,0)));
+            });
+        }
+        check(cons < 1.e-12, "CellConservativeProtected conserves, ratio "+std::to_string(r), cons);
+        check(sum < 1.e-12, "CellConservativeProtected sums the species, ratio "
+              +std::to_string(r), sum);
+    }
+#endif
+}
+
+// Throughput of InterpFromCoarseLevel with each interpolater, which is the
+// interpolation part of FillPatchTwoLevels.
+void benchmark ()
+{
+    int n_cell = 64;
+    int max_grid_size = 32;
+    int ncomp = 3;
+    int nsteps = 10;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("ncomp", ncomp);
+        pp.query("nsteps", nsteps);
+    }
+
+    struct Entry {
+        std::string name;
+        Interpolater* mapper;
+    };
+    Vector<Entry> entries {{"CellBilinear", &cell_bilinear_interp},
+#if (AMREX_SPACEDIM == 2)
+                           {"CellQuadratic", &quadratic_interp},
+#endif
+                           {"CellConservativeQuartic", &quartic_interp},
+                           {"CellConservativeLinear", &cell_cons_interp},
+                           {"PCInterp", &pc_interp}};
+
+    for (int r : {2, 4}) {
+        const IntVect ratio(r);
+        Box cdomain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+        Geometry cgeom(cdomain, rb, CoordSys::cartesian, is_periodic);
+        Geometry fgeom(amrex::refine(cdomain,ratio), rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray cba(cdomain);
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+        MultiFab cmf(cba, cdm, ncomp, 0);
+        for (MFIter mfi(cmf); mfi.isValid(); ++mfi) {
+            fill_random(cmf[mfi], -1., 1.);
+        }
+
+        // The fine level covers the middle half of the domain in each direction.
+        BoxArray fba(amrex::refine(amrex::grow(cdomain, -n_cell/4), ratio));
+        fba.maxSize(max_grid_size);
+        DistributionMapping fdm(fba);
+        MultiFab fmf(fba, fdm, ncomp, 0);
+
+        Vector<BCRec> bcs(ncomp);
+        PhysBCFunctNoOp bcnoop;
+
+        for (auto const& e : entries) {
+            InterpFromCoarseLevel(fmf, 0.0, cmf, 0, 0, ncomp, cgeom, fgeom,
+                                  bcnoop, 0, bcnoop, 0, ratio, e.mapper, bcs, 0);
+            Real t = amrex::second();
+            for (int istep = 0; istep < nsteps; ++istep) {
+                InterpFromCoarseLevel(fmf, 0.0, cmf, 0, 0, ncomp, cgeom, fgeom,
+                                      bcnoop, 0, bcnoop, 0, ratio, e.mapper, bcs, 0);
+            }
+            t = amrex::second() - t;
+            ParallelDescriptor::ReduceRealMax(t);
+            const Real mcells = static_cast<Real>(fba.numPts()) * ncomp * nsteps / t * 1.e-6;
+            amrex::Print() << "  ratio " << r << "  " << std::left << std::setw(26) << e.name
+                           << std::right << std::setw(10) << std::fixed << std::setprecision(2)
+                           << mcells << " M fine cell components per second\n"
+                           << std::defaultfloat << std::setprecision(6);
+        }
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        amrex::Print() << "Checking the interpolaters\n";
+        test_bilinear();
+        test_quadratic();
+        test_quartic();
+        test_protect();
+
+        amrex::Print() << "\nInterpFromCoarseLevel throughput\n";
+        benchmark();
+    }
+    amrex::Finalize();
+}
@@ -1,6 +1,7 @@
 #include "MyTest.H"
 
 #include <AMReX_MLEBABecLap.H>
+#include <AMReX_MLGMRESSolver.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_MultiFabUtil.H>
 #include <AMReX_EBMultiFabUtil.H>
@@ -8,6 +9,7 @@
 #include <AMReX_EB2.H>
 
 #include <cmath>
+#include <limits>
 
 using namespace amrex;
 
@@ -48,6 +50,10 @@ MyTest::solve ()
 
     LPInfo info;
     info.setMaxCoarseningLevel(max_coarsening_level);
+    info.setAgglomeration(agglomeration);
+    info.setConsolidation(consolidation);
+    if (agg_grid_size > 0) info.setAgglomerationGridSize(agg_grid_size);
+    if (con_grid_size > 0) info.setConsolidationGridSize(con_grid_size);
 
     MLEBABecLap mleb (geom, grids, dmap, info, amrex::GetVecOfConstPtrs(factory));
     mleb.setMaxOrder(linop_maxorder);
@@ -82,7 +88,87 @@ MyTest::solve ()
     if (use_petsc) mlmg.setBottomSolver(MLMG::BottomSolver::petsc); 
     const Real tol_rel = reltol;
     const Real tol_abs = 0.0;
-    mlmg.solve(amrex::GetVecOfPtrs(phi), amrex::GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
+    if (use_gmres) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(max_level == 0, "use_gmres needs max_level = 0");
+        MLGMRESSolver gmres(mlmg, (gmres_type == "gmres") ? MLGMRESSolver::Type::GMRES
+                                                          : MLGMRESSolver::Type::FGMRES);
+        gmres.setVerbose(verbose);
+        gmres.setMaxIter(max_iter);
+        gmres.setRestartLength(gmres_restart);
+        gmres.solve(phi[0], rhs[0], tol_rel, tol_abs);
+    } else {
+        mlmg.solve(amrex::GetVecOfPtrs(phi), amrex::GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
+    }
+
+    if (n_timing_solves > 0)
+    {
+        // Solve from zero again, with the same number of V-cycles each time
+        const int niters = mlmg.getNumIters();
+        mlmg.setVerbose(0);
+        mlmg.setBottomVerbose(0);
+        mlmg.setMaxIter(niters);
+        mlmg.setFixedIter(niters);
+        Vector<MultiFab> sol(max_level+1);
+        for (int ilev = 0; ilev <= max_level; ++ilev) {
+            sol[ilev].define(grids[ilev], dmap[ilev], 1, 1, MFInfo(), *factory[ilev]);
+        }
+        Real tmin = std::numeric_limits<Real>::max();
+        Real tsum = 0.0;
+        for (int i = 0; i < n_timing_solves; ++i) {
+            for (int ilev = 0; ilev <= max_level; ++ilev) {
+                MultiFab::Copy(sol[ilev], phi[ilev], 0, 0, 1, 1);
+                sol[ilev].setVal(0.0, 0, 1, 0);
+            }
+            ParallelDescriptor::Barrier();
+            Real t = amrex::second();
+            mlmg.solve(amrex::GetVecOfPtrs(sol), amrex::GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
+            t = amrex::second() - t;
+            ParallelDescriptor::ReduceRealMax(t);
+            tmin = std::min(tmin, t);
+            tsum += t;
+        }
+        amrex::Print() << "Time per V-cycle over " << n_timing_solves << " solves: min "
+                       << tmin/niters << ", mean " << tsum/(n_timing_solves*niters) << "\n";
+    }
+}
+
+void
+MyTest::checkHierarchyCache ()
+{
+    if (!check_hierarchy_cache) return;
+
+    // The MG levels distributed by cost depend on the EB, so the hierarchy
+    // cached by the last solve must not be reused for another EB on the
+    // same grids.
+    ParmParse pp("eb2");
+    std::string geom_type;
+    pp.get("geom_type", geom_type);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(geom_type == "sphere",
+                                     "check_hierarchy_cache needs eb2.geom_type = sphere");
+    Vector<Real> center;
+    pp.getarr("sphere_center", center);
+    for (auto& c : center) c = 1.0 - c;
+    pp.addarr("sphere_center", center);
+    initializeEB();
+
+    initData();
+    solve();
+    Vector<MultiFab> phi_cached(max_level+1);
+    for (int ilev = 0; ilev <= max_level; ++ilev) {
+        phi_cached[ilev].define(grids[ilev], dmap[ilev], 1, 0);
+        MultiFab::Copy(phi_cached[ilev], phi[ilev], 0, 0, 1, 0);
+    }
+
+    MLLinOp::clearHierarchyCache();
+    initData();
+    solve();
+    for (int ilev = 0; ilev <= max_level; ++ilev) {
+        MultiFab::Subtract(phi_cached[ilev], phi[ilev], 0, 0, 1, 0);
+        const Real diff = phi_cached[ilev].norm0();
+        amrex::Print() << "Level " << ilev << ": max difference to the solution without"
+                       << " the cached MG hierarchy = " << diff << std::endl;
+        AMREX_ALWAYS_ASSERT(diff == 0.0);
+    }
 }
 
 void
@@ -112,6 +198,8 @@ MyTest::readParameters ()
     pp.query("max_grid_size", max_grid_size);
     pp.query("is_periodic", is_periodic);
     pp.query("eb_is_dirichlet", eb_is_dirichlet);
+    pp.query("coef_contrast", coef_contrast);
+    pp.query("coef_blocks", coef_blocks);
 
     pp.query("plot_file", plot_file_name);
 
@@ -134,6 +222,15 @@ MyTest::readParameters ()
     pp.query("reltol", reltol);
     pp.query("linop_maxorder", linop_maxorder);
     pp.query("max_coarsening_level", max_coarsening_level);
+    pp.query("agglomeration", agglomeration);
+    pp.query("consolidation", consolidation);
+    pp.query("agg_grid_size", agg_grid_size);
+    pp.query("con_grid_size", con_grid_size);
+    pp.query("n_timing_solves", n_timing_solves);
+    pp.query("check_hierarchy_cache", check_hierarchy_cache);
+    pp.query("use_gmres", use_gmres);
+    pp.query("gmres_type", gmres_type);
+    pp.query("gmres_restart", gmres_restart);
 #ifdef AMREX_USE_HYPRE
     pp.query("use_hypre", use_hypre);
 #endif
@@ -148,6 +245,7 @@ MyTest::initGrids ()
     int nlevels = max_level + 1;
     geom.resize(nlevels);
     grids.resize(nlevels);
+    dmap.resize(nlevels);
 
     RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
     std::array<int,AMREX_SPACEDIM> isperiodic{AMREX_D_DECL(is_periodic,is_periodic,is_periodic)};
@@ -165,6 +263,7 @@ MyTest::initGrids ()
     {
         grids[ilev].define(domain);
         grids[ilev].maxSize(max_grid_size);
+        dmap[ilev].define(grids[ilev]);
         domain.grow(-n_cell/4);   // fine level cover the middle of the coarse domain
         domain.refine(ref_ratio); 
     }
@@ -173,8 +272,15 @@ MyTest::initGrids ()
 void
 MyTest::initData ()
 {
+    // The data are built from scratch, e.g., for a new EB.
+    phi.clear();
+    rhs.clear();
+    acoef.clear();
+    bcoef.clear();
+    bcoef_eb.clear();
+    factory.clear();
+
     int nlevels = max_level + 1;
-    dmap.resize(nlevels);
     factory.resize(nlevels);
     phi.resize(nlevels);
     rhs.resize(nlevels);
@@ -184,7 +290,6 @@ MyTest::initData ()
 
     for (int ilev = 0; ilev < nlevels; ++ilev)
     {
-        dmap[ilev].define(grids[ilev]);
         const EB2::IndexSpace& eb_is = EB2::IndexSpace::top();
         const EB2::Level& eb_level = eb_is.getLevel(geom[ilev]);
         factory[ilev].reset(new EBFArrayBoxFactory(eb_level, geom[ilev], grids[ilev], dmap[ilev],
@@ -211,6 +316,28 @@ MyTest::initData ()
 
         const auto dx = geom[ilev].CellSizeArray();
 
+        if (coef_contrast != 1.0)
+        {
+            const int nblk = geom[ilev].Domain().length(0) / coef_blocks;
+            const Real contrast = coef_contrast;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+            {
+                for (MFIter mfi(bcoef[ilev][idim]); mfi.isValid(); ++mfi)
+                {
+                    const Box& bx = mfi.validbox();
+                    Array4<Real> const& fab = bcoef[ilev][idim].array(mfi);
+                    amrex::ParallelFor(bx,
+                    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                    {
+                        const int parity = AMREX_D_TERM(amrex::coarsen(i,nblk),
+                                                       + amrex::coarsen(j,nblk),
+                                                       + amrex::coarsen(k,nblk));
+                        if (parity % 2 != 0) fab(i,j,k) = contrast;
+                    });
+                }
+            }
+        }
+
         if (is_periodic)
         {
             const Real pi = 4.0*std::atan(1.0);
@@ -13,6 +13,7 @@ int main (int argc, char* argv[])
             mytest.solve();
             mytest.writePlotfile();
         }
+        mytest.checkHierarchyCache();
     }
 
     amrex::Finalize();
@@ -0,0 +1,281 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLNodeLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, std::string const& what)
+{
+    amrex::Print() << "  " << std::left << std::setw(60) << what
+                   << (ok ? "passed" : "FAILED") << "\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ok, what.c_str());
+}
+
+struct Params
+{
+    int n_cell = 64;
+    int max_grid_size = 32;
+    int max_coarsening_level = 2;
+    Real contrast = 1.e3;
+    Real tol_rel = 1.e-8;
+    int verbose = 0;
+};
+
+// The coefficient is contrast in a few balls and 1 elsewhere.
+void fill_coef (MultiFab& coef, Geometry const& geom, Real contrast)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const Real c[4][3] = {{0.3,0.3,0.3}, {0.7,0.4,0.6}, {0.4,0.75,0.5}, {0.6,0.6,0.2}};
+    for (MFIter mfi(coef); mfi.isValid(); ++mfi) {
+        auto const& a = coef.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k) noexcept
+        {
+            const Real x[3] = {problo[0]+(i+Real(0.5))*dx[0],
+                               problo[1]+(j+Real(0.5))*dx[1],
+                               problo[2]+(k+Real(0.5))*dx[2]};
+            a(i,j,k) = 1.0;
+            for (auto const& b : c) {
+                const Real d2 = (x[0]-b[0])*(x[0]-b[0]) + (x[1]-b[1])*(x[1]-b[1])
+                    + (x[2]-b[2])*(x[2]-b[2]);
+                if (d2 < 0.15*0.15) a(i,j,k) = contrast;
+            }
+        });
+    }
+}
+
+// sin(2 pi x) sin(2 pi y) sin(2 pi z) at the cell centers or nodes
+void fill_rhs (MultiFab& rhs, Geometry const& geom, Real shift)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const Real off = rhs.ixType().cellCentered() ? 0.5 : 0.0;
+    const Real twopi = 2.*M_PI;
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+        auto const& a = rhs.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            a(i,j,k) = std::sin(twopi*(problo[0]+(i+off)*dx[0]) + shift)
+                *      std::sin(twopi*(problo[1]+(j+off)*dx[1]))
+                *      std::sin(twopi*(problo[2]+(k+off)*dx[2]));
+        });
+    }
+}
+
+struct Problem
+{
+    std::string name;
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    MultiFab coef;
+    MultiFab rhs;
+    bool singular;
+    std::function<std::unique_ptr<MLLinOp>()> make;
+};
+
+std::unique_ptr<Problem> cell_problem (Params const& p, bool periodic)
+{
+    std::unique_ptr<Problem> prob(new Problem);
+    prob->name = periodic ? "cell, periodic" : "cell, Dirichlet";
+    prob->singular = periodic;
+    RealBox rb({0.,0.,0.}, {1.,1.,1.});
+    Array<int,AMREX_SPACEDIM> is_per{periodic,periodic,periodic};
+    prob->geom.define(Box(IntVect(0), IntVect(p.n_cell-1)), rb, 0, is_per);
+    prob->ba = BoxArray(prob->geom.Domain());
+    prob->ba.maxSize(p.max_grid_size);
+    prob->dm.define(prob->ba);
+    prob->coef.define(prob->ba, prob->dm, 1, 1);
+    fill_coef(prob->coef, prob->geom, p.contrast);
+    prob->rhs.define(prob->ba, prob->dm, 1, 0);
+    fill_rhs(prob->rhs, prob->geom, 0.);
+
+    Problem* pp = prob.get();
+    prob->make = [pp, p, periodic] () {
+        LPInfo info;
+        info.setMaxCoarseningLevel(p.max_coarsening_level);
+        std::unique_ptr<MLABecLaplacian> op(new MLABecLaplacian({pp->geom}, {pp->ba}, {pp->dm}, info));
+        const LinOpBCType bc = periodic ? LinOpBCType::Periodic : LinOpBCType::Dirichlet;
+        op->setDomainBC({AMREX_D_DECL(bc,bc,bc)}, {AMREX_D_DECL(bc,bc,bc)});
+        op->setLevelBC(0, nullptr);
+        op->setScalars(0.0, 1.0);
+        Array<MultiFab,AMREX_SPACEDIM> face;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            face[idim].define(amrex::convert(pp->ba, IntVect::TheDimensionVector(idim)), pp->dm, 1, 0);
+        }
+        amrex::average_cellcenter_to_face(GetArrOfPtrs(face), pp->coef, pp->geom);
+        op->setBCoeffs(0, amrex::GetArrOfConstPtrs(face));
+        return std::unique_ptr<MLLinOp>(std::move(op));
+    };
+    return prob;
+}
+
+// Periodic in x and y, Dirichlet in z
+std::unique_ptr<Problem> node_problem (Params const& p)
+{
+    std::unique_ptr<Problem> prob(new Problem);
+    prob->name = "node, Dirichlet in z";
+    prob->singular = false;
+    RealBox rb({0.,0.,0.}, {1.,1.,1.});
+    Array<int,AMREX_SPACEDIM> is_per{1,1,0};
+    prob->geom.define(Box(IntVect(0), IntVect(p.n_cell-1)), rb, 0, is_per);
+    prob->ba = BoxArray(prob->geom.Domain());
+    prob->ba.maxSize(p.max_grid_size);
+    prob->dm.define(prob->ba);
+    prob->coef.define(prob->ba, prob->dm, 1, 1);
+    fill_coef(prob->coef, prob->geom, p.contrast);
+    prob->rhs.define(amrex::convert(prob->ba, IntVect::TheNodeVector()), prob->dm, 1, 0);
+    fill_rhs(prob->rhs, prob->geom, 0.);
+
+    Problem* pp = prob.get();
+    prob->make = [pp, p] () {
+        LPInfo info;
+        info.setMaxCoarseningLevel(p.max_coarsening_level);
+        std::unique_ptr<MLNodeLaplacian> op(new MLNodeLaplacian({pp->geom}, {pp->ba}, {pp->dm}, info));
+        op->setDomainBC({LinOpBCType::Periodic, LinOpBCType::Periodic, LinOpBCType::Dirichlet},
+                        {LinOpBCType::Periodic, LinOpBCType::Periodic, LinOpBCType::Dirichlet});
+        op->setSigma(0, pp->coef);
+        return std::unique_ptr<MLLinOp>(std::move(op));
+    };
+    return prob;
+}
+
+struct Result
+{
+    int niters = 0;
+    int ncg = 0;
+    Real time = 0.;
+    MultiFab sol;
+};
+
+// Solves twice with a different right hand side the second time and
+// returns the result of the second solve, which reuses the setup.
+Result run (Problem& prob, Params const& p, BottomSolver bottom, Long maxsize = -1)
+{
+    Result r;
+    r.sol.define(prob.rhs.boxArray(), prob.dm, 1, 1);
+
+    std::unique_ptr<MLLinOp> op = prob.make();
+    MLMG mlmg(*op);
+    mlmg.setVerbose(p.verbose);
+    mlmg.setMaxIter(200);
+    mlmg.setBottomSolver(bottom);
+    if (maxsize >= 0) mlmg.setBottomDirectMaxSize(maxsize);
+
+    MultiFab rhs(prob.rhs.boxArray(), prob.dm, 1, 0);
+    fill_rhs(rhs, prob.geom, 0.5);
+    r.sol.setVal(0.0);
+    mlmg.solve({&r.sol}, {&rhs}, p.tol_rel, 0.0);
+
+    r.sol.setVal(0.0);
+    Real t = amrex::second();
+    mlmg.solve({&r.sol}, {&prob.rhs}, p.tol_rel, 0.0);
+    r.time = amrex::second() - t;
+    ParallelDescriptor::ReduceRealMax(r.time);
+
+    r.niters = mlmg.getNumIters();
+    for (int n : mlmg.getNumCGIters()) r.ncg += n;
+    return r;
+}
+
+// max |a-b| / max |a|, up to a constant for singular problems
+Real rel_diff (MultiFab const& a, MultiFab const& b, bool singular)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), 1, 0);
+    MultiFab::Copy(d, a, 0, 0, 1, 0);
+    MultiFab::Subtract(d, b, 0, 0, 1, 0);
+    if (singular) {
+        d.plus(-d.sum()/d.boxArray().numPts(), 0, 1);
+    }
+    return d.norm0() / a.norm0();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Params p;
+        {
+            ParmParse pp;
+            pp.query("n_cell", p.n_cell);
+            pp.query("max_grid_size", p.max_grid_size);
+            pp.query("max_coarsening_level", p.max_coarsening_level);
+            pp.query("contrast", p.contrast);
+            pp.query("tol_rel", p.tol_rel);
+            pp.query("verbose", p.verbose);
+        }
+
+        Vector<std::unique_ptr<Problem> > probs;
+        probs.push_back(cell_problem(p, false));
+        probs.push_back(cell_problem(p, true));
+        probs.push_back(node_problem(p));
+
+        amrex::Print() << "Checking the direct bottom solver against bicgstab\n";
+        Vector<Result> res_bicg, res_direct;
+        for (auto& prob : probs) {
+            res_bicg.push_back(run(*prob, p, BottomSolver::bicgstab));
+            res_direct.push_back(run(*prob, p, BottomSolver::direct));
+            const Result& a = res_bicg.back();
+            const Result& b = res_direct.back();
+            check(rel_diff(a.sol, b.sol, prob->singular) < 1.e-6, prob->name + ": same solution");
+        }
+        {
+            Result r = run(*probs[0], p, BottomSolver::direct, 1000);
+            check(r.niters == res_bicg[0].niters && r.ncg == res_bicg[0].ncg,
+                  "too large for the direct solver, bicgstab instead");
+        }
+        {
+            // The fallback to bicgstab is for one solve only.  Once the
+            // problem fits, the same MLMG uses the direct solver again.
+            Problem& prob = *probs[0];
+            std::unique_ptr<MLLinOp> op = prob.make();
+            MLMG mlmg(*op);
+            mlmg.setVerbose(p.verbose);
+            mlmg.setMaxIter(200);
+            mlmg.setBottomSolver(BottomSolver::direct);
+            mlmg.setBottomDirectMaxSize(1000);
+            MultiFab sol(prob.rhs.boxArray(), prob.dm, 1, 1);
+            sol.setVal(0.0);
+            mlmg.solve({&sol}, {&prob.rhs}, p.tol_rel, 0.0);
+            check(!mlmg.getNumCGIters().empty(), "bicgstab while too large");
+            mlmg.setBottomDirectMaxSize(Long(1) << 25);
+            sol.setVal(0.0);
+            mlmg.solve({&sol}, {&prob.rhs}, p.tol_rel, 0.0);
+            check(mlmg.getNumCGIters().empty() && mlmg.getNumIters() == res_direct[0].niters,
+                  "direct solver again once the problem fits");
+        }
+
+        amrex::Print() << "\n" << p.n_cell << "^3 cells, coefficient contrast " << p.contrast
+                       << ", " << p.max_coarsening_level << " coarsenings\n"
+                       << "  " << std::left << std::setw(24) << "problem" << std::setw(12) << "bottom"
+                       << std::right << std::setw(8) << "iters" << std::setw(14) << "bottom iters"
+                       << std::setw(12) << "seconds" << "\n";
+        for (int i = 0; i < probs.size(); ++i) {
+            for (int m = 0; m < 2; ++m) {
+                const Result& r = (m == 0) ? res_bicg[i] : res_direct[i];
+                amrex::Print() << "  " << std::left << std::setw(24) << probs[i]->name
+                               << std::setw(12) << (m == 0 ? "bicgstab" : "direct")
+                               << std::right << std::setw(8) << r.niters
+                               << std::setw(14) << r.ncg
+                               << std::fixed << std::setprecision(3)
+                               << std::setw(12) << r.time << std::defaultfloat << "\n";
+            }
+        }
+    }
+    amrex::Finalize();
+}
@@ -4,6 +4,7 @@
 #include <AMReX_EB2.H>
 #include <AMReX_EB2_IF.H>
 #include <AMReX_MLEBTensorOp.H>
+#include <AMReX_MLTensorOp.H>
 #include <AMReX_MLMG.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_MultiFabUtil.H>
@@ -12,6 +13,31 @@
 
 using namespace amrex;
 
+namespace {
+
+// Min and mean time per apply of the homogeneous operator at the finest level
+std::pair<Real,Real> time_apply (MLLinOp& linop, MultiFab& out, MultiFab& in, int n_apply)
+{
+    {
+        MLMG mlmg(linop);
+        mlmg.apply({&out}, {&in});  // prepares the operator
+    }
+    Real tmin = std::numeric_limits<Real>::max();
+    Real tsum = 0.0;
+    for (int i = 0; i < n_apply; ++i) {
+        ParallelDescriptor::Barrier();
+        Real t0 = amrex::second();
+        linop.apply(0, 0, out, in, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Real t = amrex::second() - t0;
+        ParallelDescriptor::ReduceRealMax(t);
+        tmin = std::min(tmin, t);
+        tsum += t;
+    }
+    return std::make_pair(tmin, tsum/n_apply);
+}
+
+}
+
 MyTest::MyTest ()
 {
     readParameters();
@@ -96,6 +122,35 @@ MyTest::solve ()
         ebtensorop.setEBShearViscosity(0, eta);
     }
 
+    if (n_apply > 0) {
+        Array<MultiFab,AMREX_SPACEDIM> face_bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const BoxArray& ba = amrex::convert(grids, IntVect::TheDimensionVector(idim));
+            face_bcoef[idim].define(ba, dmap, 1, 0);
+        }
+        amrex::average_cellcenter_to_face(amrex::GetArrOfPtrs(face_bcoef), eta, geom);
+
+        // The same operator without EB, for comparison
+        MLTensorOp tensorop({geom}, {grids}, {dmap}, info);
+        tensorop.setMaxOrder(linop_maxorder);
+        tensorop.setDomainBC({AMREX_D_DECL(v_lo_bc,v_lo_bc,v_lo_bc)},
+                             {AMREX_D_DECL(v_hi_bc,v_hi_bc,v_hi_bc)});
+        tensorop.setLevelBC(0, &solution);
+        tensorop.setACoeffs(0, a);
+        tensorop.setShearViscosity(0, amrex::GetArrOfConstPtrs(face_bcoef));
+
+        MultiFab out(grids, dmap, AMREX_SPACEDIM, 0, MFInfo(), *factory);
+        MultiFab in(grids, dmap, AMREX_SPACEDIM, 1, MFInfo(), *factory);
+        MultiFab::Copy(in, exact, 0, 0, AMREX_SPACEDIM, 1);
+
+        auto teb = time_apply(ebtensorop, out, in, n_apply);
+        auto t = time_apply(tensorop, out, in, n_apply);
+        amrex::Print() << "Time per apply over " << n_apply << " applies: min, mean\n"
+                       << "  MLEBTensorOp: " << teb.first << ", " << teb.second << "\n"
+                       << "  MLTensorOp:   " << t.first << ", " << t.second << "\n";
+    }
+
     MLMG mlmg(ebtensorop);
     mlmg.setMaxIter(max_iter);
     mlmg.setMaxFmgIter(max_fmg_iter);
@@ -139,6 +194,7 @@ MyTest::readParameters ()
     pp.query("agglomeration", agglomeration);
     pp.query("consolidation", consolidation);
     pp.query("max_coarsening_level", max_coarsening_level);
+    pp.query("n_apply", n_apply);
 }
 
 void
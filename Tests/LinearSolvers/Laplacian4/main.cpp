@@ -0,0 +1,284 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLLaplacian4.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, std::string const& what)
+{
+    amrex::Print() << "  " << std::left << std::setw(60) << what
+                   << (ok ? "passed" : "FAILED") << "\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ok, what.c_str());
+}
+
+struct Params
+{
+    Vector<int> n_cell {16, 32, 64};
+    int max_grid_size = 32;
+    Real tol_rel = 1.e-11;
+    int verbose = 0;
+};
+
+const Real alpha = 1.0;
+const Real beta = 1.0;
+
+// u = prod_d cos(k_d x_d + th_d), with alpha u - beta Lap u = c u
+struct Exact
+{
+    Real k[3];
+    Real th[3];
+
+    Real c () const {
+        Real r = alpha;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) r += beta*k[d]*k[d];
+        return r;
+    }
+    // Average of the factor over [a,b]
+    Real avg (int d, Real a, Real b) const {
+        return (std::sin(k[d]*b+th[d]) - std::sin(k[d]*a+th[d])) / (k[d]*(b-a));
+    }
+    Real val (int d, Real x) const { return std::cos(k[d]*x+th[d]); }
+    Real der (int d, Real x) const { return -k[d]*std::sin(k[d]*x+th[d]); }
+};
+
+// Averages of u over the cells, and over the domain faces for the cells
+// outside the domain
+void fill_avg (MultiFab& mf, Geometry const& geom, Exact const& u, Real scale)
+{
+    const Box& domain = geom.Domain();
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k) noexcept
+        {
+            const IntVect iv(AMREX_D_DECL(i,j,k));
+            Real r = scale;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                const Real xlo = problo[d] + iv[d]*dx[d];
+                if (iv[d] < domain.smallEnd(d)) {
+                    r *= u.val(d, xlo+dx[d]);
+                } else if (iv[d] > domain.bigEnd(d)) {
+                    r *= u.val(d, xlo);
+                } else {
+                    r *= u.avg(d, xlo, xlo+dx[d]);
+                }
+            }
+            a(i,j,k) = r;
+        });
+    }
+}
+
+// Max error of the face averages of du/dx_d
+Real flux_error (Array<MultiFab,AMREX_SPACEDIM> const& grad, Geometry const& geom, Exact const& u)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    Real err = 0.0;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        for (MFIter mfi(grad[idim]); mfi.isValid(); ++mfi) {
+            auto const& g = grad[idim].const_array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+            {
+                const IntVect iv(AMREX_D_DECL(i,j,k));
+                Real r = 1.0;
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    const Real xlo = problo[d] + iv[d]*dx[d];
+                    r *= (d == idim) ? u.der(d, xlo) : u.avg(d, xlo, xlo+dx[d]);
+                }
+                err = std::max(err, std::abs(g(i,j,k)-r));
+            });
+        }
+    }
+    ParallelDescriptor::ReduceRealMax(err);
+    return err;
+}
+
+struct Case
+{
+    std::string name;
+    Exact u;
+    Array<LinOpBCType,AMREX_SPACEDIM> lobc;
+    Array<LinOpBCType,AMREX_SPACEDIM> hibc;
+    //! Solve on the middle of the domain with coarse data around it
+    bool crse_fine = false;
+};
+
+struct Result
+{
+    Real err = 0.;
+    Real flux_err = 0.;
+    int niters = 0;
+    Long ncells = 0;
+};
+
+Result run (Case const& c, int n, int order, Params const& p)
+{
+    Array<int,AMREX_SPACEDIM> is_periodic;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        is_periodic[idim] = (c.lobc[idim] == LinOpBCType::Periodic);
+    }
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    const Box domain(IntVect(0), IntVect(n-1));
+    Geometry geom(domain, rb, 0, is_periodic);
+
+    BoxArray ba(c.crse_fine ? Box(IntVect(n/4), IntVect(3*n/4-1)) : domain);
+    ba.maxSize(p.max_grid_size);
+    DistributionMapping dm(ba);
+
+    // Coarse data for the coarse/fine boundary
+    const int ratio = 2;
+    Geometry cgeom(amrex::coarsen(domain,ratio), rb, 0, is_periodic);
+    BoxArray cba(cgeom.Domain());
+    cba.maxSize(p.max_grid_size);
+    MultiFab crse(cba, DistributionMapping(cba), 1, 0);
+    fill_avg(crse, cgeom, c.u, 1.0);
+
+    std::unique_ptr<MLABecLaplacian> op;
+    if (order == 4) {
+        op.reset(new MLLaplacian4({geom}, {ba}, {dm}));
+    } else {
+        op.reset(new MLABecLaplacian({geom}, {ba}, {dm}));
+        op->setACoeffs(0, 1.0);
+        op->setBCoeffs(0, 1.0);
+    }
+    op->setDomainBC({c.lobc}, {c.hibc});
+    if (c.crse_fine) {
+        op->setCoarseFineBC(&crse, ratio);
+    }
+    op->setScalars(alpha, beta);
+
+    MultiFab sol(ba, dm, 1, 1);
+    MultiFab rhs(ba, dm, 1, 0);
+    MultiFab exact(ba, dm, 1, 0);
+    fill_avg(sol, geom, c.u, 1.0);
+    op->setLevelBC(0, &sol);
+    fill_avg(exact, geom, c.u, 1.0);
+    fill_avg(rhs, geom, c.u, c.u.c());
+    sol.setVal(0.0);
+
+    MLMG mlmg(*op);
+    mlmg.setVerbose(p.verbose);
+    mlmg.setMaxIter(200);
+    mlmg.solve({&sol}, {&rhs}, p.tol_rel, 0.0);
+
+    Result r;
+    r.niters = mlmg.getNumIters();
+    r.ncells = ba.numPts();
+    MultiFab::Subtract(sol, exact, 0, 0, 1, 0);
+    r.err = sol.norm0();
+
+    if (order == 4) {
+        MultiFab::Add(sol, exact, 0, 0, 1, 0);
+        Array<MultiFab,AMREX_SPACEDIM> grad;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            grad[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+        mlmg.getGradSolution({amrex::GetArrOfPtrs(grad)});
+        r.flux_err = flux_error(grad, geom, c.u);
+    }
+    return r;
+}
+
+void run_case (Case const& c, Params const& p)
+{
+    amrex::Print() << "\n" << c.name << "\n"
+                   << std::right << std::setw(6) << "n" << std::setw(10) << "cells"
+                   << std::setw(14) << "err, 2nd" << std::setw(6) << "rate"
+                   << std::setw(14) << "err, 4th" << std::setw(6) << "rate"
+                   << std::setw(14) << "grad err, 4th" << std::setw(6) << "rate"
+                   << std::setw(8) << "iters2" << std::setw(8) << "iters4" << "\n";
+
+    const int nn = p.n_cell.size();
+    Vector<Result> r2(nn), r4(nn);
+    for (int i = 0; i < nn; ++i) {
+        r2[i] = run(c, p.n_cell[i], 2, p);
+        r4[i] = run(c, p.n_cell[i], 4, p);
+        auto rate = [&] (Real Result::*e, Vector<Result> const& r) -> Real {
+            return (i == 0) ? 0.0 : std::log(r[i-1].*e/r[i].*e)/std::log(Real(p.n_cell[i])/p.n_cell[i-1]);
+        };
+        amrex::Print() << std::setw(6) << p.n_cell[i] << std::setw(10) << r4[i].ncells
+                       << std::scientific << std::setprecision(3)
+                       << std::setw(14) << r2[i].err
+                       << std::fixed << std::setprecision(2) << std::setw(6) << rate(&Result::err, r2)
+                       << std::scientific << std::setprecision(3)
+                       << std::setw(14) << r4[i].err
+                       << std::fixed << std::setprecision(2) << std::setw(6) << rate(&Result::err, r4)
+                       << std::scientific << std::setprecision(3)
+                       << std::setw(14) << r4[i].flux_err
+                       << std::fixed << std::setprecision(2) << std::setw(6) << rate(&Result::flux_err, r4)
+                       << std::defaultfloat
+                       << std::setw(8) << r2[i].niters << std::setw(8) << r4[i].niters << "\n";
+    }
+
+    if (nn >= 2) {
+        const Real rate4 = std::log(r4[nn-2].err/r4[nn-1].err)
+            / std::log(Real(p.n_cell[nn-1])/p.n_cell[nn-2]);
+        check(rate4 > 3.5, "fourth-order convergence");
+        bool fewer = true;
+        for (int i = 0; i+1 < nn; ++i) {
+            fewer = fewer && (r4[i].err < r2[i+1].err);
+        }
+        check(fewer, "4th order beats 2nd order with more cells");
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Params p;
+        {
+            ParmParse pp;
+            pp.queryarr("n_cell", p.n_cell);
+            pp.query("max_grid_size", p.max_grid_size);
+            pp.query("tol_rel", p.tol_rel);
+            pp.query("verbose", p.verbose);
+        }
+
+        Vector<Case> cases;
+        {
+            Case c;
+            c.name = "Dirichlet";
+            c.u = {{2.1*M_PI, 1.7*M_PI, 2.5*M_PI}, {0.3, 0.5, 0.7}};
+            c.lobc = {AMREX_D_DECL(LinOpBCType::Dirichlet,LinOpBCType::Dirichlet,LinOpBCType::Dirichlet)};
+            c.hibc = c.lobc;
+            cases.push_back(c);
+        }
+        {
+            Case c;
+            c.name = "Periodic, Neumann and Dirichlet";
+            c.u = {{2.0*M_PI, M_PI, 2.5*M_PI}, {0.3, 0.0, 0.7}};
+            c.lobc = {AMREX_D_DECL(LinOpBCType::Periodic,LinOpBCType::Neumann,LinOpBCType::Dirichlet)};
+            c.hibc = c.lobc;
+            cases.push_back(c);
+        }
+        {
+            Case c;
+            c.name = "Coarse/fine boundary";
+            c.u = {{2.1*M_PI, 1.7*M_PI, 2.5*M_PI}, {0.3, 0.5, 0.7}};
+            c.lobc = {AMREX_D_DECL(LinOpBCType::Dirichlet,LinOpBCType::Dirichlet,LinOpBCType::Dirichlet)};
+            c.hibc = c.lobc;
+            c.crse_fine = true;
+            cases.push_back(c);
+        }
+
+        for (auto const& c : cases) {
+            run_case(c, p);
+        }
+    }
+    amrex::Finalize();
+}
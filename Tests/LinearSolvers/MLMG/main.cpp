@@ -34,6 +34,7 @@ namespace {
     int max_level     = 1;
     int nlevels       = 2;
     int n_cell        = 64;
+    IntVect n_cells{AMREX_D_DECL(64,64,64)};
     int max_grid_size = 32;
     int ref_ratio     = 2;
     std::string boxes_file;
@@ -92,6 +93,14 @@ void build_geometry_and_grids (Vector<Geometry>& geom, Vector<BoxArray>& grids)
 {
     ParmParse pp;
     pp.query("n_cell", n_cell);
+    n_cells = IntVect(n_cell);
+    // A box shaped domain, e.g., 256 256 16 for a thin one
+    {
+        Vector<int> tmp;
+        if (pp.queryarr("n_cells", tmp)) {
+            n_cells = IntVect(tmp);
+        }
+    }
     pp.query("max_level", max_level);
     pp.query("max_grid_size", max_grid_size);
     pp.query("ref_ratio", ref_ratio);
@@ -109,6 +118,7 @@ void build_geometry_and_grids (Vector<Geometry>& geom, Vector<BoxArray>& grids)
             max_level = 0;
             nlevels = max_level + 1;
             n_cell = dmn.longside();
+            n_cells = IntVect(n_cell);
 
             geom.resize(nlevels);
             grids.resize(nlevels);
@@ -125,6 +135,7 @@ void build_geometry_and_grids (Vector<Geometry>& geom, Vector<BoxArray>& grids)
             dmn.coarsen(ref_ratio);
             dmn.setSmall(IntVect::TheZeroVector());
             n_cell = dmn.longside();
+            n_cells = IntVect(n_cell);
 
             geom.resize(nlevels);
             grids.resize(nlevels);
@@ -144,10 +155,7 @@ void build_geometry_and_grids (Vector<Geometry>& geom, Vector<BoxArray>& grids)
         geom.resize(nlevels);
         grids.resize(nlevels);
         
-        IntVect dom0_lo {IntVect::TheZeroVector()};
-        IntVect dom0_hi {AMREX_D_DECL(n_cell-1, n_cell-1, n_cell-1)};
-        
-        Box dom0 {dom0_lo, dom0_hi};
+        Box dom0 {IntVect::TheZeroVector(), n_cells-1};
         BoxArray ba0{dom0};
         
         grids[0] = ba0;
@@ -155,7 +163,7 @@ void build_geometry_and_grids (Vector<Geometry>& geom, Vector<BoxArray>& grids)
         
         for (int ilev=1, n=grids.size(); ilev < n; ++ilev)
         {
-            ba0.grow(-n_cell/4);
+            ba0.grow(-n_cells/4);
             ba0.refine(ref_ratio);
             grids[ilev] = ba0;
             grids[ilev].maxSize(max_grid_size);
@@ -164,6 +172,13 @@ void build_geometry_and_grids (Vector<Geometry>& geom, Vector<BoxArray>& grids)
     
     std::array<Real,AMREX_SPACEDIM> prob_lo{AMREX_D_DECL(0.,0.,0.)};
     std::array<Real,AMREX_SPACEDIM> prob_hi{AMREX_D_DECL(1.,1.,1.)};
+    {
+        // e.g., 1 1 0.01 for cells much thinner in z
+        Vector<Real> tmp;
+        if (pp.queryarr("prob_hi", tmp)) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) prob_hi[idim] = tmp[idim];
+        }
+    }
     RealBox real_box{prob_lo, prob_hi};
     
     const int coord = 0;  // Cartesian coordinates
@@ -173,9 +188,7 @@ void build_geometry_and_grids (Vector<Geometry>& geom, Vector<BoxArray>& grids)
         std::fill(is_periodic.begin(), is_periodic.end(), 1);
     }
 
-    IntVect dom0_lo {IntVect::TheZeroVector()};
-    IntVect dom0_hi {AMREX_D_DECL(n_cell-1, n_cell-1, n_cell-1)};
-    Box dom0 {dom0_lo, dom0_hi};
+    Box dom0 {IntVect::TheZeroVector(), n_cells-1};
     
     geom[0].define(dom0, &real_box, coord, is_periodic.data());
     for (int ilev=1, n=grids.size(); ilev < n; ++ilev)
@@ -19,7 +19,11 @@ static int cg_verbose = 0;
 static int linop_maxorder = 2;
 static bool agglomeration = false;
 static bool consolidation = false;
+static bool semicoarsening = false;
+static bool semicoarsening_anisotropic = false;
+static int max_semicoarsening_level = 0;
 static int  use_hypre = 0;
+static int num_solves = 1;
 }
 
 void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
@@ -43,7 +47,11 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
     pp.query("linop_maxorder", linop_maxorder);
     pp.query("agglomeration", agglomeration);
     pp.query("consolidation", consolidation);
+    pp.query("semicoarsening", semicoarsening);
+    pp.query("semicoarsening_anisotropic", semicoarsening_anisotropic);
+    pp.query("max_semicoarsening_level", max_semicoarsening_level);
     pp.query("use_hypre", use_hypre);
+    pp.query("num_solves", num_solves);
     pp.query("tol_rel", tol_rel);
     pp.query("tol_abs", tol_abs);
   }
@@ -52,51 +60,85 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
   info.setAgglomeration(agglomeration);
   info.setConsolidation(consolidation);
   info.setMaxCoarseningLevel(max_coarsening_level);
+  info.setSemicoarsening(semicoarsening);
+  info.setSemicoarseningAnisotropic(semicoarsening_anisotropic);
+  info.setMaxSemicoarseningLevel(max_semicoarsening_level);
 
   const int nlevels = geom.size();
 
   if (composite_solve) {
-    Vector<BoxArray> grids;
-    Vector<DistributionMapping> dmap;
-    Vector<MultiFab*> psoln;
-    Vector<MultiFab const*> prhs;
-    for (int ilev = 0; ilev < nlevels; ++ilev) {
-      grids.push_back(soln[ilev].boxArray());
-      dmap.push_back(soln[ilev].DistributionMap());
-      psoln.push_back(&(soln[ilev]));
-      prhs.push_back(&(rhs[ilev]));
-    }
+    // Like a time stepping code, build a new operator for every solve on
+    // the same grids.  With mg.cache_hierarchy = 1, the later solves reuse
+    // the coarsened grids and masks of the first one.  This reduces the
+    // setup cost, but does not remove it, and must not change the result.
+    int first_niters = -1;
+    Vector<MultiFab> first_soln(nlevels);
+    for (int isolve = 0; isolve < num_solves; ++isolve) {
+      if (isolve > 0) {
+        for (int ilev = 0; ilev < nlevels; ++ilev) {
+          soln[ilev].setVal(0.0);
+        }
+      }
 
-    MLABecLaplacian mlabec(geom, grids, dmap, info);
-    mlabec.setMaxOrder(linop_maxorder);
-    // BC
-    mlabec.setDomainBC({prob::bc_type, prob::bc_type, prob::bc_type},
-                       {prob::bc_type, prob::bc_type, prob::bc_type});
-    for (int ilev = 0; ilev < nlevels; ++ilev) {
-      mlabec.setLevelBC(ilev, psoln[ilev]);
-    }
-    mlabec.setScalars(prob::a, prob::b);
-    for (int ilev = 0; ilev < nlevels; ++ilev) {
-      mlabec.setACoeffs(ilev, alpha[ilev]);
-      std::array<MultiFab, AMREX_SPACEDIM> bcoefs;
-      for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-        const BoxArray& ba = amrex::convert(beta[ilev].boxArray(),
-                                            IntVect::TheDimensionVector(idim));
-        bcoefs[idim].define(ba, beta[ilev].DistributionMap(), 1, 0);
+      Vector<BoxArray> grids;
+      Vector<DistributionMapping> dmap;
+      Vector<MultiFab*> psoln;
+      Vector<MultiFab const*> prhs;
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        grids.push_back(soln[ilev].boxArray());
+        dmap.push_back(soln[ilev].DistributionMap());
+        psoln.push_back(&(soln[ilev]));
+        prhs.push_back(&(rhs[ilev]));
       }
-      amrex::average_cellcenter_to_face(amrex::GetArrOfPtrs(bcoefs),
-                                        beta[ilev], geom[ilev]);
-      mlabec.setBCoeffs(ilev, amrex::GetArrOfConstPtrs(bcoefs));
-    }
 
-    MLMG mlmg(mlabec);
-    mlmg.setMaxIter(max_iter);
-    mlmg.setMaxFmgIter(max_fmg_iter);
-    if (use_hypre) mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
-    mlmg.setVerbose(verbose);
-    mlmg.setBottomVerbose(cg_verbose);
+      MLABecLaplacian mlabec(geom, grids, dmap, info);
+      mlabec.setMaxOrder(linop_maxorder);
+      // BC
+      mlabec.setDomainBC({prob::bc_type, prob::bc_type, prob::bc_type},
+                         {prob::bc_type, prob::bc_type, prob::bc_type});
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        mlabec.setLevelBC(ilev, psoln[ilev]);
+      }
+      mlabec.setScalars(prob::a, prob::b);
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        mlabec.setACoeffs(ilev, alpha[ilev]);
+        std::array<MultiFab, AMREX_SPACEDIM> bcoefs;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+          const BoxArray& ba = amrex::convert(beta[ilev].boxArray(),
+                                              IntVect::TheDimensionVector(idim));
+          bcoefs[idim].define(ba, beta[ilev].DistributionMap(), 1, 0);
+        }
+        amrex::average_cellcenter_to_face(amrex::GetArrOfPtrs(bcoefs),
+                                          beta[ilev], geom[ilev]);
+        mlabec.setBCoeffs(ilev, amrex::GetArrOfConstPtrs(bcoefs));
+      }
+
+      MLMG mlmg(mlabec);
+      mlmg.setMaxIter(max_iter);
+      mlmg.setMaxFmgIter(max_fmg_iter);
+      if (use_hypre) mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
+      mlmg.setVerbose(verbose);
+      mlmg.setBottomVerbose(cg_verbose);
 
-    mlmg.solve(psoln, prhs, tol_rel, tol_abs);
+      mlmg.solve(psoln, prhs, tol_rel, tol_abs);
+
+      if (isolve == 0) {
+        first_niters = mlmg.getNumIters();
+        if (num_solves > 1) {
+          for (int ilev = 0; ilev < nlevels; ++ilev) {
+            first_soln[ilev].define(soln[ilev].boxArray(), soln[ilev].DistributionMap(), 1, 0);
+            MultiFab::Copy(first_soln[ilev], soln[ilev], 0, 0, 1, 0);
+          }
+        }
+      } else {
+        AMREX_ALWAYS_ASSERT(mlmg.getNumIters() == first_niters);
+        for (int ilev = 0; ilev < nlevels; ++ilev) {
+          MultiFab::Subtract(first_soln[ilev], soln[ilev], 0, 0, 1, 0);
+          AMREX_ALWAYS_ASSERT(first_soln[ilev].norm0() == 0.0);
+          MultiFab::Copy(first_soln[ilev], soln[ilev], 0, 0, 1, 0);
+        }
+      }
+    }
   } else {
     const int levbegin = (fine_leve_solve_only) ? nlevels-1 : 0;
     for (int ilev = 0; ilev < levbegin; ++ilev) {
@@ -0,0 +1,193 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, std::string const& what)
+{
+    amrex::Print() << "  " << std::left << std::setw(60) << what
+                   << (ok ? "passed" : "FAILED") << "\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ok, what.c_str());
+}
+
+struct Params
+{
+    int n_cell = 64;
+    int max_grid_size = 32;
+    int ncomp = 20;
+    Real tol_rel = 1.e-10;
+    int verbose = 0;
+};
+
+// Implicit diffusion of ncomp species over a time step dt,
+//     (1 - dt del dot D_n rho grad) phi_n = rhs_n,
+// where the diffusivity D_n differs by species and rho = 1+x.
+void fill_coefs (MultiFab& acoef, Array<MultiFab,AMREX_SPACEDIM>& bcoef, Geometry const& geom)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    acoef.setVal(1.0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const Real xoff = (idim == 0) ? 0.0 : 0.5;
+        for (MFIter mfi(bcoef[idim]); mfi.isValid(); ++mfi) {
+            auto const& b = bcoef[idim].array(mfi);
+            const int ncomp = bcoef[idim].nComp();
+            amrex::LoopOnCpu(mfi.validbox(), ncomp, [&] (int i, int j, int k, int n) noexcept
+            {
+                const Real x = problo[0] + (i+xoff)*dx[0];
+                b(i,j,k,n) = (Real(1.0) + x) * (Real(1.0) + Real(0.5)*n);
+            });
+        }
+    }
+}
+
+// Species n is a sine wave with its own frequency and a magnitude that
+// drops by orders of magnitude with n.
+void fill_rhs (MultiFab& rhs, Geometry const& geom)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const Real twopi = 2.*M_PI;
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+        auto const& a = rhs.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), rhs.nComp(), [&] (int i, int j, int k, int n) noexcept
+        {
+            const Real f = twopi*(1+n%3);
+            a(i,j,k,n) = std::pow(Real(10.0), -Real(0.5)*n)
+                *        std::sin(f*(problo[0]+(i+0.5)*dx[0]))
+                *        std::sin(f*(problo[1]+(j+0.5)*dx[1]))
+                *        std::sin(f*(problo[2]+(k+0.5)*dx[2]));
+        });
+    }
+}
+
+std::unique_ptr<MLABecLaplacian>
+make_op (Geometry const& geom, BoxArray const& ba, DistributionMapping const& dm,
+         MultiFab const& acoef, Array<MultiFab,AMREX_SPACEDIM> const& bcoef,
+         int scomp, int ncomp)
+{
+    std::unique_ptr<MLABecLaplacian> op
+        (new MLABecLaplacian({geom}, {ba}, {dm}, LPInfo(), {}, ncomp));
+    op->setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                  LinOpBCType::Dirichlet,
+                                  LinOpBCType::Dirichlet)},
+                    {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                  LinOpBCType::Dirichlet,
+                                  LinOpBCType::Dirichlet)});
+    op->setLevelBC(0, nullptr);
+    const Real dt = 1.e-2;
+    op->setScalars(1.0, dt);
+    op->setACoeffs(0, acoef);
+    Array<MultiFab,AMREX_SPACEDIM> b;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        b[idim] = MultiFab(bcoef[idim], amrex::make_alias, scomp, ncomp);
+    }
+    op->setBCoeffs(0, amrex::GetArrOfConstPtrs(b));
+    return op;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Params p;
+        {
+            ParmParse pp;
+            pp.query("n_cell", p.n_cell);
+            pp.query("max_grid_size", p.max_grid_size);
+            pp.query("ncomp", p.ncomp);
+            pp.query("tol_rel", p.tol_rel);
+            pp.query("verbose", p.verbose);
+        }
+        const int ncomp = p.ncomp;
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Geometry geom(Box(IntVect(0), IntVect(p.n_cell-1)), rb, 0, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(geom.Domain());
+        ba.maxSize(p.max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab acoef(ba, dm, 1, 0);
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, ncomp, 0);
+        }
+        fill_coefs(acoef, bcoef, geom);
+
+        MultiFab rhs(ba, dm, ncomp, 0);
+        fill_rhs(rhs, geom);
+
+        // One solve per component
+        MultiFab sol_sep(ba, dm, ncomp, 1);
+        sol_sep.setVal(0.0);
+        int niters_sep = 0;
+        ParallelDescriptor::Barrier();
+        Real t_sep = amrex::second();
+        for (int n = 0; n < ncomp; ++n) {
+            auto op = make_op(geom, ba, dm, acoef, bcoef, n, 1);
+            MLMG mlmg(*op);
+            mlmg.setVerbose(p.verbose);
+            MultiFab s(sol_sep, amrex::make_alias, n, 1);
+            MultiFab r(rhs, amrex::make_alias, n, 1);
+            mlmg.solve({&s}, {&r}, p.tol_rel, 0.0);
+            niters_sep += mlmg.getNumIters();
+        }
+        t_sep = amrex::second() - t_sep;
+        ParallelDescriptor::ReduceRealMax(t_sep);
+
+        // All components together
+        MultiFab sol_blk(ba, dm, ncomp, 1);
+        sol_blk.setVal(0.0);
+        ParallelDescriptor::Barrier();
+        Real t_blk = amrex::second();
+        int niters_blk;
+        {
+            auto op = make_op(geom, ba, dm, acoef, bcoef, 0, ncomp);
+            MLMG mlmg(*op);
+            mlmg.setVerbose(p.verbose);
+            mlmg.setConvergencePerComp(1);
+            mlmg.solve({&sol_blk}, {&rhs}, p.tol_rel, 0.0);
+            niters_blk = mlmg.getNumIters();
+        }
+        t_blk = amrex::second() - t_blk;
+        ParallelDescriptor::ReduceRealMax(t_blk);
+
+        amrex::Print() << "Checking the block solve against one solve per component\n";
+        Real maxdiff = 0.0;
+        for (int n = 0; n < ncomp; ++n) {
+            MultiFab d(ba, dm, 1, 0);
+            MultiFab::Copy(d, sol_blk, n, 0, 1, 0);
+            MultiFab::Subtract(d, sol_sep, n, 0, 1, 0);
+            maxdiff = std::max(maxdiff, d.norm0() / sol_sep.norm0(n));
+        }
+        check(maxdiff < 1.e3*p.tol_rel, "each component converged to its own tolerance");
+
+        amrex::Print() << "\n" << p.n_cell << "^" << AMREX_SPACEDIM << " cells, "
+                       << ncomp << " components\n"
+                       << "  " << std::left << std::setw(24) << "" << std::right
+                       << std::setw(12) << "iters" << std::setw(12) << "seconds" << "\n"
+                       << "  " << std::left << std::setw(24) << "one solve per component"
+                       << std::right << std::setw(12) << niters_sep
+                       << std::fixed << std::setprecision(3) << std::setw(12) << t_sep
+                       << std::defaultfloat << "\n"
+                       << "  " << std::left << std::setw(24) << "block solve"
+                       << std::right << std::setw(12) << niters_blk
+                       << std::fixed << std::setprecision(3) << std::setw(12) << t_blk
+                       << std::defaultfloat << "\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,282 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLSolutionHistory.H>
+
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, std::string const& what)
+{
+    amrex::Print() << "  " << std::left << std::setw(60) << what
+                   << (ok ? "passed" : "FAILED") << "\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ok, what.c_str());
+}
+
+struct Params
+{
+    int n_cell = 64;
+    int max_grid_size = 32;
+    int nsteps = 20;
+    Real dt = 0.02;
+    int history = 4;
+    Real tol_rel = 1.e-10;
+    int verbose = 0;
+};
+
+// Two Gaussian sources moving on circles
+void fill_rhs (MultiFab& rhs, Geometry const& geom, Real t)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const Real twopi = 2.*M_PI;
+    const Real c[2][3] = {{0.5+0.25*std::cos(twopi*t), 0.5+0.25*std::sin(twopi*t), 0.4},
+                          {0.5-0.2*std::sin(twopi*t), 0.5, 0.6+0.2*std::cos(twopi*t)}};
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+        auto const& a = rhs.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            const Real x[3] = {problo[0]+(i+Real(0.5))*dx[0],
+                               problo[1]+(j+Real(0.5))*dx[1],
+                               problo[2]+(k+Real(0.5))*dx[2]};
+            a(i,j,k) = 0.0;
+            for (auto const& b : c) {
+                const Real d2 = (x[0]-b[0])*(x[0]-b[0]) + (x[1]-b[1])*(x[1]-b[1])
+                    + (x[2]-b[2])*(x[2]-b[2]);
+                a(i,j,k) += 100.*std::exp(-d2/0.01);
+            }
+        });
+    }
+}
+
+// Dirichlet data on the domain boundary, changing in time
+void fill_bc (MultiFab& phi, Geometry const& geom, Real t)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(phi); mfi.isValid(); ++mfi) {
+        auto const& a = phi.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k) noexcept
+        {
+            const Real x = problo[0]+(i+Real(0.5))*dx[0];
+            const Real y = problo[1]+(j+Real(0.5))*dx[1];
+            const Real z = problo[2]+(k+Real(0.5))*dx[2];
+            a(i,j,k) = std::sin(2.*M_PI*t)*(x-y) + z;
+        });
+    }
+}
+
+enum struct Guess { zero, previous, history, history_single };
+
+std::string name (Guess g)
+{
+    switch (g) {
+    case Guess::zero:     return "zero";
+    case Guess::previous: return "previous solution";
+    case Guess::history:  return "history";
+    default:              return "history, single";
+    }
+}
+
+struct Problem
+{
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+};
+
+std::unique_ptr<MLABecLaplacian> make_op (Problem& prob)
+{
+    std::unique_ptr<MLABecLaplacian> op(new MLABecLaplacian({prob.geom}, {prob.ba}, {prob.dm}));
+    op->setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,LinOpBCType::Dirichlet,LinOpBCType::Dirichlet)},
+                    {AMREX_D_DECL(LinOpBCType::Dirichlet,LinOpBCType::Dirichlet,LinOpBCType::Dirichlet)});
+    op->setScalars(1.0, 1.0);
+    op->setACoeffs(0, 1.0);
+    op->setBCoeffs(0, amrex::GetArrOfConstPtrs(prob.bcoef));
+    return op;
+}
+
+struct Result
+{
+    int niters = 0;
+    Real time = 0.;
+};
+
+Result run (Problem& prob, Params const& p, Guess guess)
+{
+    std::unique_ptr<MLABecLaplacian> op = make_op(prob);
+    MLMG mlmg(*op);
+    mlmg.setVerbose(p.verbose);
+    mlmg.setMaxIter(200);
+
+    std::unique_ptr<MLSolutionHistory> hist;
+    if (guess == Guess::history || guess == Guess::history_single) {
+        hist.reset(new MLSolutionHistory(mlmg, p.history,
+                                         (guess == Guess::history)
+                                         ? MLSolutionHistory::Precision::Full
+                                         : MLSolutionHistory::Precision::Single));
+        hist->setVerbose(p.verbose);
+    }
+
+    MultiFab sol(prob.ba, prob.dm, 1, 1);
+    MultiFab bcdata(prob.ba, prob.dm, 1, 1);
+    MultiFab rhs(prob.ba, prob.dm, 1, 0);
+    sol.setVal(0.0);
+
+    // MLMG's relative tolerance is relative to the larger of the rhs and
+    // the initial residual, which depends on the initial guess.  All but
+    // the first solve use the same absolute tolerance instead.
+    Real tol_rel = p.tol_rel;
+    Real tol_abs = 0.0;
+
+    Result r;
+    for (int step = 0; step < p.nsteps; ++step)
+    {
+        const Real t = step*p.dt;
+        fill_rhs(rhs, prob.geom, t);
+        fill_bc(bcdata, prob.geom, t);
+        op->setLevelBC(0, &bcdata);
+
+        const Real t0 = amrex::second();
+        if (guess == Guess::zero) {
+            sol.setVal(0.0);
+        }
+        if (hist) {
+            hist->solve({&sol}, {&rhs}, tol_rel, tol_abs);
+        } else {
+            mlmg.solve({&sol}, {&rhs}, tol_rel, tol_abs);
+        }
+        Real dt = amrex::second() - t0;
+        ParallelDescriptor::ReduceRealMax(dt);
+
+        // The first solve starts from zero in all cases.
+        if (step == 0) {
+            tol_abs = p.tol_rel * std::max(mlmg.getInitRHS(), mlmg.getInitResidual());
+            tol_rel = 0.0;
+        } else {
+            r.niters += mlmg.getNumIters();
+            r.time += dt;
+        }
+    }
+    return r;
+}
+
+// The residual of the guess predicted by the history against the actual one
+void check_guess (Problem& prob, Params const& p, MLSolutionHistory::Precision prec)
+{
+    std::unique_ptr<MLABecLaplacian> op = make_op(prob);
+    MLMG mlmg(*op);
+    mlmg.setVerbose(0);
+    MLSolutionHistory hist(mlmg, 3, prec);
+
+    MultiFab sol(prob.ba, prob.dm, 1, 1);
+    MultiFab bcdata(prob.ba, prob.dm, 1, 1);
+    MultiFab rhs(prob.ba, prob.dm, 1, 0);
+    MultiFab res(prob.ba, prob.dm, 1, 0);
+    MultiFab zero(prob.ba, prob.dm, 1, 1);
+    zero.setVal(0.0);
+
+    Real maxerr = 0.0, maxratio = 0.0;
+    for (int step = 0; step < 6; ++step)
+    {
+        const Real t = step*p.dt;
+        fill_rhs(rhs, prob.geom, t);
+        fill_bc(bcdata, prob.geom, t);
+        op->setLevelBC(0, &bcdata);
+
+        sol.setVal(0.0);
+        const int nmodes = hist.makeInitialGuess({&sol}, {&rhs});
+        if (nmodes > 0) {
+            mlmg.compResidual({&res}, {&zero}, {&rhs});
+            const Real r0 = res.norm2();
+            mlmg.compResidual({&res}, {&sol}, {&rhs});
+            const Real ratio = res.norm2()/r0;
+            maxerr = std::max(maxerr, std::abs(ratio-hist.getGuessResidualRatio()));
+            maxratio = std::max(maxratio, ratio);
+        }
+        mlmg.solve({&sol}, {&rhs}, p.tol_rel, 0.0);
+        hist.add({&sol}, {&rhs});
+    }
+
+    const std::string what = (prec == MLSolutionHistory::Precision::Full) ? "" : ", single";
+    check(maxratio < 0.5, "guess better than a zero guess" + what);
+    check(maxerr < ((prec == MLSolutionHistory::Precision::Full) ? 1.e-6 : 1.e-3),
+          "predicted residual of the guess" + what);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Params p;
+        {
+            ParmParse pp;
+            pp.query("n_cell", p.n_cell);
+            pp.query("max_grid_size", p.max_grid_size);
+            pp.query("nsteps", p.nsteps);
+            pp.query("dt", p.dt);
+            pp.query("history", p.history);
+            pp.query("tol_rel", p.tol_rel);
+            pp.query("verbose", p.verbose);
+        }
+
+        Problem prob;
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        prob.geom.define(Box(IntVect(0), IntVect(p.n_cell-1)), rb, 0, {AMREX_D_DECL(0,0,0)});
+        prob.ba = BoxArray(prob.geom.Domain());
+        prob.ba.maxSize(p.max_grid_size);
+        prob.dm.define(prob.ba);
+        {
+            MultiFab ccoef(prob.ba, prob.dm, 1, 1);
+            const auto problo = prob.geom.ProbLoArray();
+            const auto dx = prob.geom.CellSizeArray();
+            for (MFIter mfi(ccoef); mfi.isValid(); ++mfi) {
+                auto const& a = ccoef.array(mfi);
+                amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k) noexcept
+                {
+                    const Real x = problo[0]+(i+Real(0.5))*dx[0];
+                    const Real y = problo[1]+(j+Real(0.5))*dx[1];
+                    a(i,j,k) = 1.0 + 0.5*std::sin(2.*M_PI*x)*std::sin(2.*M_PI*y);
+                });
+            }
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                prob.bcoef[idim].define(amrex::convert(prob.ba, IntVect::TheDimensionVector(idim)),
+                                        prob.dm, 1, 0);
+            }
+            amrex::average_cellcenter_to_face(GetArrOfPtrs(prob.bcoef), ccoef, prob.geom);
+        }
+
+        amrex::Print() << "Checking the initial guess of MLSolutionHistory\n";
+        check_guess(prob, p, MLSolutionHistory::Precision::Full);
+        check_guess(prob, p, MLSolutionHistory::Precision::Single);
+
+        amrex::Print() << "\n" << p.n_cell << "^3 cells, " << p.nsteps-1
+                       << " solves after the first, history of " << p.history << "\n"
+                       << "  " << std::left << std::setw(24) << "initial guess"
+                       << std::right << std::setw(8) << "iters" << std::setw(12) << "seconds"
+                       << std::setw(16) << "seconds/solve" << "\n";
+        for (Guess g : {Guess::zero, Guess::previous, Guess::history, Guess::history_single}) {
+            const Result r = run(prob, p, g);
+            const int nsolves = std::max(p.nsteps-1, 1);
+            amrex::Print() << "  " << std::left << std::setw(24) << name(g)
+                           << std::right << std::setw(8) << r.niters
+                           << std::fixed << std::setprecision(3)
+                           << std::setw(12) << r.time
+                           << std::setw(16) << r.time/nsolves << std::defaultfloat << "\n";
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,143 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabExpr.H>
+
+using namespace amrex;
+
+namespace {
+
+void init (MultiFab& mf, Real a)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.fabbox();
+        auto const& fab = mf.array(mfi);
+        amrex::ParallelFor(bx, mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            fab(i,j,k,n) = std::sin(a*i + 0.3*j + 0.7*k + n);
+        });
+    }
+}
+
+Real max_diff (MultiFab const& a, MultiFab const& b, int nghost)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), nghost);
+    MultiFab::LinComb(d, 1.0, a, 0, -1.0, b, 0, 0, a.nComp(), nghost);
+    return d.norm0(0, nghost);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 128;
+        int max_grid_size = 64;
+        int nghost = 1;
+        int nsteps = 20;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nghost", nghost);
+            pp.query("nsteps", nsteps);
+        }
+
+        BoxArray ba(Box(IntVect(0),IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        const int ncomp = 2;
+
+        MultiFab x(ba,dm,ncomp,nghost), y(ba,dm,ncomp,nghost), w(ba,dm,ncomp,nghost);
+        MultiFab z(ba,dm,ncomp,nghost), zref(ba,dm,ncomp,nghost);
+        init(x, 0.1);
+        init(y, 0.2);
+        init(w, 0.3);
+
+        // Linear combination, including ghost cells
+        z.setVal(0.0);
+        zref.setVal(0.0);
+        amrex::eval(z, 2.0*x + 3.0*y - 0.5*w, nghost);
+        MultiFab::LinComb(zref, 2.0, x, 0, 3.0, y, 0, 0, ncomp, nghost);
+        MultiFab::Saxpy(zref, -0.5, w, 0, 0, ncomp, nghost);
+        Real err = max_diff(z, zref, nghost);
+        amrex::Print() << "eval(z, 2*x + 3*y - 0.5*w): max error " << err << "\n";
+        AMREX_ALWAYS_ASSERT(err < 1.e-14);
+
+        // Fused assignments and reductions.  Reductions are over valid cells.
+        {
+            MultiFab s(ba,dm,ncomp,nghost);
+            const Real alpha = 0.7;
+            auto r = amrex::eval(nghost, Expr::assign(s, x - alpha*y),
+                                         Expr::norm_inf(s),
+                                         Expr::dot(s, w),
+                                         Expr::sum(-s/2.0));
+            MultiFab::LinComb(zref, 1.0, x, 0, -alpha, y, 0, 0, ncomp, nghost);
+            Real norm = std::max(zref.norm0(0,0), zref.norm0(1,0));
+            Real dot = MultiFab::Dot(zref, 0, w, 0, ncomp, 0);
+            Real sum = -0.5*(zref.sum(0) + zref.sum(1));
+            amrex::Print() << "fused eval: errors of s " << max_diff(s, zref, nghost)
+                           << ", norm_inf " << std::abs(r[1]-norm)
+                           << ", dot " << std::abs(r[2]-dot)
+                           << ", sum " << std::abs(r[3]-sum) << "\n";
+            AMREX_ALWAYS_ASSERT(r[0] == 0.0);
+            AMREX_ALWAYS_ASSERT(max_diff(s, zref, nghost) < 1.e-14);
+            AMREX_ALWAYS_ASSERT(std::abs(r[1]-norm) < 1.e-14);
+            AMREX_ALWAYS_ASSERT(std::abs(r[2]-dot) < 1.e-9*std::abs(dot));
+            AMREX_ALWAYS_ASSERT(std::abs(r[3]-sum) < 1.e-9*std::abs(sum));
+        }
+
+        // Bandwidth benchmark with the updates of a BiCGStab half iteration:
+        //   sol += alpha*ph;  s = r - alpha*v;  sh = s;  rnorm = |s|_inf
+        {
+            MultiFab sol(ba,dm,1,0), ph(ba,dm,1,0), r(ba,dm,1,0), v(ba,dm,1,0);
+            MultiFab s(ba,dm,1,0), sh(ba,dm,1,0);
+            init(sol, 0.1);
+            init(ph, 0.2);
+            init(r, 0.3);
+            init(v, 0.4);
+            const Real alpha = 1.e-3;
+            const Real npts = ba.d_numPts();
+
+            Real rnorm_unfused = 0.0;
+            Real t0 = amrex::second();
+            for (int istep = 0; istep < nsteps; ++istep) {
+                MultiFab::Saxpy(sol, alpha, ph, 0, 0, 1, 0);
+                MultiFab::LinComb(s, 1.0, r, 0, -alpha, v, 0, 0, 1, 0);
+                rnorm_unfused = s.norm0(0, 0);
+                MultiFab::Copy(sh, s, 0, 0, 1, 0);
+            }
+            Real t1 = amrex::second();
+
+            init(sol, 0.1);
+            Real rnorm_fused = 0.0;
+            Real t2 = amrex::second();
+            for (int istep = 0; istep < nsteps; ++istep) {
+                auto rv = amrex::eval(0, Expr::assign(sol, sol + alpha*ph),
+                                         Expr::assign(s, r - alpha*v),
+                                         Expr::assign(sh, s),
+                                         Expr::norm_inf(s));
+                rnorm_fused = rv[3];
+            }
+            Real t3 = amrex::second();
+
+            ParallelDescriptor::ReduceRealMax(t1);
+            ParallelDescriptor::ReduceRealMax(t3);
+
+            // Bytes that must be moved: read sol, ph, r and v, and write sol, s and sh.
+            const Real bytes = 7.0*sizeof(Real)*npts*nsteps;
+            amrex::Print() << "BiCGStab update, " << n_cell << "^3 cells, " << nsteps << " steps\n"
+                           << "  unfused: " << (t1-t0) << " s, "
+                           << bytes/(t1-t0)*1.e-9 << " GB/s effective\n"
+                           << "  fused:   " << (t3-t2) << " s, "
+                           << bytes/(t3-t2)*1.e-9 << " GB/s effective\n"
+                           << "  speedup: " << (t1-t0)/(t3-t2) << "\n";
+            AMREX_ALWAYS_ASSERT(std::abs(rnorm_fused-rnorm_unfused) < 1.e-12);
+            AMREX_ALWAYS_ASSERT(max_diff(s, sh, 0) == 0.0);
+        }
+    }
+    amrex::Finalize();
+}
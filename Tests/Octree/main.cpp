@@ -0,0 +1,324 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_AmrCore.H>
+#include <AMReX_Octree.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_PhysBCFunct.H>
+#include <AMReX_Utility.H>
+
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <set>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, std::string const& what)
+{
+    amrex::Print() << "  " << std::left << std::setw(60) << what
+                   << (ok ? "passed" : "FAILED") << "\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ok, what.c_str());
+}
+
+// Refines a thin spherical shell.  There is no data to carry around.
+class ShellCore
+    : public AmrCore
+{
+public:
+    ShellCore (Geometry const& geom, AmrInfo const& info)
+        : AmrCore(geom, info) {}
+
+    Real radius = 0.25;
+
+    void ErrorEst (int lev, TagBoxArray& tags, Real /*time*/, int /*ngrow*/) override
+    {
+        const auto problo = Geom(lev).ProbLoArray();
+        const auto dx = Geom(lev).CellSizeArray();
+        const Real r = radius;
+        const Real w = Real(1.5)*dx[0];
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+            auto const& a = tags.array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [=] (int i, int j, int k) noexcept
+            {
+                amrex::ignore_unused(j,k);
+                AMREX_D_TERM(const Real x = problo[0]+(i+Real(0.5))*dx[0]-Real(0.5);,
+                             const Real y = problo[1]+(j+Real(0.5))*dx[1]-Real(0.5);,
+                             const Real z = problo[2]+(k+Real(0.5))*dx[2]-Real(0.5);)
+                const Real d = std::sqrt(AMREX_D_TERM(x*x,+y*y,+z*z));
+                if (std::abs(d-r) <= w) {
+                    a(i,j,k) = TagBox::SET;
+                }
+            });
+        }
+    }
+
+    void MakeNewLevelFromScratch (int, Real, const BoxArray&, const DistributionMapping&) override {}
+    void MakeNewLevelFromCoarse (int, Real, const BoxArray&, const DistributionMapping&) override {}
+    void RemakeLevel (int, Real, const BoxArray&, const DistributionMapping&) override {}
+    void ClearLevel (int) override {}
+
+    Long numBlocks () const {
+        Long n = 0;
+        for (int lev = 0; lev <= finest_level; ++lev) {
+            n += grids[lev].size();
+        }
+        return n;
+    }
+};
+
+AmrInfo make_info (int max_level, int block_size, bool octree)
+{
+    AmrInfo info;
+    info.max_level = max_level;
+    info.ref_ratio = Vector<IntVect>(max_level+1, IntVect(2));
+    info.max_grid_size = Vector<IntVect>(max_level+1, IntVect(block_size));
+    info.n_error_buf = Vector<IntVect>(max_level+1, IntVect(1));
+    info.use_octree = octree;
+    if (octree) {
+        info.blocking_factor = Vector<IntVect>(max_level+1, IntVect(block_size));
+    } else {
+        // Octree-like grids from the general algorithm
+        info.blocking_factor = Vector<IntVect>(max_level+1, IntVect(2*block_size));
+        info.grid_eff = 1.0;
+    }
+    return info;
+}
+
+Geometry make_geom (int n_cell)
+{
+    RealBox rb(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.));
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,1,0)};
+    return Geometry(Box(IntVect(0), IntVect(n_cell-1)), rb, 0, is_per);
+}
+
+void check_tree (ShellCore const& amr)
+{
+    const Octree tree = amr.MakeOctree();
+    const int finest = amr.finestLevel();
+    check(finest == amr.maxLevel() && tree.numLevels() == finest+1, "all levels refined");
+
+    bool parents = true, balanced = true, neighbors = true, faces = true, dms = true;
+    for (int lev = 0; lev <= finest; ++lev)
+    {
+        const BoxArray& ba = amr.boxArray(lev);
+        const Geometry& geom = amr.Geom(lev);
+        const Box& bdomain = tree.blockDomain(lev);
+        const std::vector<IntVect> pshifts = geom.periodicity().shiftIntVect();
+
+        for (int i = 0; i < tree.numBlocks(lev); ++i)
+        {
+            const IntVect& c = tree.blockCoord(lev,i);
+
+            if (lev > 0) {
+                const int p = tree.parent(lev,i);
+                const IntVect m = c - 2*tree.blockCoord(lev-1,p);
+                parents = parents && p >= 0
+                    && tree.child(lev-1, p, AMREX_D_TERM(m[0],+2*m[1],+4*m[2])) == i;
+            }
+
+            std::set<int> from_table;
+            for (int k = AMREX_D_PICK(0,0,-1); k <= AMREX_D_PICK(0,0,1); ++k) {
+            for (int j = AMREX_D_PICK(0,-1,-1); j <= AMREX_D_PICK(0,1,1); ++j) {
+            for (int ii = -1; ii <= 1; ++ii) {
+                const IntVect off(AMREX_D_DECL(ii,j,k));
+                if (off == IntVect::TheZeroVector()) continue;
+                const int nb = tree.neighbor(lev,i,off);
+                if (nb >= 0) {
+                    from_table.insert(nb);
+                } else if (lev > 0) {
+                    // Inside the domain, there must be a coarser block next to it.
+                    bool inside = true;
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        const int n = c[idim] + off[idim];
+                        inside = inside && (geom.isPeriodic(idim) || (n >= bdomain.smallEnd(idim)
+                                                                      && n <= bdomain.bigEnd(idim)));
+                    }
+                    balanced = balanced && (!inside || tree.coarseNeighbor(lev,i,off) >= 0);
+                }
+            }}}
+
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                for (int side = 0; side < 2; ++side) {
+                    faces = faces && tree.faceNeighbor(lev,i,idim,side)
+                        == tree.neighbor(lev,i,(2*side-1)*IntVect::TheDimensionVector(idim));
+                }
+            }
+
+            std::set<int> from_search;
+            for (const auto& iv : pshifts) {
+                for (const auto& is : ba.intersections(amrex::grow(ba[i],1)+iv)) {
+                    if (is.first != i || iv != IntVect::TheZeroVector()) {
+                        from_search.insert(is.first);
+                    }
+                }
+            }
+            neighbors = neighbors && from_table == from_search;
+        }
+
+        const DistributionMapping& dm = amr.DistributionMap(lev);
+        for (int i = 1; i < dm.size(); ++i) {
+            dms = dms && dm[i] >= dm[i-1];
+        }
+    }
+    check(parents, "parents and children");
+    check(faces, "face neighbor table");
+    check(neighbors, "neighbors agree with BoxArray intersections");
+    check(balanced, "2:1 balance");
+    check(dms, "contiguous distribution");
+}
+
+// Sets the valid cells to a function of their index and the ghost cells to -1.
+void init_data (MultiFab& mf)
+{
+    mf.setVal(-1.0);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [=] (int i, int j, int k) noexcept
+        {
+            a(i,j,k) = i + 1000.*(j + 1000.*k);
+        });
+    }
+}
+
+bool same_data (MultiFab const& a, MultiFab const& b)
+{
+    int ok = 1;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        if (std::memcmp(a[mfi].dataPtr(), b[mfi].dataPtr(), a[mfi].nBytes()) != 0) ok = 0;
+    }
+    ParallelDescriptor::ReduceIntMin(ok);
+    return ok;
+}
+
+// FillBoundary and FillPatchTwoLevels must give the same results with the
+// neighbor tables of the octree grids as with the search of the BoxArray.
+void check_metadata (ShellCore const& amr)
+{
+    bool tables = true, fb = true, fp = true;
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev)
+    {
+        const BoxArray& ba = amr.boxArray(lev);
+        const BoxArray ba_search(ba.boxList()); // the same boxes without the table
+        const DistributionMapping& dm = amr.DistributionMap(lev);
+        const Geometry& geom = amr.Geom(lev);
+        tables = tables && ba.hasNeighbors(IntVect(7)) && !ba.hasNeighbors(IntVect(8))
+            && !ba_search.hasNeighbors(IntVect(0));
+
+        for (const IndexType& typ : {IndexType::TheCellType(), IndexType::TheNodeType()}) {
+            for (int ng : {1, 3}) {
+                MultiFab a(amrex::convert(ba,typ), dm, 1, ng);
+                MultiFab b(amrex::convert(ba_search,typ), dm, 1, ng);
+                init_data(a);
+                init_data(b);
+                a.FillBoundary(geom.periodicity());
+                b.FillBoundary(geom.periodicity());
+                fb = fb && same_data(a, b);
+            }
+        }
+
+        if (lev > 0) {
+            const int ng = 2;
+            MultiFab crse(amr.boxArray(lev-1), amr.DistributionMap(lev-1), 1, 0);
+            init_data(crse);
+            PhysBCFunctNoOp bcf;
+            Vector<BCRec> bcs(1, BCRec(AMREX_D_DECL(BCType::int_dir,BCType::int_dir,BCType::foextrap),
+                                       AMREX_D_DECL(BCType::int_dir,BCType::int_dir,BCType::foextrap)));
+            Vector<MultiFab> dst, src;
+            dst.reserve(2);
+            src.reserve(2);
+            for (const BoxArray& fba : {ba, ba_search}) {
+                src.emplace_back(fba, dm, 1, 0);
+                dst.emplace_back(fba, dm, 1, ng);
+                init_data(src.back());
+                dst.back().setVal(-1.0);
+                amrex::FillPatchTwoLevels(dst.back(), IntVect(ng), 0.0, {&crse}, {0.0},
+                                          {&src.back()}, {0.0}, 0, 0, 1,
+                                          amr.Geom(lev-1), geom, bcf, 0, bcf, 0,
+                                          amr.refRatio(lev-1), &pc_interp, bcs, 0);
+            }
+            fp = fp && same_data(dst[0], dst[1]);
+        }
+    }
+    check(tables, "neighbor tables attached to the grids");
+    check(fb, "FillBoundary with neighbor tables");
+    check(fp, "FillPatchTwoLevels with neighbor tables");
+}
+
+// Seconds for InitFromScratch, per regrid, and for the first FillBoundary
+// of all levels, which builds the metadata
+Array<Real,3> timeit (ShellCore& amr, int nregrid)
+{
+    amr.radius = 0.25;
+    Real t0 = amrex::second();
+    amr.InitFromScratch(0.0);
+    Real t1 = amrex::second();
+    for (int step = 0; step < nregrid; ++step) {
+        amr.radius += 0.01;
+        amr.regrid(0, 0.0);
+    }
+    Real t2 = amrex::second();
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev) {
+        MultiFab mf(amr.boxArray(lev), amr.DistributionMap(lev), 1, 1);
+        mf.setVal(0.0);
+        mf.FillBoundary(amr.Geom(lev).periodicity());
+    }
+    Real t3 = amrex::second();
+    Array<Real,3> t{{t1-t0, (t2-t1)/nregrid, t3-t2}};
+    ParallelDescriptor::ReduceRealMax(t.data(), 3);
+    return t;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_level = 3;
+        int block_size = 8;
+        int nregrid = 5;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_level", max_level);
+            pp.query("block_size", block_size);
+            pp.query("nregrid", nregrid);
+        }
+
+        const Geometry geom = make_geom(n_cell);
+
+        amrex::Print() << "Checking the octree\n";
+        {
+            ShellCore amr(make_geom(32), make_info(2, 8, true));
+            amr.InitFromScratch(0.0);
+            check_tree(amr);
+            check_metadata(amr);
+            amr.radius = 0.3;
+            amr.regrid(0, 0.0);
+            check_tree(amr);
+            check_metadata(amr);
+        }
+
+        amrex::Print() << "\nGrid generation in seconds\n"
+                       << "  " << std::left << std::setw(20) << "mode" << std::right
+                       << std::setw(10) << "blocks" << std::setw(14) << "init"
+                       << std::setw(14) << "regrid" << std::setw(14) << "fillbndry" << "\n";
+        for (bool octree : {false, true}) {
+            ShellCore amr(geom, make_info(max_level, block_size, octree));
+            auto t = timeit(amr, nregrid);
+            amrex::Print() << "  " << std::left << std::setw(20)
+                           << (octree ? "octree" : "general") << std::right
+                           << std::setw(10) << amr.numBlocks()
+                           << std::scientific << std::setprecision(3)
+                           << std::setw(14) << t[0] << std::setw(14) << t[1]
+                           << std::setw(14) << t[2]
+                           << std::defaultfloat << "\n";
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,88 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ReduceQueue.H>
+
+using namespace amrex;
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int nvalues = 32;
+        int nsteps = 1000;
+        {
+            ParmParse pp;
+            pp.query("nvalues", nvalues);
+            pp.query("nsteps", nsteps);
+        }
+
+        const int myproc = ParallelDescriptor::MyProc();
+        const int nprocs = ParallelDescriptor::NProcs();
+
+        // Correctness of heterogeneous reductions
+        {
+            ReduceQueue rq;
+            auto rsum = rq.Sum(Real(myproc+1));
+            auto rmin = rq.Min(Real(myproc+1));
+            auto imax = rq.Max(myproc);
+            auto lsum = rq.Sum(Long(1) << 40);
+            auto fmin = rq.Min(float(-myproc));
+            rq.Flush();
+            auto isum = rq.Sum(1);
+            AMREX_ALWAYS_ASSERT(rq.numPending() == 1);
+            AMREX_ALWAYS_ASSERT(isum.get() == nprocs);
+            AMREX_ALWAYS_ASSERT(rq.numPending() == 0);
+            AMREX_ALWAYS_ASSERT(rsum.get() == Real(nprocs*(nprocs+1)/2));
+            AMREX_ALWAYS_ASSERT(rmin.get() == 1.0);
+            AMREX_ALWAYS_ASSERT(imax.get() == nprocs-1);
+            AMREX_ALWAYS_ASSERT(lsum.get() == (Long(1) << 40) * nprocs);
+            AMREX_ALWAYS_ASSERT(fmin.get() == float(1-nprocs));
+            amrex::Print() << "ReduceQueue results are correct\n";
+        }
+
+        // Latency of nvalues reductions per step, blocking vs. batched
+        Real check_blocking = 0.0, check_batched = 0.0;
+
+        ParallelDescriptor::Barrier();
+        Real t0 = ParallelDescriptor::second();
+        for (int istep = 0; istep < nsteps; ++istep) {
+            for (int i = 0; i < nvalues; ++i) {
+                Real x = myproc + i + istep;
+                if (i%2 == 0) {
+                    ParallelDescriptor::ReduceRealSum(x);
+                } else {
+                    ParallelDescriptor::ReduceRealMax(x);
+                }
+                check_blocking += x;
+            }
+        }
+        Real t1 = ParallelDescriptor::second();
+
+        ReduceQueue& rq = ReduceQueue::Global();
+        Vector<ReduceQueue::Future<Real> > f(nvalues);
+        ParallelDescriptor::Barrier();
+        Real t2 = ParallelDescriptor::second();
+        for (int istep = 0; istep < nsteps; ++istep) {
+            for (int i = 0; i < nvalues; ++i) {
+                Real x = myproc + i + istep;
+                f[i] = (i%2 == 0) ? rq.Sum(x) : rq.Max(x);
+            }
+            for (int i = 0; i < nvalues; ++i) {
+                check_batched += f[i].get();
+            }
+        }
+        Real t3 = ParallelDescriptor::second();
+
+        AMREX_ALWAYS_ASSERT(check_blocking == check_batched);
+
+        ParallelDescriptor::ReduceRealMax(t1);
+        ParallelDescriptor::ReduceRealMax(t3);
+        amrex::Print() << nsteps << " steps of " << nvalues << " reductions on "
+                       << nprocs << " processes\n"
+                       << "  blocking: " << (t1-t0)/nsteps*1.e6 << " us per step\n"
+                       << "  batched:  " << (t3-t2)/nsteps*1.e6 << " us per step\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,323 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabExpr.H>
+#include <AMReX_Reduce.H>
+#include <AMReX_ExactSum.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MLMG.H>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+using namespace amrex;
+
+namespace {
+
+// Values that span many orders of magnitude, and that only depend on the
+// cell, so that the sums are sensitive to the order of the additions.
+void init (MultiFab& mf, unsigned int seed)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        auto const& fab = mf.array(mfi);
+        amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+        {
+            unsigned int h = seed ^ (i*73856093u) ^ (j*19349663u) ^ (k*83492791u);
+            h = (h ^ (h >> 13)) * 0x5bd1e995u;
+            h ^= h >> 15;
+            const int e = static_cast<int>(h % 61) - 30;
+            fab(i,j,k) = std::sin(0.001*h) * std::ldexp(1.0, e);
+        });
+    }
+}
+
+void test_exact_sum ()
+{
+    {
+        ExactSum s;
+        s.add(1.e100);
+        s.add(1.0);
+        s.add(-1.e100);
+        AMREX_ALWAYS_ASSERT(s.value() == 1.0);
+    }
+    {
+        // 1 + 2^-53 + 2^-106 is closer to 1 + 2^-52 than to 1.
+        ExactSum s;
+        s.add(std::ldexp(1.0,-106));
+        s.add(std::ldexp(1.0,-53));
+        s.add(1.0);
+        AMREX_ALWAYS_ASSERT(s.value() == 1.0 + std::ldexp(1.0,-52));
+        s.add(-2.0);
+        AMREX_ALWAYS_ASSERT(s.value() == -1.0 + std::ldexp(1.0,-53));
+    }
+    {
+        ExactSum s;
+        s.add(DBL_MAX);
+        s.add(DBL_MAX);
+        s.add(-DBL_MAX);
+        AMREX_ALWAYS_ASSERT(s.value() == DBL_MAX);
+        for (int i = 0; i < 3000; ++i) {
+            s.add(DBL_MIN/4.0);
+        }
+        s.add(-DBL_MAX);
+        AMREX_ALWAYS_ASSERT(s.value() == 750.0*DBL_MIN);
+    }
+    {
+        ExactSum s, t;
+        for (int i = 0; i < 5000; ++i) {
+            s.add(0.1);
+            t.add(-0.1);
+        }
+        s.add(t);
+        AMREX_ALWAYS_ASSERT(s.value() == 0.0);
+        s.add(std::numeric_limits<double>::infinity());
+        AMREX_ALWAYS_ASSERT(s.value() == std::numeric_limits<double>::infinity());
+        s.add(-std::numeric_limits<double>::infinity());
+        AMREX_ALWAYS_ASSERT(std::isnan(s.value()));
+    }
+    amrex::Print() << "ExactSum results are correct\n";
+}
+
+using Results = std::array<Real,6>;
+
+Results compute (MultiFab const& x, MultiFab const& y)
+{
+    Results r;
+    r[0] = x.sum(0);
+    r[1] = MultiFab::Dot(x, 0, y, 0, 1, 0);
+    r[2] = x.norm1(0, 0);
+
+    ReduceOps<ReduceOpSum, ReduceOpMax> reduce_op;
+    ReduceData<Real, Real> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(x,true); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.tilebox();
+        auto const& xa = x.const_array(mfi);
+        auto const& ya = y.const_array(mfi);
+        reduce_op.eval(bx, reduce_data,
+        [=] (int i, int j, int k) -> ReduceTuple
+        {
+            return {xa(i,j,k)-ya(i,j,k), xa(i,j,k)};
+        });
+    }
+    r[3] = amrex::get<0>(reduce_data.value(ParallelContext::CommunicatorSub()));
+
+    r[4] = amrex::eval(0, Expr::dot(x-y, y))[0];
+
+    // A function of a Box, which sums its tile in its own order
+    ReduceOps<ReduceOpSum> reduce_op_box;
+    ReduceData<Real> reduce_data_box(reduce_op_box);
+    using ReduceTupleBox = typename decltype(reduce_data_box)::Type;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(x,true); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.tilebox();
+        auto const& xa = x.const_array(mfi);
+        auto const& ya = y.const_array(mfi);
+        reduce_op_box.eval(bx, reduce_data_box,
+        [=] (Box const& b) -> ReduceTupleBox
+        {
+            Real s = 0.0;
+            amrex::LoopOnCpu(b, [&] (int i, int j, int k) noexcept
+            {
+                s += xa(i,j,k)*ya(i,j,k);
+            });
+            return {s};
+        });
+    }
+    r[5] = amrex::get<0>(reduce_data_box.value(ParallelContext::CommunicatorSub()));
+    return r;
+}
+
+// Poisson solve with BiCGStab as the bottom solver, which reduces local
+// dot products in one call.  Agglomeration and consolidation are off so
+// that the grids do not depend on the number of processes.
+MultiFab solve (MultiFab const& rhs)
+{
+    const BoxArray& ba = rhs.boxArray();
+    const DistributionMapping& dm = rhs.DistributionMap();
+    Geometry geom(ba.minimalBox(), RealBox({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)}),
+                  0, {AMREX_D_DECL(0,0,0)});
+
+    LPInfo info;
+    info.setAgglomeration(false);
+    info.setConsolidation(false);
+    info.setMaxCoarseningLevel(2);
+    MLPoisson mlpoisson({geom}, {ba}, {dm}, info);
+    mlpoisson.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                        LinOpBCType::Dirichlet,
+                                        LinOpBCType::Dirichlet)},
+                          {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                        LinOpBCType::Dirichlet,
+                                        LinOpBCType::Dirichlet)});
+
+    MultiFab sol(ba, dm, 1, 1);
+    sol.setVal(0.0);
+    mlpoisson.setLevelBC(0, &sol);
+
+    MLMG mlmg(mlpoisson);
+    mlmg.setBottomSolver(MLMG::BottomSolver::bicgstab);
+    mlmg.setVerbose(0);
+    mlmg.setBottomVerbose(0);
+    mlmg.solve({&sol}, {&rhs}, 1.e-8, 0.0);
+    return sol;
+}
+
+std::string to_string (Results const& r)
+{
+    std::ostringstream os;
+    os << std::hexfloat;
+    for (auto v : r) os << " " << v;
+    return os.str();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 96;
+        int max_grid_size = 32;
+        int nsteps = 20;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nsteps", nsteps);
+        }
+
+        test_exact_sum();
+
+        const int nprocs = ParallelDescriptor::NProcs();
+        const int reproducible = system::reproducible_sum;
+        const IntVect tile_size = FabArrayBase::mfiter_tile_size;
+
+        BoxArray ba(Box(IntVect(0),IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+
+        // The boxes distributed over 1, 2 and 4 processes, and over the
+        // boxes of a different size.
+        Results ref;
+        bool first = true;
+        bool all_same = true;
+        for (int np : {1, 2, 4}) {
+            Vector<int> pmap(ba.size());
+            for (int i = 0; i < ba.size(); ++i) {
+                pmap[i] = i % std::min(np,nprocs);
+            }
+            DistributionMapping dm(pmap);
+            MultiFab x(ba,dm,1,0), y(ba,dm,1,0);
+            init(x, 1);
+            init(y, 2);
+
+            for (int nthreads : {1, 2, 4}) {
+#ifdef _OPENMP
+                omp_set_num_threads(nthreads);
+#endif
+                for (IntVect ts : {IntVect(1024000), IntVect(AMREX_D_DECL(1024000,8,8)),
+                                   IntVect(AMREX_D_DECL(8,4,4))}) {
+                    FabArrayBase::mfiter_tile_size = ts;
+                    Results r = compute(x, y);
+                    amrex::Print() << std::min(np,nprocs) << " procs, "
+                                   << nthreads << " threads, tile " << ts << ":" << to_string(r) << "\n";
+                    if (first) {
+                        ref = r;
+                        first = false;
+                    } else {
+                        all_same = all_same && std::memcmp(&r, &ref, sizeof(Results)) == 0;
+                    }
+                }
+            }
+        }
+        FabArrayBase::mfiter_tile_size = tile_size;
+
+        // The solution of MLMG with the same boxes over 1, 2 and 4 processes
+        MultiFab sol_ref;
+        bool sol_same = true;
+        for (int np : {1, 2, 4}) {
+            Vector<int> pmap(ba.size());
+            for (int i = 0; i < ba.size(); ++i) {
+                pmap[i] = i % std::min(np,nprocs);
+            }
+            DistributionMapping dm(pmap);
+            MultiFab rhs(ba,dm,1,0);
+            init(rhs, 3);
+            MultiFab sol = solve(rhs);
+            if (sol_ref.empty()) {
+                sol_ref.define(ba, DistributionMapping(ba), 1, 0);
+            } else {
+                MultiFab tmp(ba, sol_ref.DistributionMap(), 1, 0);
+                tmp.ParallelCopy(sol);
+                for (MFIter mfi(tmp); mfi.isValid(); ++mfi) {
+                    sol_same = sol_same && std::memcmp(tmp[mfi].dataPtr(), sol_ref[mfi].dataPtr(),
+                                                       tmp[mfi].nBytes()) == 0;
+                }
+                ParallelDescriptor::ReduceBoolAnd(sol_same);
+                continue;
+            }
+            sol_ref.ParallelCopy(sol);
+        }
+
+        {
+            std::ostringstream os;
+            os << std::hexfloat << sol_ref.sum(0) << " " << sol_ref.norm2(0);
+            amrex::Print() << "MLMG solution sum and norm2: " << os.str() << "\n";
+        }
+
+        if (reproducible) {
+            AMREX_ALWAYS_ASSERT(all_same);
+            AMREX_ALWAYS_ASSERT(sol_same);
+            amrex::Print() << "The reproducible sums and MLMG solutions are bitwise identical\n";
+        } else {
+            amrex::Print() << "The native sums are " << (all_same ? "" : "not ")
+                           << "bitwise identical, and the MLMG solutions are "
+                           << (sol_same ? "" : "not ") << "bitwise identical\n";
+        }
+
+        // Accuracy and cost compared with the native sums
+        DistributionMapping dm(ba);
+        MultiFab x(ba,dm,1,0), y(ba,dm,1,0);
+        init(x, 1);
+        init(y, 2);
+
+        Real t[2], sum[2], dot[2];
+        for (int mode = 0; mode < 2; ++mode) {
+            system::reproducible_sum = mode;
+            sum[mode] = x.sum(0);
+            dot[mode] = MultiFab::Dot(x, 0, y, 0, 1, 0);
+            ParallelDescriptor::Barrier();
+            Real t0 = amrex::second();
+            for (int istep = 0; istep < nsteps; ++istep) {
+                sum[mode] = x.sum(0);
+                dot[mode] = MultiFab::Dot(x, 0, y, 0, 1, 0);
+            }
+            t[mode] = amrex::second() - t0;
+            ParallelDescriptor::ReduceRealMax(t[mode]);
+        }
+        system::reproducible_sum = reproducible;
+
+        amrex::Print() << std::setprecision(17)
+                       << "native       sum " << sum[0] << ", dot " << dot[0] << "\n"
+                       << "reproducible sum " << sum[1] << ", dot " << dot[1] << "\n"
+                       << "time of " << nsteps << " sums and dot products: native "
+                       << t[0] << " s, reproducible " << t[1] << " s, ratio "
+                       << t[1]/t[0] << "\n";
+        AMREX_ALWAYS_ASSERT(std::abs(sum[1]-sum[0]) <= 1.e-10*x.norm1(0,0));
+        AMREX_ALWAYS_ASSERT(std::abs(dot[1]-dot[0]) <= 1.e-10*std::abs(dot[1]));
+    }
+    amrex::Finalize();
+}
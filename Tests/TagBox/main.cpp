@@ -0,0 +1,260 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_TagBox.H>
+#include <AMReX_Utility.H>
+
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, std::string const& what)
+{
+    amrex::Print() << "  " << std::left << std::setw(60) << what
+                   << (ok ? "passed" : "FAILED") << "\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ok, what.c_str());
+}
+
+// Tags the valid cells inside a ball and a few random ones, with the
+// same tags for any number of processes.
+void make_tags (TagBoxArray& tags, int n_cell, Real radius)
+{
+    tags.setVal(TagBox::CLEAR);
+    for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+        auto const& a = tags.array(mfi);
+        const Box& bx = mfi.validbox();
+        std::mt19937 gen(mfi.index());
+        std::uniform_int_distribution<int> dist(0, 999);
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+        {
+            amrex::ignore_unused(j,k);
+            AMREX_D_TERM(const Real x = (i+Real(0.5))/n_cell-Real(0.5);,
+                         const Real y = (j+Real(0.5))/n_cell-Real(0.5);,
+                         const Real z = (k+Real(0.5))/n_cell-Real(0.5);)
+            const Real d = std::sqrt(AMREX_D_TERM(x*x,+y*y,+z*z));
+            if (d <= radius || dist(gen) == 0) {
+                a(i,j,k) = TagBox::SET;
+            }
+        });
+    }
+}
+
+// The scalar versions these are checked and timed against
+
+void buffer_ref (TagBox& tb, const IntVect& nbuf, const IntVect& nwid)
+{
+    Array4<char> const& d = tb.array();
+    const Box inside = amrex::grow(tb.box(), -nwid);
+    amrex::LoopOnCpu(inside, [&] (int i, int j, int k) noexcept
+    {
+        if (d(i,j,k) == TagBox::SET) {
+            for (int kk = -AMREX_D_PICK(0,0,nbuf[2]); kk <= AMREX_D_PICK(0,0,nbuf[2]); ++kk) {
+            for (int jj = -AMREX_D_PICK(0,nbuf[1],nbuf[1]); jj <= AMREX_D_PICK(0,nbuf[1],nbuf[1]); ++jj) {
+            for (int ii = -nbuf[0]; ii <= nbuf[0]; ++ii) {
+                if (d(i+ii,j+jj,k+kk) != TagBox::SET) d(i+ii,j+jj,k+kk) = TagBox::BUF;
+            }}}
+        }
+    });
+}
+
+void coarsen_ref (TagBoxArray& tags, const IntVect& ratio, TagBoxArray& ctags)
+{
+    for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+        AMREX_ALWAYS_ASSERT(ctags[mfi].box().contains(amrex::coarsen(mfi.fabbox(),ratio)));
+        auto const& f = tags.const_array(mfi);
+        auto const& c = ctags.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k) noexcept
+        {
+            amrex::ignore_unused(j,k);
+            IntVect civ = amrex::coarsen(IntVect(AMREX_D_DECL(i,j,k)), ratio);
+            char& ct = c(AMREX_D_DECL(civ[0],civ[1],civ[2]));
+            ct = ct || f(i,j,k);
+        });
+    }
+}
+
+void collate_ref (const TagBoxArray& tags, Vector<IntVect>& global)
+{
+    Vector<IntVect> local;
+    for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+        Long n = tags[mfi].numTags();
+        Long start = local.size();
+        local.resize(start+n);
+        tags[mfi].collate(local, start);
+    }
+    const int count = local.size();
+    const int root = ParallelDescriptor::IOProcessorNumber();
+    const std::vector<int> countvec = ParallelDescriptor::Gather(count, root);
+    std::vector<int> offset(countvec.size(), 0);
+    Long total = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        for (int i = 0, N = countvec.size(); i < N; ++i) {
+            offset[i] = total;
+            total += countvec[i];
+        }
+    }
+    global.resize(ParallelDescriptor::IOProcessor() ? total : 1);
+    ParallelDescriptor::Gatherv(local.data(), count, global.data(), countvec, offset, root);
+}
+
+bool same_tags (const TagBoxArray& a, const TagBoxArray& b)
+{
+    bool ok = true;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& x = a.const_array(mfi);
+        auto const& y = b.const_array(mfi);
+        amrex::LoopOnCpu(a[mfi].box(), [&] (int i, int j, int k) noexcept
+        {
+            ok = ok && x(i,j,k) == y(i,j,k);
+        });
+    }
+    ParallelDescriptor::ReduceBoolAnd(ok);
+    return ok;
+}
+
+template <class F>
+Real timeit (int nsteps, F&& f)
+{
+    Real t = 0.;
+    for (int step = 0; step < nsteps; ++step) {
+        t += f();
+    }
+    ParallelDescriptor::ReduceRealMax(t);
+    return t/nsteps*1.e3;
+}
+
+// Seconds spent in f after setup
+template <class S, class F>
+Real time_after (S&& setup, F&& f)
+{
+    setup();
+    ParallelDescriptor::Barrier();
+    Real t = amrex::second();
+    f();
+    return amrex::second() - t;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 128;
+        int max_grid_size = 32;
+        Real radius = 0.3;
+        int n_buf = 2;
+        int nsteps = 5;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("radius", radius);
+            pp.query("n_buf", n_buf);
+            pp.query("nsteps", nsteps);
+        }
+
+        BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        const IntVect nbuf(n_buf);
+        const IntVect ratio(2);
+
+        TagBoxArray tags(ba, dm, nbuf), ref(ba, dm, nbuf);
+
+        amrex::Print() << "Checking against the scalar versions\n";
+        {
+            make_tags(tags, n_cell, radius);
+            make_tags(ref, n_cell, radius);
+            tags.buffer(nbuf);
+            for (MFIter mfi(ref); mfi.isValid(); ++mfi) {
+                buffer_ref(ref[mfi], nbuf, nbuf);
+            }
+            check(same_tags(tags, ref), "buffer");
+
+            // Rows of more than one word of the bit mask, and a different
+            // buffer width in each direction
+            BoxArray ba2(ba.minimalBox());
+            ba2.maxSize(IntVect(AMREX_D_DECL(100,40,24)));
+            DistributionMapping dm2(ba2);
+            const IntVect nbuf2(AMREX_D_DECL(3,1,2));
+            TagBoxArray tags2(ba2, dm2, nbuf2), ref2(ba2, dm2, nbuf2);
+            make_tags(tags2, n_cell, radius);
+            make_tags(ref2, n_cell, radius);
+            tags2.buffer(nbuf2);
+            for (MFIter mfi(ref2); mfi.isValid(); ++mfi) {
+                buffer_ref(ref2[mfi], nbuf2, nbuf2);
+            }
+            check(same_tags(tags2, ref2), "buffer with long rows");
+
+            TagBoxArray cref(amrex::coarsen(ba,ratio), dm, IntVect(1));
+            cref.setVal(TagBox::CLEAR);
+            coarsen_ref(ref, ratio, cref);
+            tags.coarsen(ratio);
+            check(same_tags(tags, cref), "coarsen");
+
+            Vector<IntVect> tv, rv;
+            tags.collate(tv);
+            collate_ref(cref, rv);
+            check(tv == rv, "collate");
+        }
+
+        amrex::Print() << "\n" << ba.size() << " boxes of " << max_grid_size << "^"
+                       << AMREX_SPACEDIM << " cells, "
+                       << std::fixed << std::setprecision(1)
+                       << 100.*tags.numTags()/amrex::coarsen(ba,ratio).numPts()
+                       << std::defaultfloat << "% tagged after coarsening\n"
+                       << "  " << std::left << std::setw(24) << "milliseconds per call"
+                       << std::right << std::setw(14) << "scalar"
+                       << std::setw(14) << "new" << std::setw(10) << "speedup" << "\n";
+
+        // tags has been coarsened above
+        tags = TagBoxArray(ba, dm, nbuf);
+        auto reset = [&] () { make_tags(tags, n_cell, radius); };
+        Real t[3][2];
+        t[0][0] = timeit(nsteps, [&] () {
+            return time_after(reset, [&] () {
+                for (MFIter mfi(tags); mfi.isValid(); ++mfi) buffer_ref(tags[mfi], nbuf, nbuf);
+            });
+        });
+        t[0][1] = timeit(nsteps, [&] () {
+            return time_after(reset, [&] () { tags.buffer(nbuf); });
+        });
+
+        TagBoxArray ctags(amrex::coarsen(ba,ratio), dm, IntVect(1));
+        t[1][0] = timeit(nsteps, [&] () {
+            return time_after([&] () { reset(); tags.buffer(nbuf); ctags.setVal(TagBox::CLEAR); },
+                              [&] () { coarsen_ref(tags, ratio, ctags); });
+        });
+        t[1][1] = timeit(nsteps, [&] () {
+            return time_after([&] () {
+                    tags = TagBoxArray(ba, dm, nbuf);
+                    reset();
+                    tags.buffer(nbuf);
+                }, [&] () { tags.coarsen(ratio); });
+        });
+
+        Vector<IntVect> tv;
+        t[2][0] = timeit(nsteps, [&] () {
+            return time_after([] () {}, [&] () { collate_ref(ctags, tv); });
+        });
+        t[2][1] = timeit(nsteps, [&] () {
+            return time_after([] () {}, [&] () { ctags.collate(tv); });
+        });
+
+        const std::string names[] = {"buffer", "coarsen", "collate"};
+        for (int i = 0; i < 3; ++i) {
+            amrex::Print() << "  " << std::left << std::setw(24) << names[i] << std::right
+                           << std::fixed << std::setprecision(3)
+                           << std::setw(14) << t[i][0] << std::setw(14) << t[i][1]
+                           << std::setprecision(2) << std::setw(10) << t[i][0]/t[i][1]
+                           << std::defaultfloat << "\n";
+        }
+    }
+    amrex::Finalize();
+}
@@ -1,19 +1,27 @@
 
 #include <AMReX.H>
 #include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
 #include <AMReX_BoxList.H>
 #include <AMReX_BoxArray.H>
+#include <AMReX_Utility.H>
 #include <fstream>
+#include <iomanip>
+#include <random>
 
 using namespace amrex;
 
 void test ();
+void check_boxlist ();
+void benchmark ();
 BoxArray readBoxList (const std::string& file, Box& domain);
 
 int main(int argc, char* argv[])
 {
     amrex::Initialize(argc,argv);
     test();
+    check_boxlist();
+    benchmark();
     amrex::Finalize();
 }
 
@@ -26,7 +34,12 @@ void test ()
 
     for (int igrid=0; igrid < ngrids; ++igrid)
     {
-        grids[igrid] = readBoxList("grids/grids_"+std::to_string(igrid+1), domains[igrid]);
+        const std::string file = "grids/grids_"+std::to_string(igrid+1);
+        if (!std::ifstream(file).good()) {
+            amrex::Print() << "No grid files, skipping the complementIn test\n\n";
+            return;
+        }
+        grids[igrid] = readBoxList(file, domains[igrid]);
     }
 
     for (int igrid=0; igrid < ngrids; ++igrid)
@@ -55,3 +68,134 @@ readBoxList (const std::string& file, Box& domain)
 
     return retval;
 }
+
+namespace {
+
+void check (bool ok, std::string const& what)
+{
+    amrex::Print() << "  " << std::left << std::setw(60) << what
+                   << (ok ? "passed" : "FAILED") << "\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ok, what.c_str());
+}
+
+// Random fraction of the blocks of size bs in domain, with the same
+// random numbers on every process
+BoxList random_blocks (const Box& domain, int bs, Real fraction, unsigned seed)
+{
+    BoxList blocks(domain);
+    blocks.maxSize(bs);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<Real> dist(0., 1.);
+    BoxList bl;
+    for (const Box& b : blocks) {
+        if (dist(gen) < fraction) bl.push_back(b);
+    }
+    return bl;
+}
+
+Long num_pts (const BoxList& bl)
+{
+    Long n = 0;
+    for (const Box& b : bl) n += b.numPts();
+    return n;
+}
+
+}
+
+void check_boxlist ()
+{
+    const Box domain(IntVect(0), IntVect(63));
+
+    amrex::Print() << "Checking BoxList::simplify and BoxArray::removeOverlap\n";
+    {
+        BoxList orig = random_blocks(domain, 4, 0.7, 1);
+        BoxList bl = orig;
+        const int n = bl.simplify();
+        check(n > 0 && bl.size() + n == orig.size(), "number of merges");
+        check(BoxArray(bl).isDisjoint() && num_pts(bl) == num_pts(orig), "simplify keeps the cells");
+        bool ok = true;
+        BoxArray ba(bl);
+        for (const Box& b : orig) ok = ok && ba.contains(b);
+        check(ok, "simplify covers the original boxes");
+        check(bl.simplify(true) == 0, "no more boxes can be merged");
+
+        BoxList full(domain);
+        full.maxSize(4);
+        full.simplify(true);
+        check(full.size() == 1 && full.front() == domain, "blocks of the whole domain");
+
+        BoxList overlap;
+        overlap.push_back(Box(IntVect(0), IntVect(5)));
+        overlap.push_back(Box(IntVect(AMREX_D_DECL(3,0,0)), IntVect(AMREX_D_DECL(8,5,5))));
+        check(overlap.simplify(true) == 0 && overlap.size() == 2, "overlapping boxes are not merged");
+    }
+    {
+        BoxList orig = random_blocks(domain, 8, 0.5, 2);
+        orig.accrete(2);
+        BoxArray ba(orig);
+        ba.removeOverlap(false);
+        check(ba.isDisjoint(), "removeOverlap gives disjoint boxes");
+        const BoxArray oba(orig);
+        bool ok = true;
+        for (const Box& b : orig) ok = ok && ba.contains(b);
+        for (int i = 0; i < ba.size(); ++i) ok = ok && oba.contains(ba[i]);
+        check(ok, "removeOverlap keeps the cells");
+
+        BoxArray bas(orig);
+        bas.removeOverlap();
+        check(bas.numPts() == ba.numPts() && bas.size() <= ba.size(), "removeOverlap with simplify");
+
+        BoxList cbl;
+        cbl.complementIn(amrex::grow(domain,2), ba);
+        check(BoxArray(cbl).isDisjoint() && num_pts(cbl) + ba.numPts()
+              == amrex::grow(domain,2).numPts(), "complementIn");
+    }
+}
+
+void benchmark ()
+{
+    int max_n_cell = 512;
+    int block_size = 4;
+    {
+        ParmParse pp;
+        pp.query("max_n_cell", max_n_cell);
+        pp.query("block_size", block_size);
+    }
+
+    amrex::Print() << "\nSeconds for random half of the blocks of size " << block_size << "\n"
+                   << "  " << std::right << std::setw(10) << "boxes"
+                   << std::setw(12) << "simplified"
+                   << std::setw(14) << "simplify" << std::setw(16) << "removeOverlap"
+                   << std::setw(16) << "complementIn" << "\n";
+
+    for (int n_cell = 64; n_cell <= max_n_cell; n_cell *= 2)
+    {
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxList orig = random_blocks(domain, block_size, 0.5, 3);
+        Real t[3];
+
+        BoxList bl = orig;
+        t[0] = amrex::second();
+        bl.simplify();
+        t[0] = amrex::second() - t[0];
+
+        BoxList grown = orig;
+        grown.accrete(1);
+        BoxArray ba(std::move(grown));
+        t[1] = amrex::second();
+        ba.removeOverlap();
+        t[1] = amrex::second() - t[1];
+
+        BoxArray oba(orig);
+        BoxList cbl;
+        t[2] = amrex::second();
+        cbl.complementIn(domain, oba);
+        t[2] = amrex::second() - t[2];
+
+        ParallelDescriptor::ReduceRealMax(t, 3);
+        amrex::Print() << "  " << std::setw(10) << orig.size() << std::setw(12) << bl.size()
+                       << std::scientific << std::setprecision(3)
+                       << std::setw(14) << t[0] << std::setw(16) << t[1]
+                       << std::setw(16) << t[2] << std::defaultfloat << "\n";
+    }
+}
@@ -5,6 +5,9 @@
 #include <limits>
 #include <cmath>
 #include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 
 using namespace amrex;
 
@@ -15,6 +18,122 @@ struct ErrZone {
     IntVect cell;
 };
 
+// Errors of one variable accumulated over the FABs of a level
+struct VarStats {
+    Real max_diff = 0.0;   // max |b-a|
+    Real sum_diff = 0.0;   // sum |b-a|
+    Real sum_diff2 = 0.0;  // sum (b-a)^2
+    Real max_a = 0.0;
+    Real sum_a = 0.0;
+    Real sum_a2 = 0.0;
+    int nan_a = false;
+    int nan_b = false;
+    // location of max |b-a|
+    int grid = -1;
+    IntVect cell;
+
+    void merge (VarStats const& rhs) {
+        if (rhs.grid >= 0 && (grid < 0 || rhs.max_diff > max_diff)) {
+            grid = rhs.grid;
+            cell = rhs.cell;
+        }
+        max_diff = std::max(max_diff, rhs.max_diff);
+        sum_diff += rhs.sum_diff;
+        sum_diff2 += rhs.sum_diff2;
+        max_a = std::max(max_a, rhs.max_a);
+        sum_a += rhs.sum_a;
+        sum_a2 += rhs.sum_a2;
+        nan_a = nan_a || rhs.nan_a;
+        nan_b = nan_b || rhs.nan_b;
+    }
+};
+
+// Compare all the variables of fab_a and fab_b on box bx in a single pass.
+// Component comp_a[n] of fab_a is compared with component comp_b[n] of fab_b,
+// and the results are accumulated into stats[var[n]].  If diff is not null,
+// |b-a| of variable save_var is stored in it.
+void compare_fabs (FArrayBox const& fab_a, FArrayBox const& fab_b, Box const& bx, int grid,
+                   Vector<int> const& comp_a, Vector<int> const& comp_b, Vector<int> const& var,
+                   Vector<VarStats>& stats, FArrayBox* diff, int save_var)
+{
+    const auto lo = amrex::lbound(bx);
+    const auto hi = amrex::ubound(bx);
+    const int nc = comp_a.size();
+    const int nk = hi.z-lo.z+1;
+    Array4<Real const> const& a = fab_a.const_array();
+    Array4<Real const> const& b = fab_b.const_array();
+    Array4<Real> const& d = (diff) ? diff->array() : Array4<Real>{};
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<VarStats> local(nc);
+#ifdef _OPENMP
+#pragma omp for collapse(2)
+#endif
+        for (int n = 0; n < nc; ++n) {
+            for (int kk = 0; kk < nk; ++kk) {
+                const int k = lo.z + kk;
+                const int na = comp_a[n];
+                const int nb = comp_b[n];
+                const bool save = diff && var[n] == save_var;
+                VarStats& st = local[n];
+                for (int j = lo.y; j <= hi.y; ++j) {
+                for (int i = lo.x; i <= hi.x; ++i) {
+                    const Real va = a(i,j,k,na);
+                    const Real vb = b(i,j,k,nb);
+                    if (std::isnan(va) || std::isnan(vb)) {
+                        st.nan_a = st.nan_a || std::isnan(va);
+                        st.nan_b = st.nan_b || std::isnan(vb);
+                        continue;
+                    }
+                    const Real e = std::abs(vb-va);
+                    if (e > st.max_diff || st.grid < 0) {
+                        st.max_diff = e;
+                        st.grid = grid;
+                        st.cell = IntVect(AMREX_D_DECL(i,j,k));
+                    }
+                    st.sum_diff += e;
+                    st.sum_diff2 += e*e;
+                    st.max_a = std::max(st.max_a, std::abs(va));
+                    st.sum_a += std::abs(va);
+                    st.sum_a2 += va*va;
+                    if (save) d(i,j,k) = e;
+                }}
+            }
+        }
+#ifdef _OPENMP
+#pragma omp critical (fcompare_stats)
+#endif
+        for (int n = 0; n < nc; ++n) {
+            stats[var[n]].merge(local[n]);
+        }
+    }
+}
+
+// Write a number in JSON.  NaN and Inf are not valid JSON numbers.
+std::string json_number (Real x)
+{
+    if (std::isfinite(x)) {
+        std::ostringstream ss;
+        ss << std::setprecision(17) << x;
+        return ss.str();
+    } else {
+        return "null";
+    }
+}
+
+std::string json_string (std::string const& s)
+{
+    std::string r("\"");
+    for (char c : s) {
+        if (c == '"' || c == '\\') r += '\\';
+        r += c;
+    }
+    return r + "\"";
+}
+
 int main_main()
 {
     const int narg = amrex::command_argument_count();
@@ -36,6 +155,9 @@ int main_main()
     std::string zone_info_var_name;
     Vector<std::string> plot_names(1);
     bool abort_if_not_all_found = false;
+    bool fail_fast = false;
+    std::string summary_file;
+    Long mem_budget = 0;
 
     int farg = 1;
     while (farg <= narg) {
@@ -58,6 +180,12 @@ int main_main()
             rtol = std::stod(amrex::get_command_argument(++farg));
         } else if (fname == "--abort_if_not_all_found") {
             abort_if_not_all_found = true;            
+        } else if (fname == "-f" or fname == "--fail_fast") {
+            fail_fast = true;
+        } else if (fname == "-s" or fname == "--summary") {
+            summary_file = amrex::get_command_argument(++farg);
+        } else if (fname == "-m" or fname == "--mem_budget") {
+            mem_budget = std::stol(amrex::get_command_argument(++farg)) * 1024L * 1024L;
         } else {
             break;
         }
@@ -79,7 +207,7 @@ int main_main()
             << " variable.\n"
             << "\n"
             << " usage:\n"
-            << "    fcompare [-g|--ghost] [-n|--norm num] [-d|--diffvar var] [-z|--zone_info var] [-a|--allow_diff_grids] [-r|rel_tol] file1 file2\n"
+            << "    fcompare [-g|--ghost] [-n|--norm num] [-d|--diffvar var] [-z|--zone_info var] [-a|--allow_diff_grids] [-r|rel_tol] [-f|--fail_fast] [-s|--summary file] [-m|--mem_budget MB] file1 file2\n"
             << "\n"
             << " optional arguments:\n"
             << "    -g|--ghost            : compare the ghost cells too (if stored)\n"
@@ -90,6 +218,13 @@ int main_main()
             << "                            to the maximum error for the given variable\n"
             << "    -a|--allow_diff_grids : allow different BoxArrays covering the same domain\n"
             << "    -r|--rel_tol rtol     : relative tolerance (default is 0)\n"
+            << "    -f|--fail_fast        : stop at the first tolerance violation.  With a zero\n"
+            << "                            tolerance, this is the first FAB that differs or\n"
+            << "                            contains NaNs, otherwise the first level that fails\n"
+            << "    -s|--summary file     : write a JSON summary of the comparison to file\n"
+            << "    -m|--mem_budget MB    : if a pair of FABs needs more than MB megabytes,\n"
+            << "                            read them one variable at a time\n"
+            << "                            (default is 0 for no limit)\n"
             << std::endl;
         return 0;
     }
@@ -148,6 +283,16 @@ int main_main()
         }
     }
 
+    // the variables present in both files
+    Vector<int> vars;
+    Vector<int> vars_b;
+    for (int n_a = 0; n_a < ncomp_a; ++n_a) {
+        if (ivar_b[n_a] >= 0) {
+            vars.push_back(n_a);
+            vars_b.push_back(ivar_b[n_a]);
+        }
+    }
+
     for (int ilev = 0; ilev < nlevels; ++ilev) {
         const auto& dx_a = pf_a.cellSize(ilev);
         const auto& dx_b = pf_b.cellSize(ilev);
@@ -166,6 +311,7 @@ int main_main()
             mf_array[ilev].define(pf_a.boxArray(ilev),
                                   pf_a.DistributionMap(ilev),
                                   1, 0);
+            mf_array[ilev].setVal(0.0);
         }
     }
 
@@ -178,8 +324,11 @@ int main_main()
                    << "  " << std::setw(24) << "(||A - B||/||A||)" << "\n"
                    << " " << std::string(76,'-') << "\n";
 
+    std::ostringstream json_levels;
+    bool stopped_early = false;
+
     // go level-by-level and patch-by-patch and compare the data
-    for (int ilev = 0; ilev < nlevels; ++ilev)
+    for (int ilev = 0; ilev < nlevels && !stopped_early; ++ilev)
     {
         if (pf_a.boxArray(ilev).empty() && pf_b.boxArray(ilev).empty()) {
             continue;
@@ -195,83 +344,191 @@ int main_main()
             }
         }
 
-        Vector<Real> aerror(ncomp_a, 0.0);
-        Vector<Real> rerror(ncomp_a, 0.0);
-        Vector<Real> rerror_denom(ncomp_a, 0.0);
-        Vector<int> has_nan_a(ncomp_a, false);
-        Vector<int> has_nan_b(ncomp_a, false);
-        for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
-            if (ivar_b[icomp_a] >= 0) {
-                const MultiFab& mf_a = pf_a.get(ilev, names_a[icomp_a]);
-                MultiFab mf_b;
-                if (grids_match) {
-                    mf_b = pf_b.get(ilev, names_b[ivar_b[icomp_a]]);
-                } else {
-                    mf_b.define(mf_a.boxArray(), mf_a.DistributionMap(), 1, 0);
-                    MultiFab tmp = pf_b.get(ilev, names_b[ivar_b[icomp_a]]);
-                    mf_b.ParallelCopy(tmp);
-                }
-                has_nan_a[icomp_a] = mf_a.contains_nan();
-                has_nan_b[icomp_a] = mf_b.contains_nan();
-                MultiFab::Subtract(mf_b,mf_a,0,0,1,0); // b = b - a
-                Real max_err = mf_b.norm0();
-                if (norm == 1) {
-                    aerror[icomp_a] = mf_b.norm1();
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm1();
-                } else if (norm == 2) {
-                    aerror[icomp_a] = mf_b.norm2();
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm2();
-                } else {
-                    aerror[icomp_a] = max_err;
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm0();
+        Vector<VarStats> stats(ncomp_a);
+
+        // Only differences can make the comparison fail with rtol = 0.  As
+        // before, NaNs alone do not fail the relative tolerance test.
+        auto fab_failed = [&] () -> bool {
+            for (int n : vars) {
+                if (stats[n].max_diff > 0.0) return true;
+            }
+            return false;
+        };
+
+        if (grids_match)
+        {
+            // Stream the data FAB by FAB.  Only the FABs being compared are
+            // in memory, and all the variables are compared in one pass.
+            const BoxArray& ba = pf_a.boxArray(ilev);
+            const DistributionMapping& dmap = pf_a.DistributionMap(ilev);
+            Vector<int> local_grids;
+            for (int gid = 0; gid < static_cast<int>(ba.size()); ++gid) {
+                if (dmap[gid] == ParallelDescriptor::MyProc()) local_grids.push_back(gid);
+            }
+            int nlocal_max = local_grids.size();
+            ParallelDescriptor::ReduceIntMax(nlocal_max);
+
+            const Long fab_pair_bytes = 2L * ncomp_a * sizeof(Real);
+            for (int ilocal = 0; ilocal < nlocal_max; ++ilocal)
+            {
+                if (ilocal < static_cast<int>(local_grids.size()))
+                {
+                    const int gid = local_grids[ilocal];
+                    const Box& bx = ba[gid];
+                    FArrayBox* diff = (save_var_a >= 0) ? &(mf_array[ilev][gid]) : nullptr;
+                    if (mem_budget > 0 && fab_pair_bytes*amrex::grow(bx,pf_a.nGrowVect(ilev)).numPts() > mem_budget)
+                    {
+                        for (int iv = 0; iv < static_cast<int>(vars.size()); ++iv) {
+                            FArrayBox fab_a = pf_a.getFab(ilev, gid, vars[iv]);
+                            FArrayBox fab_b = pf_b.getFab(ilev, gid, vars_b[iv]);
+                            compare_fabs(fab_a, fab_b, bx, gid, {0}, {0}, {vars[iv]},
+                                         stats, diff, save_var_a);
+                        }
+                    }
+                    else
+                    {
+                        FArrayBox fab_a = pf_a.getFab(ilev, gid);
+                        FArrayBox fab_b = pf_b.getFab(ilev, gid);
+                        compare_fabs(fab_a, fab_b, bx, gid, vars, vars_b, vars,
+                                     stats, diff, save_var_a);
+                    }
                 }
 
-                if (norm == 0) {
-                    rerror[icomp_a] /= rerror_denom[icomp_a];
-                } else {
-                    const auto& dx = pf_a.cellSize(ilev);
-                    Real dv = 1.0;
-                    for (int idim = 0; idim < dm; ++idim) {
-                        dv *= dx[idim];
+                if (fail_fast && rtol == 0.0) {
+                    bool failed = fab_failed();
+                    ParallelDescriptor::ReduceBoolOr(failed);
+                    if (failed) {
+                        stopped_early = true;
+                        break;
                     }
-                    aerror[icomp_a] *= std::pow(dv,1./static_cast<Real>(norm));
-                    rerror[icomp_a] = rerror[icomp_a]/rerror_denom[icomp_a];
                 }
+            }
+        }
+        else
+        {
+            MultiFab mf_a = pf_a.get(ilev);
+            MultiFab mf_b(mf_a.boxArray(), mf_a.DistributionMap(), ncomp_a, 0);
+            {
+                MultiFab tmp = pf_b.get(ilev);
+                for (int iv = 0; iv < static_cast<int>(vars.size()); ++iv) {
+                    mf_b.ParallelCopy(tmp, vars_b[iv], vars[iv], 1);
+                }
+            }
+            for (MFIter mfi(mf_a); mfi.isValid(); ++mfi) {
+                FArrayBox* diff = (save_var_a >= 0) ? &(mf_array[ilev][mfi]) : nullptr;
+                compare_fabs(mf_a[mfi], mf_b[mfi], mfi.validbox(), mfi.index(),
+                             vars, vars, vars, stats, diff, save_var_a);
+            }
+        }
 
-                if (icomp_a == save_var_a or icomp_a == zone_info_var_a) {
-                    mf_b.abs(0,1);
+        // reduce over processes
+        {
+            Vector<Real> rmax, rsum;
+            Vector<int> imax;
+            for (int n : vars) {
+                const VarStats& st = stats[n];
+                rmax.push_back(st.max_diff);
+                rmax.push_back(st.max_a);
+                rsum.push_back(st.sum_diff);
+                rsum.push_back(st.sum_diff2);
+                rsum.push_back(st.sum_a);
+                rsum.push_back(st.sum_a2);
+                imax.push_back(st.nan_a);
+                imax.push_back(st.nan_b);
+            }
+            Vector<Real> local_max_diff(ncomp_a);
+            for (int n : vars) local_max_diff[n] = stats[n].max_diff;
+            ParallelDescriptor::ReduceRealMax(rmax.data(), rmax.size());
+            ParallelDescriptor::ReduceRealSum(rsum.data(), rsum.size());
+            ParallelDescriptor::ReduceIntMax(imax.data(), imax.size());
+            for (int iv = 0; iv < static_cast<int>(vars.size()); ++iv) {
+                VarStats& st = stats[vars[iv]];
+                st.max_diff  = rmax[2*iv];
+                st.max_a     = rmax[2*iv+1];
+                st.sum_diff  = rsum[4*iv];
+                st.sum_diff2 = rsum[4*iv+1];
+                st.sum_a     = rsum[4*iv+2];
+                st.sum_a2    = rsum[4*iv+3];
+                st.nan_a     = imax[2*iv];
+                st.nan_b     = imax[2*iv+1];
+            }
+
+            // location of the maximum error of the zone_info variable
+            if (zone_info_var_a >= 0 && ivar_b[zone_info_var_a] >= 0) {
+                VarStats& st = stats[zone_info_var_a];
+                int owner = (st.grid >= 0 && local_max_diff[zone_info_var_a] == st.max_diff)
+                    ? ParallelDescriptor::MyProc() : ParallelDescriptor::NProcs();
+                ParallelDescriptor::ReduceIntMin(owner);
+                if (owner < ParallelDescriptor::NProcs()) {
+                    ParallelDescriptor::Bcast(&st.grid, 1, owner);
+                    ParallelDescriptor::Bcast(st.cell.getVect(), AMREX_SPACEDIM, owner);
                 }
+            }
+        }
 
-                if (icomp_a == save_var_a) {
-                    MultiFab::Copy(mf_array[ilev], mf_b, 0, 0, 1, 0);
+        Vector<Real> aerror(ncomp_a, 0.0);
+        Vector<Real> rerror(ncomp_a, 0.0);
+        Vector<Real> rerror_denom(ncomp_a, 0.0);
+        Vector<int> has_nan_a(ncomp_a, false);
+        Vector<int> has_nan_b(ncomp_a, false);
+        for (int icomp_a : vars) {
+            const VarStats& st = stats[icomp_a];
+            has_nan_a[icomp_a] = st.nan_a;
+            has_nan_b[icomp_a] = st.nan_b;
+            Real max_err = st.max_diff;
+            if (norm == 1) {
+                aerror[icomp_a] = st.sum_diff;
+                rerror[icomp_a] = aerror[icomp_a];
+                rerror_denom[icomp_a] = st.sum_a;
+            } else if (norm == 2) {
+                aerror[icomp_a] = std::sqrt(st.sum_diff2);
+                rerror[icomp_a] = aerror[icomp_a];
+                rerror_denom[icomp_a] = std::sqrt(st.sum_a2);
+            } else {
+                aerror[icomp_a] = max_err;
+                rerror[icomp_a] = aerror[icomp_a];
+                rerror_denom[icomp_a] = st.max_a;
+            }
+
+            if (norm == 0) {
+                rerror[icomp_a] /= rerror_denom[icomp_a];
+            } else {
+                const auto& dx = pf_a.cellSize(ilev);
+                Real dv = 1.0;
+                for (int idim = 0; idim < dm; ++idim) {
+                    dv *= dx[idim];
                 }
+                aerror[icomp_a] *= std::pow(dv,1./static_cast<Real>(norm));
+                rerror[icomp_a] = rerror[icomp_a]/rerror_denom[icomp_a];
+            }
 
-                if (icomp_a == zone_info_var_a) {
-                    if (max_err > err_zone.max_abs_err) {
-                        err_zone.max_abs_err = max_err;
-                        err_zone.level = ilev;
-                        err_zone.cell = mf_b.maxIndex(0);
-                        auto isects = pf_a.boxArray(ilev).intersections
-                            (Box(err_zone.cell,err_zone.cell), true, 0);
-                        err_zone.grid_index = isects[0].first;
-                    }
+            if (icomp_a == zone_info_var_a) {
+                if (max_err > err_zone.max_abs_err) {
+                    err_zone.max_abs_err = max_err;
+                    err_zone.level = ilev;
+                    err_zone.cell = st.cell;
+                    err_zone.grid_index = st.grid;
                 }
             }
         }
 
         amrex::Print() << " level = " << ilev << "\n";
+        json_levels << ((ilev > 0) ? ",\n" : "\n")
+                    << "    {\"level\": " << ilev << ", \"complete\": "
+                    << (stopped_early ? "false" : "true") << ", \"variables\": [";
         for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
+            json_levels << ((icomp_a > 0) ? "," : "") << "\n      {\"name\": "
+                        << json_string(names_a[icomp_a]);
             if (ivar_b[icomp_a] < 0) {
                 amrex::Print() << " " << std::setw(24) << std::left << names_a[icomp_a]
                                << "  " << std::setw(50)
                                << "< variable not present in both files > \n";
+                json_levels << ", \"present\": false}";
             } else if (has_nan_a[icomp_a] or has_nan_b[icomp_a]) {
                 amrex::Print() << " " << std::setw(24) << std::left << names_a[icomp_a]
                                << "  " << std::setw(50)
                                << "< NaN present > \n";
+                json_levels << ", \"present\": true, \"nan\": true}";
             } else {
                 Real aerr = 0., rerr = 0.;
                 if (aerror[icomp_a] > 0.) {
@@ -285,8 +542,12 @@ int main_main()
                                << "  " << std::setw(24) << std::setprecision(10) << aerr
                                << "  " << std::setw(24) << std::setprecision(10) << rerr
                                << "\n";
+                json_levels << ", \"present\": true, \"nan\": false"
+                            << ", \"abs_error\": " << json_number(aerror[icomp_a])
+                            << ", \"rel_error\": " << json_number(rerror[icomp_a]) << "}";
             }
         }
+        json_levels << "\n    ]}";
 
         global_error = std::max(global_error,
                                 *(std::max_element(aerror.begin(),
@@ -297,6 +558,14 @@ int main_main()
         for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
             any_nans = any_nans or has_nan_a[icomp_a] or has_nan_b[icomp_a];
         }
+
+        if (fail_fast && ilev < finest_level && global_rerror > rtol) {
+            stopped_early = true;
+        }
+    }
+
+    if (stopped_early) {
+        amrex::Print() << " fail_fast: stopped at the first tolerance violation\n";
     }
 
     if (save_var_a >= 0) {
@@ -326,12 +595,10 @@ int main_main()
                 amrex::AllPrint() << std::endl
                                   << " maximum error in " << zone_info_var_name << "\n"
                                   << "   level = " << err_zone.level << " (i,j,k) = " << err_zone.cell << "\n";
-            }
 
-            for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
-                const MultiFab& mf = pf_a.get(err_zone.level,names_a[icomp_a]);
-                if (owner_proc) {
-                    Real v = mf[err_zone.grid_index](err_zone.cell);
+                FArrayBox fab = pf_a.getFab(err_zone.level, err_zone.grid_index);
+                for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
+                    Real v = fab(err_zone.cell, icomp_a);
                     amrex::AllPrint() << " " << std::setw(24)
                                       << names_a[icomp_a] << "  "
                                       << std::setw(24) << std::right
@@ -341,20 +608,44 @@ int main_main()
         }
     }
 
+    int r;
     if (! all_variables_found) {
         amrex::Print() << " WARNING: not all variables present in both files\n";
-        if (abort_if_not_all_found) return EXIT_FAILURE;
     }
 
-    if (global_error == 0.0 and !any_nans) {
+    if (! all_variables_found && abort_if_not_all_found) {
+        r = EXIT_FAILURE;
+    } else if (global_error == 0.0 and !any_nans and !stopped_early) {
         amrex::Print() << " PLOTFILE AGREE" << std::endl;
-        return EXIT_SUCCESS;
-    } else if (global_rerror <= rtol) {
+        r = EXIT_SUCCESS;
+    } else if (global_rerror <= rtol and !stopped_early) {
         amrex::Print() << " PLOTFILE AGREE to relative tolerance " << rtol << std::endl;
-        return EXIT_SUCCESS;
+        r = EXIT_SUCCESS;
     } else {
-        return EXIT_FAILURE;
+        r = EXIT_FAILURE;
     }
+
+    if (!summary_file.empty() && ParallelDescriptor::IOProcessor()) {
+        std::ofstream ofs(summary_file);
+        if (!ofs.good()) {
+            amrex::FileOpenFailed(summary_file);
+        }
+        ofs << "{\n"
+            << "  \"file1\": " << json_string(plotfile_a) << ",\n"
+            << "  \"file2\": " << json_string(plotfile_b) << ",\n"
+            << "  \"norm\": " << norm << ",\n"
+            << "  \"rel_tol\": " << json_number(rtol) << ",\n"
+            << "  \"agree\": " << ((r == EXIT_SUCCESS) ? "true" : "false") << ",\n"
+            << "  \"stopped_early\": " << (stopped_early ? "true" : "false") << ",\n"
+            << "  \"all_variables_found\": " << (all_variables_found ? "true" : "false") << ",\n"
+            << "  \"nan\": " << (any_nans ? "true" : "false") << ",\n"
+            << "  \"max_abs_error\": " << json_number(global_error) << ",\n"
+            << "  \"max_rel_error\": " << json_number(global_rerror) << ",\n"
+            << "  \"levels\": [" << json_levels.str() << "\n  ]\n"
+            << "}\n";
+    }
+
+    return r;
 }
 
 int main (int argc, char* argv[])
@@ -195,7 +195,7 @@ AmrLevelAdv::init (AmrLevel &old)
 
     MultiFab& S_new = get_new_data(Phi_Type);
 
-    FillPatch(old, S_new, 0, cur_time, Phi_Type, 0, NUM_STATE);
+    FillPatchRegrid(old, S_new, cur_time, Phi_Type, 0, NUM_STATE);
 }
 
 //
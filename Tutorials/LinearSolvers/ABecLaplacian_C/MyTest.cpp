@@ -76,6 +76,9 @@ MyTest::solvePoisson ()
             mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
         }
 #endif
+        if (use_direct) {
+            mlmg.setBottomSolver(MLMG::BottomSolver::direct);
+        }
 
         mlmg.solve(GetVecOfPtrs(solution), GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
     }
@@ -117,6 +120,9 @@ MyTest::solvePoisson ()
                 mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
             }
 #endif
+            if (use_direct) {
+                mlmg.setBottomSolver(MLMG::BottomSolver::direct);
+            }
             
             mlmg.solve({&solution[ilev]}, {&rhs[ilev]}, tol_rel, tol_abs);            
         }
@@ -193,6 +199,9 @@ MyTest::solveABecLaplacian ()
             mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
         }
 #endif
+        if (use_direct) {
+            mlmg.setBottomSolver(MLMG::BottomSolver::direct);
+        }
 
         mlmg.solve(GetVecOfPtrs(solution), GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
     }
@@ -250,6 +259,9 @@ MyTest::solveABecLaplacian ()
                 mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
             }
 #endif
+            if (use_direct) {
+                mlmg.setBottomSolver(MLMG::BottomSolver::direct);
+            }
 
             mlmg.solve({&solution[ilev]}, {&rhs[ilev]}, tol_rel, tol_abs);            
         }
@@ -335,6 +347,9 @@ MyTest::solveABecLaplacianInhomNeumann ()
             mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
         }
 #endif
+        if (use_direct) {
+            mlmg.setBottomSolver(MLMG::BottomSolver::direct);
+        }
 
         mlmg.solve(GetVecOfPtrs(solution), GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
     }
@@ -392,6 +407,9 @@ MyTest::solveABecLaplacianInhomNeumann ()
                 mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
             }
 #endif
+            if (use_direct) {
+                mlmg.setBottomSolver(MLMG::BottomSolver::direct);
+            }
 
             mlmg.solve({&solution[ilev]}, {&rhs[ilev]}, tol_rel, tol_abs);            
         }
@@ -447,6 +465,7 @@ MyTest::readParameters ()
 #ifdef AMREX_USE_PETSC
     pp.query("use_petsc", use_petsc);
 #endif
+    pp.query("use_direct", use_direct);
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!(use_hypre && use_petsc),
                                      "use_hypre & use_petsc cannot be both true");
 }